@@ -9,7 +9,21 @@
         "src/ai_algorithms_part2.cpp",
         "src/ai_algorithms_part3.cpp",
         "src/ai_algorithms_base.cpp",
-        "src/ai_algorithms_hamms.cpp"
+        "src/ai_algorithms_hamms.cpp",
+        "src/ai_algorithms_context.cpp",
+        "src/ai_algorithms_fft.cpp",
+        "src/ai_algorithms_simd.cpp",
+        "src/ai_algorithms_loudness.cpp",
+        "src/ai_algorithms_pitch.cpp",
+        "src/ai_algorithms_beats.cpp",
+        "src/ai_algorithms_descriptors.cpp",
+        "src/ai_algorithms_scheduler.cpp",
+        "src/ai_algorithms_decoder.cpp",
+        "src/ai_algorithms_streaming.cpp",
+        "src/ai_algorithms_similarity.cpp",
+        "src/ai_algorithms_storage.cpp",
+        "src/ai_algorithms_clustering.cpp",
+        "src/ai_algorithms_mixing.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -24,6 +38,7 @@
         "-ltag",
         "-lfftw3",
         "-lfftw3f",
+        "-lsndfile",
         "-L/usr/local/lib",
         "-L/opt/homebrew/lib",
         "-L/opt/homebrew/Cellar/taglib/2.1.1/lib"
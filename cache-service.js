@@ -3,7 +3,7 @@ const fs = require('fs');
 const path = require('path');
 
 class CacheService {
-    constructor() {
+    constructor(nativeAddon = null) {
         this.memoryCache = new Map(); // Cache en memoria para acceso ultra-rápido
         this.folderCache = new Map(); // Cache de carpetas
         this.searchCache = new Map(); // Cache de búsquedas
@@ -11,6 +11,12 @@ class CacheService {
         this.maxSearchCache = 100; // Máximo 100 búsquedas en cache
         this.cacheHits = 0;
         this.cacheMisses = 0;
+        
+        // Índice HAMMS nativo: cubre toda la biblioteca vista, no solo el LRU
+        this.similarityIndex = nativeAddon && nativeAddon.findSimilar ? nativeAddon : null;
+        // Índice de mezcla armónica (Camelot + BPM + energía)
+        this.mixingIndex = nativeAddon && nativeAddon.findCompatible ? nativeAddon : null;
+        this.indexedPaths = new Map(); // trackId → file_path
     }
 
     /**
@@ -48,6 +54,7 @@ class CacheService {
         };
         
         this.memoryCache.set(key, cacheEntry);
+        this.indexSimilarity(fileData);
         console.log(`📦 Cache: Archivo agregado ${path.basename(filePath)} (${this.memoryCache.size}/${this.maxMemoryItems})`);
     }
 
@@ -190,6 +197,7 @@ class CacheService {
     invalidateFile(filePath) {
         const key = this.generateFileKey(filePath);
         const removed = this.memoryCache.delete(key);
+        this.unindexPaths(indexedPath => indexedPath === filePath);
         
         if (removed) {
             console.log(`🗑️ Cache: Archivo invalidado ${path.basename(filePath)}`);
@@ -211,6 +219,7 @@ class CacheService {
                 this.memoryCache.delete(key);
             }
         }
+        this.unindexPaths(indexedPath => path.dirname(indexedPath) === folderPath);
         
         console.log(`🗑️ Cache: Carpeta invalidada ${path.basename(folderPath)}`);
     }
@@ -349,6 +358,7 @@ class CacheService {
         this.memoryCache.clear();
         this.folderCache.clear();
         this.searchCache.clear();
+        this.unindexPaths(() => true);
         
         // Resetear estadísticas
         this.cacheHits = 0;
@@ -359,12 +369,91 @@ class CacheService {
     }
 
     /**
-     * 💡 Sugerir archivos relacionados basado en cache
+     * 🎯 Registrar vector HAMMS en el índice nativo de similitud
+     */
+    indexSimilarity(file) {
+        if (!file.id) return;
+        const bpm = file.AI_BPM || file.bpm_llm;
+        
+        if (this.mixingIndex && file.AI_KEY &&
+            this.mixingIndex.indexMixingTrack(file.id, { key: file.AI_KEY, bpm, energy: file.AI_ENERGY })) {
+            this.indexedPaths.set(file.id, file.file_path);
+        }
+        
+        if (!this.similarityIndex || !file.hamms_vector) return;
+        
+        // false: hamms_vector sin ninguna de las siete claves HAMMS, no se indexa
+        if (this.similarityIndex.indexTrack(file.id, file.hamms_vector, { bpm, energy: file.AI_ENERGY })) {
+            this.indexedPaths.set(file.id, file.file_path);
+        }
+    }
+
+    /**
+     * 🧽 Quitar de los índices nativos (HAMMS y mezcla) las pistas cuya ruta cumpla la condición
+     */
+    unindexPaths(matches) {
+        const index = this.similarityIndex || this.mixingIndex;
+        for (const [trackId, filePath] of this.indexedPaths) {
+            if (!matches(filePath)) continue;
+            if (index) index.removeTrack(trackId); // removeTrack borra de ambos índices
+            this.indexedPaths.delete(trackId);
+        }
+    }
+
+    /**
+     * 📥 Archivos de los resultados de un índice nativo, en el mismo orden
+     */
+    async resolveMatches(matches, database) {
+        // Los que el LRU ya descartó se recuperan de la base de datos
+        const missing = matches
+            .filter(match => !this.memoryCache.has(this.generateFileKey(this.indexedPaths.get(match.trackId))))
+            .map(match => match.trackId);
+        if (missing.length > 0 && database) {
+            const files = await database.getFilesByIds(missing);
+            files.forEach(file => this.setFile(file.file_path, file));
+        }
+        
+        return matches
+            .map(match => {
+                const file = this.getFile(this.indexedPaths.get(match.trackId));
+                return file ? { file, match } : null;
+            })
+            .filter(Boolean);
+    }
+
+    /**
+     * 🎚️ Siguientes pistas compatibles para mezclar: Camelot igual o adyacente,
+     * BPM dentro de ±bpmTolerance (también mitad/doble) y energía parecida.
+     * options: { bpmTolerance, tempoMultiples, maxEnergyDifference }
      */
-    getSimilarFiles(filePath, limit = 10) {
+    async getCompatibleFiles(filePath, limit = 10, options = {}, database = null) {
+        const sourceFile = this.getFile(filePath);
+        if (!sourceFile || !this.mixingIndex) return [];
+        
+        const matches = this.mixingIndex.findCompatible(sourceFile.id, limit, options);
+        const resolved = await this.resolveMatches(matches, database);
+        return resolved.map(({ file, match }) => ({
+            ...file,
+            camelot: match.camelot,
+            tempoRatio: match.tempoRatio
+        }));
+    }
+
+    /**
+     * 💡 Sugerir archivos relacionados: k vecinos HAMMS en el índice nativo,
+     * o puntuación por artista/género/BPM sobre el cache si no hay índice.
+     * filters: { minBPM, maxBPM, minEnergy, maxEnergy, minSimilarity }
+     */
+    async getSimilarFiles(filePath, limit = 10, filters = {}, database = null) {
         const sourceFile = this.getFile(filePath);
         if (!sourceFile) return [];
         
+        if (this.similarityIndex && sourceFile.hamms_vector && this.indexedPaths.has(sourceFile.id)) {
+            const matches = this.similarityIndex.findSimilar(sourceFile.id, limit, filters);
+            const resolved = await this.resolveMatches(matches, database);
+            return resolved.map(({ file, match }) => ({ ...file, similarity: match.similarity }));
+        }
+        
         const similar = [];
         
         // Buscar archivos similares en cache
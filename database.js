@@ -176,7 +176,9 @@ class MusicDatabase {
                 mastering_loudness REAL,
                 dynamic_range REAL,
                 
-                -- HAMMS vector (JSON)
+                -- HAMMS vector (JSON): { harmonicity, melodicity, rhythmicity, timbrality,
+                -- dynamics, tonality, temporality }, numbers in 0-1; the native similarity
+                -- index skips vectors with none of these keys
                 hamms_vector TEXT, -- JSON string
                 
                 -- Custom tags (JSON array)
@@ -568,6 +570,55 @@ class MusicDatabase {
         }
     }
 
+    /**
+     * 🆔 Obtener archivos por id (resultados del índice de similitud)
+     */
+    async getFilesByIds(ids) {
+        if (ids.length === 0) return [];
+        
+        const sql = `
+            SELECT 
+                af.*,
+                -- AI_* campos principales
+                lm.AI_ACOUSTICNESS, lm.AI_ANALYZED, lm.AI_BPM, lm.AI_CHARACTERISTICS, lm.AI_CONFIDENCE,
+                lm.AI_CULTURAL_CONTEXT, lm.AI_DANCEABILITY, lm.AI_ENERGY, lm.AI_ERA, lm.AI_INSTRUMENTALNESS,
+                lm.AI_KEY, lm.AI_LIVENESS, lm.AI_LOUDNESS, lm.AI_MODE, lm.AI_MOOD, lm.AI_OCCASION,
+                lm.AI_SPEECHINESS, lm.AI_SUBGENRES, lm.AI_TIME_SIGNATURE, lm.AI_VALENCE,
+                -- Campos legacy para compatibilidad
+                lm.bpm_llm, lm.energy, lm.mood, lm.danceability, lm.valence,
+                lm.analyzed_by, lm.subgenre, lm.era,
+                lm.vocal_presence, lm.structure, lm.drop_time, lm.energy_curve,
+                lm.crowd_response, lm.occasion, lm.characteristics,
+                lm.tempo_stability, lm.production_quality, lm.mastering_loudness,
+                lm.dynamic_range, lm.hamms_vector, lm.custom_tags,
+                lm.analysis_date, lm.llm_version
+            FROM audio_files af
+            LEFT JOIN llm_metadata lm ON af.id = lm.file_id
+            WHERE af.id IN (${ids.map(() => '?').join(',')})
+            GROUP BY af.id
+        `;
+
+        try {
+            const rows = await this.allQuery(sql, ids);
+            
+            // Procesar datos JSON
+            return rows.map(row => ({
+                ...row,
+                mixed_in_key_detected: Boolean(row.mixed_in_key_detected),
+                should_preserve: Boolean(row.should_preserve),
+                hamms_vector: row.hamms_vector ? JSON.parse(row.hamms_vector) : null,
+                custom_tags: row.custom_tags ? JSON.parse(row.custom_tags) : [],
+                // Procesar campos AI_* que son arrays JSON
+                AI_CHARACTERISTICS: row.AI_CHARACTERISTICS ? JSON.parse(row.AI_CHARACTERISTICS) : null,
+                AI_OCCASION: row.AI_OCCASION ? JSON.parse(row.AI_OCCASION) : null,
+                AI_SUBGENRES: row.AI_SUBGENRES ? JSON.parse(row.AI_SUBGENRES) : null
+            }));
+        } catch (error) {
+            console.error('Error obteniendo archivos por id:', error);
+            throw error;
+        }
+    }
+
     /**
      * 🔍 Buscar archivos por múltiples criterios
      */
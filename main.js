@@ -36,7 +36,7 @@ async function initializeSystems() {
         console.log('✅ Base de datos inicializada');
         
         // Initialize cache service
-        cache = new CacheService();
+        cache = new CacheService(metadataAddon);
         console.log('✅ Sistema de cache inicializado');
         
         // Initialize metadata writer with C++ addon
@@ -596,9 +596,9 @@ ipcMain.handle('optimize-system', async () => {
 });
 
 // 📄 IPC Handler: Obtener archivos similares
-ipcMain.handle('get-similar-files', async (event, filePath, limit = 10) => {
+ipcMain.handle('get-similar-files', async (event, filePath, limit = 10, filters = {}) => {
     try {
-        const similar = cache.getSimilarFiles(filePath, limit);
+        const similar = await cache.getSimilarFiles(filePath, limit, filters, database);
         return similar.map(file => formatFileForUI(file));
     } catch (error) {
         console.error('Error getting similar files:', error);
@@ -606,6 +606,21 @@ ipcMain.handle('get-similar-files', async (event, filePath, limit = 10) => {
     }
 });
 
+// 🎚️ IPC Handler: Siguientes pistas compatibles para mezcla armónica
+ipcMain.handle('get-compatible-files', async (event, filePath, limit = 10, options = {}) => {
+    try {
+        const compatible = await cache.getCompatibleFiles(filePath, limit, options, database);
+        return compatible.map(file => ({
+            ...formatFileForUI(file),
+            camelot: file.camelot,
+            tempoRatio: file.tempoRatio
+        }));
+    } catch (error) {
+        console.error('Error getting compatible files:', error);
+        return [];
+    }
+});
+
 // 📦 IPC Handler: Cargar más archivos con paginación
 ipcMain.handle('load-more-files', async (event, folderPath, offset = 0, limit = 1000) => {
     try {
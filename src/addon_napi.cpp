@@ -4,6 +4,7 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <thread>
 
 using namespace MusicAnalysis;
 
@@ -14,18 +15,106 @@ using namespace MusicAnalysis;
 
 
 
+// Convert C++ AIAnalysisResult to a JavaScript object (computed fields only)
+static Napi::Object ResultToObject(Napi::Env env, const AIAnalysisResult& result) {
+    Napi::Object jsResult = Napi::Object::New(env);
+    FieldMask fields = result.analyzedFields;  // Fields that were not requested are left out
+    
+    if (fields & FIELD_ACOUSTICNESS) jsResult.Set("AI_ACOUSTICNESS", Napi::Number::New(env, result.AI_ACOUSTICNESS));
+    jsResult.Set("AI_ANALYZED", Napi::Boolean::New(env, result.AI_ANALYZED));
+    if (fields & FIELD_BPM) jsResult.Set("AI_BPM", Napi::Number::New(env, result.AI_BPM));
+    if (fields & FIELD_CONFIDENCE) jsResult.Set("AI_CONFIDENCE", Napi::Number::New(env, result.AI_CONFIDENCE));
+    if (fields & FIELD_CULTURAL_CONTEXT) jsResult.Set("AI_CULTURAL_CONTEXT", Napi::String::New(env, result.AI_CULTURAL_CONTEXT));
+    if (fields & FIELD_DANCEABILITY) jsResult.Set("AI_DANCEABILITY", Napi::Number::New(env, result.AI_DANCEABILITY));
+    if (fields & FIELD_ENERGY) jsResult.Set("AI_ENERGY", Napi::Number::New(env, result.AI_ENERGY));
+    if (fields & FIELD_ERA) jsResult.Set("AI_ERA", Napi::String::New(env, result.AI_ERA));
+    if (fields & FIELD_INSTRUMENTALNESS) jsResult.Set("AI_INSTRUMENTALNESS", Napi::Number::New(env, result.AI_INSTRUMENTALNESS));
+    if (fields & FIELD_KEY) {
+        jsResult.Set("AI_KEY", Napi::String::New(env, result.AI_KEY));
+        
+        Napi::Array timeline = Napi::Array::New(env);
+        for (size_t i = 0; i < result.KEY_TIMELINE.size(); i++) {
+            const KeySegment& segment = result.KEY_TIMELINE[i];
+            Napi::Object jsSegment = Napi::Object::New(env);
+            jsSegment.Set("start", Napi::Number::New(env, segment.startTime));
+            jsSegment.Set("end", Napi::Number::New(env, segment.endTime));
+            jsSegment.Set("key", Napi::String::New(env, segment.key));
+            jsSegment.Set("confidence", Napi::Number::New(env, segment.confidence));
+            timeline[i] = jsSegment;
+        }
+        jsResult.Set("KEY_TIMELINE", timeline);
+    }
+    if (fields & FIELD_LIVENESS) jsResult.Set("AI_LIVENESS", Napi::Number::New(env, result.AI_LIVENESS));
+    if (fields & FIELD_LOUDNESS) {
+        jsResult.Set("AI_LOUDNESS", Napi::Number::New(env, result.AI_LOUDNESS));
+        jsResult.Set("LOUDNESS_RANGE", Napi::Number::New(env, result.LOUDNESS_RANGE));
+        jsResult.Set("TRUE_PEAK", Napi::Number::New(env, result.TRUE_PEAK));
+        
+        const LoudnessTimeline& loudness = result.LOUDNESS_TIMELINE;
+        Napi::Array momentary = Napi::Array::New(env, loudness.momentary.size());
+        for (size_t i = 0; i < loudness.momentary.size(); i++) {
+            momentary[i] = Napi::Number::New(env, loudness.momentary[i]);
+        }
+        Napi::Array shortTerm = Napi::Array::New(env, loudness.shortTerm.size());
+        for (size_t i = 0; i < loudness.shortTerm.size(); i++) {
+            shortTerm[i] = Napi::Number::New(env, loudness.shortTerm[i]);
+        }
+        Napi::Object timeline = Napi::Object::New(env);
+        timeline.Set("interval", Napi::Number::New(env, LoudnessTimeline::INTERVAL));
+        timeline.Set("momentary", momentary);
+        timeline.Set("shortTerm", shortTerm);
+        jsResult.Set("LOUDNESS_TIMELINE", timeline);
+    }
+    if (fields & FIELD_MODE) jsResult.Set("AI_MODE", Napi::String::New(env, result.AI_MODE));
+    if (fields & FIELD_MOOD) jsResult.Set("AI_MOOD", Napi::String::New(env, result.AI_MOOD));
+    if (fields & FIELD_SPEECHINESS) jsResult.Set("AI_SPEECHINESS", Napi::Number::New(env, result.AI_SPEECHINESS));
+    if (fields & FIELD_TIME_SIGNATURE) jsResult.Set("AI_TIME_SIGNATURE", Napi::Number::New(env, result.AI_TIME_SIGNATURE));
+    if (fields & FIELD_VALENCE) jsResult.Set("AI_VALENCE", Napi::Number::New(env, result.AI_VALENCE));
+    
+    // Convert arrays
+    if (fields & FIELD_CHARACTERISTICS) {
+        Napi::Array characteristics = Napi::Array::New(env);
+        for (size_t i = 0; i < result.AI_CHARACTERISTICS.size(); i++) {
+            characteristics[i] = Napi::String::New(env, result.AI_CHARACTERISTICS[i]);
+        }
+        jsResult.Set("AI_CHARACTERISTICS", characteristics);
+    }
+    
+    if (fields & FIELD_OCCASION) {
+        Napi::Array occasion = Napi::Array::New(env);
+        for (size_t i = 0; i < result.AI_OCCASION.size(); i++) {
+            occasion[i] = Napi::String::New(env, result.AI_OCCASION[i]);
+        }
+        jsResult.Set("AI_OCCASION", occasion);
+    }
+    
+    if (fields & FIELD_SUBGENRES) {
+        Napi::Array subgenres = Napi::Array::New(env);
+        for (size_t i = 0; i < result.AI_SUBGENRES.size(); i++) {
+            subgenres[i] = Napi::String::New(env, result.AI_SUBGENRES[i]);
+        }
+        jsResult.Set("AI_SUBGENRES", subgenres);
+    }
+    
+    return jsResult;
+}
+
 // AsyncWorker for audio analysis
 class AudioAnalysisWorker : public Napi::AsyncWorker {
 public:
     AudioAnalysisWorker(Napi::Function& callback, const std::string& filePath, const std::vector<std::string>& algorithms)
-        : Napi::AsyncWorker(callback), filePath(filePath), algorithms(algorithms) {}
+        : Napi::AsyncWorker(callback), filePath(filePath), fields(FieldSelection::parse(algorithms)) {}
     
     void Execute() override {
         try {
-            // REMOVED: Test audio buffer generation
-            // Real audio loading must be implemented
-            throw std::runtime_error("Real audio file loading not implemented. Cannot use test data.");
+            // Decoded chunk by chunk; memory stays bounded for long mixes
+            StreamingOptions streaming;
+            streaming.fields = fields;
+            result = StreamingAnalyzer::analyzeFile(filePath, streaming);
             
+            if (!result.AI_ANALYZED) {
+                SetError("AI analysis failed for " + filePath);
+            }
         } catch (const std::exception& e) {
             SetError(e.what());
         }
@@ -33,53 +122,12 @@ public:
     
     void OnOK() override {
         Napi::HandleScope scope(Env());
-        
-        Napi::Object jsResult = Napi::Object::New(Env());
-        
-        // Convert C++ AIAnalysisResult to JavaScript object
-        jsResult.Set("AI_ACOUSTICNESS", Napi::Number::New(Env(), result.AI_ACOUSTICNESS));
-        jsResult.Set("AI_ANALYZED", Napi::Boolean::New(Env(), result.AI_ANALYZED));
-        jsResult.Set("AI_BPM", Napi::Number::New(Env(), result.AI_BPM));
-        jsResult.Set("AI_CONFIDENCE", Napi::Number::New(Env(), result.AI_CONFIDENCE));
-        jsResult.Set("AI_CULTURAL_CONTEXT", Napi::String::New(Env(), result.AI_CULTURAL_CONTEXT));
-        jsResult.Set("AI_DANCEABILITY", Napi::Number::New(Env(), result.AI_DANCEABILITY));
-        jsResult.Set("AI_ENERGY", Napi::Number::New(Env(), result.AI_ENERGY));
-        jsResult.Set("AI_ERA", Napi::String::New(Env(), result.AI_ERA));
-        jsResult.Set("AI_INSTRUMENTALNESS", Napi::Number::New(Env(), result.AI_INSTRUMENTALNESS));
-        jsResult.Set("AI_KEY", Napi::String::New(Env(), result.AI_KEY));
-        jsResult.Set("AI_LIVENESS", Napi::Number::New(Env(), result.AI_LIVENESS));
-        jsResult.Set("AI_LOUDNESS", Napi::Number::New(Env(), result.AI_LOUDNESS));
-        jsResult.Set("AI_MODE", Napi::String::New(Env(), result.AI_MODE));
-        jsResult.Set("AI_MOOD", Napi::String::New(Env(), result.AI_MOOD));
-        jsResult.Set("AI_SPEECHINESS", Napi::Number::New(Env(), result.AI_SPEECHINESS));
-        jsResult.Set("AI_TIME_SIGNATURE", Napi::Number::New(Env(), result.AI_TIME_SIGNATURE));
-        jsResult.Set("AI_VALENCE", Napi::Number::New(Env(), result.AI_VALENCE));
-        
-        // Convert arrays
-        Napi::Array characteristics = Napi::Array::New(Env());
-        for (size_t i = 0; i < result.AI_CHARACTERISTICS.size(); i++) {
-            characteristics[i] = Napi::String::New(Env(), result.AI_CHARACTERISTICS[i]);
-        }
-        jsResult.Set("AI_CHARACTERISTICS", characteristics);
-        
-        Napi::Array occasion = Napi::Array::New(Env());
-        for (size_t i = 0; i < result.AI_OCCASION.size(); i++) {
-            occasion[i] = Napi::String::New(Env(), result.AI_OCCASION[i]);
-        }
-        jsResult.Set("AI_OCCASION", occasion);
-        
-        Napi::Array subgenres = Napi::Array::New(Env());
-        for (size_t i = 0; i < result.AI_SUBGENRES.size(); i++) {
-            subgenres[i] = Napi::String::New(Env(), result.AI_SUBGENRES[i]);
-        }
-        jsResult.Set("AI_SUBGENRES", subgenres);
-        
-        Callback().Call({Env().Null(), jsResult});
+        Callback().Call({Env().Null(), ResultToObject(Env(), result)});
     }
     
 private:
     std::string filePath;
-    std::vector<std::string> algorithms;
+    FieldMask fields;  // Requested AI_* fields; an empty algorithms list selects all
     AIAnalysisResult result;
 };
 
@@ -115,10 +163,512 @@ Napi::Value AnalyzeAudio(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
+// AsyncWorker analyzing PCM already decoded on the JS side
+class SampleAnalysisWorker : public Napi::AsyncWorker {
+public:
+    SampleAnalysisWorker(Napi::Function& callback, Napi::Float32Array samples, int sampleRate, FieldMask fields)
+        : Napi::AsyncWorker(callback),
+          samplesRef(Napi::Persistent(samples)),
+          audio(samples.Data(), samples.ElementLength(), sampleRate, 1),
+          fields(fields) {}
+    
+    void Execute() override {
+        try {
+            AIMetadataAnalyzer analyzer;
+            result = analyzer.analyzeAudio(audio, fields);
+            
+            if (!result.AI_ANALYZED) {
+                SetError("AI analysis failed for sample buffer");
+            }
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+    
+    void OnOK() override {
+        Napi::HandleScope scope(Env());
+        Callback().Call({Env().Null(), ResultToObject(Env(), result)});
+    }
+    
+private:
+    Napi::Reference<Napi::Float32Array> samplesRef;  // Keeps the backing store alive until the worker is destroyed
+    AudioBuffer audio;                               // Views the typed array in place, no copy
+    FieldMask fields;
+    AIAnalysisResult result;
+};
+
+// Analyze mono PCM without copying it:
+// analyzeSamples(samples: Float32Array, sampleRate, { algorithms }, callback(err, result))
+// The typed array must not be transferred or detached until the callback runs.
+Napi::Value AnalyzeSamples(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 4) {
+        Napi::TypeError::New(env, "Expected 4 arguments: samples, sampleRate, options, callback")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!info[0].IsTypedArray() || info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float32_array ||
+        !info[1].IsNumber() || !info[2].IsObject() || !info[3].IsFunction()) {
+        Napi::TypeError::New(env, "Arguments must be: Float32Array, number, object, function")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    int sampleRate = info[1].As<Napi::Number>().Int32Value();
+    Napi::Object options = info[2].As<Napi::Object>();
+    Napi::Function callback = info[3].As<Napi::Function>();
+    
+    if (sampleRate <= 0 || samples.ElementLength() == 0) {
+        Napi::RangeError::New(env, "Expected a non-empty Float32Array and a positive sampleRate")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<std::string> algorithms;
+    if (options.Has("algorithms") && options.Get("algorithms").IsArray()) {
+        Napi::Array algorithmsArray = options.Get("algorithms").As<Napi::Array>();
+        for (uint32_t i = 0; i < algorithmsArray.Length(); i++) {
+            algorithms.push_back(algorithmsArray.Get(i).As<Napi::String>().Utf8Value());
+        }
+    }
+    
+    SampleAnalysisWorker* worker = new SampleAnalysisWorker(callback, samples, sampleRate,
+                                                            FieldSelection::parse(algorithms));
+    worker->Queue();
+    
+    return env.Undefined();
+}
+
+// Batch analysis state shared between the JS thread and the batch thread
+struct BatchJob {
+    std::vector<std::string> filePaths;
+    BatchOptions options;
+    std::thread thread;
+    Napi::FunctionReference onDone;
+    size_t succeeded = 0;
+};
+
+// Analyze many files in parallel, streaming each result as it finishes:
+// analyzeBatch(filePaths, { threads, algorithms }, onResult(err, item), [onDone(err, summary)])
+Napi::Value AnalyzeBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "Expected at least 3 arguments: filePaths, options, onResult")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!info[0].IsArray() || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "Arguments must be: array, object, function")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::vector<std::string> filePaths;
+    Napi::Array pathsArray = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < pathsArray.Length(); i++) {
+        Napi::Value path = pathsArray.Get(i);
+        if (!path.IsString()) {
+            Napi::TypeError::New(env, "filePaths must contain only strings").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        filePaths.push_back(path.As<Napi::String>().Utf8Value());
+    }
+    
+    BatchOptions batchOptions;
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("threads") && options.Get("threads").IsNumber()) {
+        batchOptions.threadCount = options.Get("threads").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("algorithms") && options.Get("algorithms").IsArray()) {
+        Napi::Array algorithmsArray = options.Get("algorithms").As<Napi::Array>();
+        std::vector<std::string> algorithms;
+        for (uint32_t i = 0; i < algorithmsArray.Length(); i++) {
+            Napi::Value algorithm = algorithmsArray.Get(i);
+            if (!algorithm.IsString()) {
+                Napi::TypeError::New(env, "options.algorithms must contain only strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            algorithms.push_back(algorithm.As<Napi::String>().Utf8Value());
+        }
+        batchOptions.fields = FieldSelection::parse(algorithms);
+    }
+    
+    // Arguments are valid: from here on the finalizer owns the job
+    auto* job = new BatchJob();
+    job->filePaths = std::move(filePaths);
+    job->options = batchOptions;
+    if (info.Length() > 3 && info[3].IsFunction()) {
+        job->onDone = Napi::Persistent(info[3].As<Napi::Function>());
+    }
+    
+    // The finalizer runs on the JS thread once the batch thread released the function
+    Napi::ThreadSafeFunction onResult = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "analyzeBatch", 0, 1, job,
+        [](Napi::Env env, BatchJob* job) {
+            job->thread.join();
+            
+            if (!job->onDone.IsEmpty()) {
+                Napi::HandleScope scope(env);
+                Napi::Object summary = Napi::Object::New(env);
+                summary.Set("total", Napi::Number::New(env, job->filePaths.size()));
+                summary.Set("succeeded", Napi::Number::New(env, job->succeeded));
+                job->onDone.Call({env.Null(), summary});
+            }
+            
+            delete job;
+        });
+    
+    job->thread = std::thread([job, onResult]() mutable {
+        job->succeeded = AIMetadataAnalyzer::analyzeBatch(job->filePaths, job->options,
+            [&onResult](const BatchItemResult& item) {
+                auto* pending = new BatchItemResult(item);
+                napi_status status = onResult.BlockingCall(pending, [](Napi::Env env, Napi::Function callback, BatchItemResult* item) {
+                    if (env != nullptr && callback != nullptr) {
+                        Napi::Object jsItem = Napi::Object::New(env);
+                        jsItem.Set("filePath", Napi::String::New(env, item->filePath));
+                        
+                        if (item->success) {
+                            jsItem.Set("result", ResultToObject(env, item->result));
+                            callback.Call({env.Null(), jsItem});
+                        } else {
+                            callback.Call({Napi::Error::New(env, item->error).Value(), jsItem});
+                        }
+                    }
+                    delete item;
+                });
+                if (status != napi_ok) {
+                    delete pending;  // Never queued, e.g. napi_closing during env teardown
+                }
+            });
+        
+        onResult.Release();
+    });
+    
+    return env.Undefined();
+}
+
+// Library-wide HAMMS index; only touched from the JS thread
+static HAMMSIndex& SimilarityIndex() {
+    static HAMMSIndex index;
+    return index;
+}
+
+// Library-wide key / BPM / energy buckets; only touched from the JS thread
+static HarmonicMixingIndex& MixingIndex() {
+    static HarmonicMixingIndex index;
+    return index;
+}
+
+static float NumberOr(const Napi::Object& object, const char* name, float fallback) {
+    if (!object.Has(name)) return fallback;
+    Napi::Value value = object.Get(name);
+    return value.IsNumber() ? value.As<Napi::Number>().FloatValue() : fallback;
+}
+
+static const char* const HAMMS_KEYS[HAMMSBatch::DIMENSIONS] = {
+    "harmonicity", "melodicity", "rhythmicity", "timbrality", "dynamics", "tonality", "temporality"
+};
+
+// { harmonicity, melodicity, ... } as stored in hamms_vector; missing keys read as 0.
+// False when none of the seven is a number, i.e. not a HAMMS vector at all.
+static bool HAMMSFromObject(const Napi::Object& hamms, HAMMSVector& vector) {
+    bool found = false;
+    for (const char* key : HAMMS_KEYS) {
+        found = found || (hamms.Has(key) && hamms.Get(key).IsNumber());
+    }
+    if (!found) return false;
+    
+    vector.harmonicity = NumberOr(hamms, "harmonicity", 0.0f);
+    vector.melodicity = NumberOr(hamms, "melodicity", 0.0f);
+    vector.rhythmicity = NumberOr(hamms, "rhythmicity", 0.0f);
+    vector.timbrality = NumberOr(hamms, "timbrality", 0.0f);
+    vector.dynamics = NumberOr(hamms, "dynamics", 0.0f);
+    vector.tonality = NumberOr(hamms, "tonality", 0.0f);
+    vector.temporality = NumberOr(hamms, "temporality", 0.0f);
+    return true;
+}
+
+// Add or replace a track: indexTrack(trackId, hammsVector, [{ bpm, energy }])
+// -> false when hammsVector has none of the HAMMS keys, leaving the track out
+Napi::Value IndexTrack(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "Arguments must be: number, object, [object]")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int64_t trackId = info[0].As<Napi::Number>().Int64Value();
+    HAMMSVector vector;
+    if (!HAMMSFromObject(info[1].As<Napi::Object>(), vector)) {
+        SimilarityIndex().remove(trackId);   // A stale vector must not outlive its replacement
+        return Napi::Boolean::New(env, false);
+    }
+    
+    float bpm = NAN, energy = NAN;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object attributes = info[2].As<Napi::Object>();
+        bpm = NumberOr(attributes, "bpm", NAN);
+        energy = NumberOr(attributes, "energy", NAN);
+    }
+    
+    SimilarityIndex().upsert(trackId, vector, bpm, energy);
+    return Napi::Boolean::New(env, true);
+}
+
+// Add or replace a track for harmonic mixing: indexMixingTrack(trackId, { key, bpm, energy })
+// -> false when the key ("C# minor", "Bbm") or BPM is missing, leaving the track out
+Napi::Value IndexMixingTrack(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "Arguments must be: number, object")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Object attributes = info[1].As<Napi::Object>();
+    int key = -1;
+    if (attributes.Has("key") && attributes.Get("key").IsString()) {
+        key = KeyDetector::keyIndex(attributes.Get("key").As<Napi::String>().Utf8Value());
+    }
+    
+    bool indexed = MixingIndex().upsert(info[0].As<Napi::Number>().Int64Value(), key,
+                                        NumberOr(attributes, "bpm", NAN), NumberOr(attributes, "energy", NAN));
+    return Napi::Boolean::New(env, indexed);
+}
+
+// removeTrack(trackId) -> whether it was indexed; drops it from both indexes
+Napi::Value RemoveTrack(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Argument must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int64_t trackId = info[0].As<Napi::Number>().Int64Value();
+    bool removed = MixingIndex().remove(trackId);
+    removed = SimilarityIndex().remove(trackId) || removed;
+    return Napi::Boolean::New(env, removed);
+}
+
+// Nearest indexed tracks, most similar first:
+// findSimilar(trackId, k, [{ minBPM, maxBPM, minEnergy, maxEnergy, minSimilarity }]) -> [{ trackId, similarity }]
+Napi::Value FindSimilar(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Arguments must be: number, number, [object]")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    SimilarityFilters filters;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object options = info[2].As<Napi::Object>();
+        filters.minBPM = NumberOr(options, "minBPM", filters.minBPM);
+        filters.maxBPM = NumberOr(options, "maxBPM", filters.maxBPM);
+        filters.minEnergy = NumberOr(options, "minEnergy", filters.minEnergy);
+        filters.maxEnergy = NumberOr(options, "maxEnergy", filters.maxEnergy);
+        filters.minSimilarity = NumberOr(options, "minSimilarity", filters.minSimilarity);
+    }
+    
+    int64_t k = info[1].As<Napi::Number>().Int64Value();
+    std::vector<SimilarTrack> similar = SimilarityIndex().findSimilar(
+        info[0].As<Napi::Number>().Int64Value(), k > 0 ? (size_t)k : 0, filters);
+    
+    Napi::Array jsSimilar = Napi::Array::New(env, similar.size());
+    for (size_t i = 0; i < similar.size(); i++) {
+        Napi::Object match = Napi::Object::New(env);
+        match.Set("trackId", Napi::Number::New(env, (double)similar[i].trackId));
+        match.Set("similarity", Napi::Number::New(env, similar[i].similarity));
+        jsSimilar[i] = match;
+    }
+    return jsSimilar;
+}
+
+// Tracks that mix well after this one, closest in tempo and energy first:
+// findCompatible(trackId, limit, [{ bpmTolerance, tempoMultiples, maxEnergyDifference }])
+// -> [{ trackId, camelot, bpm, energy, tempoRatio }]
+Napi::Value FindCompatible(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Arguments must be: number, number, [object]")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    MixingFilters filters;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object options = info[2].As<Napi::Object>();
+        filters.bpmTolerance = NumberOr(options, "bpmTolerance", filters.bpmTolerance);
+        filters.maxEnergyDifference = NumberOr(options, "maxEnergyDifference", filters.maxEnergyDifference);
+        if (options.Has("tempoMultiples") && options.Get("tempoMultiples").IsBoolean()) {
+            filters.tempoMultiples = options.Get("tempoMultiples").As<Napi::Boolean>().Value();
+        }
+    }
+    
+    int64_t limit = info[1].As<Napi::Number>().Int64Value();
+    std::vector<MixingMatch> compatible = MixingIndex().compatibleTracks(
+        info[0].As<Napi::Number>().Int64Value(), limit > 0 ? (size_t)limit : 0, filters);
+    
+    Napi::Array jsCompatible = Napi::Array::New(env, compatible.size());
+    for (size_t i = 0; i < compatible.size(); i++) {
+        Napi::Object match = Napi::Object::New(env);
+        match.Set("trackId", Napi::Number::New(env, (double)compatible[i].trackId));
+        match.Set("camelot", Napi::String::New(env, HarmonicMixingIndex::camelotName(compatible[i].camelot)));
+        match.Set("bpm", Napi::Number::New(env, compatible[i].bpm));
+        if (!std::isnan(compatible[i].energy)) match.Set("energy", Napi::Number::New(env, compatible[i].energy));
+        match.Set("tempoRatio", Napi::Number::New(env, compatible[i].tempoRatio));
+        jsCompatible[i] = match;
+    }
+    return jsCompatible;
+}
+
+// AsyncWorker building the neighbour graph and clusters of a whole library
+class ClusteringWorker : public Napi::AsyncWorker {
+public:
+    ClusteringWorker(Napi::Function& callback, std::vector<TrackFeatures> tracks,
+                     int clusters, size_t neighbors, size_t threads)
+        : Napi::AsyncWorker(callback),
+          tracks(std::move(tracks)),
+          clusters(clusters),
+          neighbors(neighbors),
+          threads(threads) {}
+    
+    void Execute() override {
+        try {
+            std::unique_ptr<ThreadPool> pool;
+            ClusteringOptions options;
+            if (threads > 0) {
+                pool = std::make_unique<ThreadPool>(threads);
+                options.pool = pool.get();
+            }
+            
+            LibraryClustering clustering(tracks, options);
+            result = clustering.kMeans(clusters);
+            if (neighbors > 0) graph = clustering.nearestNeighbors(neighbors);
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+    }
+    
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::HandleScope scope(env);
+        
+        // Typed arrays rather than one object per track: a 100K library stays a handful of allocations
+        Napi::Float64Array trackIds = Napi::Float64Array::New(env, tracks.size());
+        Napi::Int32Array assignments = Napi::Int32Array::New(env, tracks.size());
+        for (size_t i = 0; i < tracks.size(); i++) {
+            trackIds[i] = (double)tracks[i].trackId;
+            assignments[i] = result.assignments[i];
+        }
+        Napi::Uint32Array neighborIds = Napi::Uint32Array::New(env, graph.neighbors.size());
+        std::copy(graph.neighbors.begin(), graph.neighbors.end(), neighborIds.Data());
+        Napi::Float32Array similarities = Napi::Float32Array::New(env, graph.similarities.size());
+        std::copy(graph.similarities.begin(), graph.similarities.end(), similarities.Data());
+        
+        Napi::Object jsResult = Napi::Object::New(env);
+        jsResult.Set("trackIds", trackIds);
+        jsResult.Set("clusterCount", Napi::Number::New(env, result.count));
+        jsResult.Set("clusters", assignments);
+        jsResult.Set("k", Napi::Number::New(env, (double)graph.k));
+        jsResult.Set("neighbors", neighborIds);
+        jsResult.Set("similarities", similarities);
+        Callback().Call({env.Null(), jsResult});
+    }
+    
+private:
+    std::vector<TrackFeatures> tracks;
+    int clusters;
+    size_t neighbors;
+    size_t threads;
+    TrackClusters result;
+    NeighborGraph graph;
+};
+
+// Cluster a library and find every track's nearest neighbours:
+// clusterLibrary([{ trackId, hamms, energy, valence, danceability, bpm, key }],
+//                { clusters, neighbors, threads }, callback(err, result))
+// result.clusters[i] is the cluster of trackIds[i]; its neighbours are rows
+// neighbors[i * k .. (i + 1) * k) (indices into trackIds) with their similarities.
+Napi::Value ClusterLibrary(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 3 || !info[0].IsArray() || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "Arguments must be: array, object, function")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Array tracksArray = info[0].As<Napi::Array>();
+    std::vector<TrackFeatures> tracks;
+    tracks.reserve(tracksArray.Length());
+    for (uint32_t i = 0; i < tracksArray.Length(); i++) {
+        Napi::Value item = tracksArray.Get(i);
+        if (!item.IsObject()) continue;
+        Napi::Object track = item.As<Napi::Object>();
+        if (!track.Has("trackId") || !track.Get("trackId").IsNumber() || !track.Has("hamms") ||
+            !track.Get("hamms").IsObject()) {
+            continue;
+        }
+        
+        TrackFeatures features;
+        if (!HAMMSFromObject(track.Get("hamms").As<Napi::Object>(), features.hamms)) continue;
+        features.trackId = track.Get("trackId").As<Napi::Number>().Int64Value();
+        features.energy = NumberOr(track, "energy", NAN);
+        features.valence = NumberOr(track, "valence", NAN);
+        features.danceability = NumberOr(track, "danceability", NAN);
+        features.bpm = NumberOr(track, "bpm", NAN);
+        if (track.Has("key") && track.Get("key").IsString()) {
+            features.key = KeyDetector::keyIndex(track.Get("key").As<Napi::String>().Utf8Value());
+        }
+        tracks.push_back(features);
+    }
+    
+    Napi::Object options = info[1].As<Napi::Object>();
+    int clusters = (int)NumberOr(options, "clusters", 0.0f);
+    float neighbors = NumberOr(options, "neighbors", 10.0f);
+    float threads = NumberOr(options, "threads", 0.0f);
+    Napi::Function callback = info[2].As<Napi::Function>();
+    
+    ClusteringWorker* worker = new ClusteringWorker(callback, std::move(tracks), clusters,
+                                                    neighbors > 0 ? (size_t)neighbors : 0,
+                                                    threads > 0 ? (size_t)threads : 0);
+    worker->Queue();
+    
+    return env.Undefined();
+}
+
 // Initialize module - only AI analysis functionality
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set(Napi::String::New(env, "analyzeAudio"), 
                 Napi::Function::New(env, AnalyzeAudio));
+    exports.Set(Napi::String::New(env, "analyzeSamples"), 
+                Napi::Function::New(env, AnalyzeSamples));
+    exports.Set(Napi::String::New(env, "analyzeBatch"), 
+                Napi::Function::New(env, AnalyzeBatch));
+    exports.Set(Napi::String::New(env, "indexTrack"), 
+                Napi::Function::New(env, IndexTrack));
+    exports.Set(Napi::String::New(env, "removeTrack"), 
+                Napi::Function::New(env, RemoveTrack));
+    exports.Set(Napi::String::New(env, "findSimilar"), 
+                Napi::Function::New(env, FindSimilar));
+    exports.Set(Napi::String::New(env, "indexMixingTrack"), 
+                Napi::Function::New(env, IndexMixingTrack));
+    exports.Set(Napi::String::New(env, "findCompatible"), 
+                Napi::Function::New(env, FindCompatible));
+    exports.Set(Napi::String::New(env, "clusterLibrary"), 
+                Napi::Function::New(env, ClusterLibrary));
     
     return exports;
 }
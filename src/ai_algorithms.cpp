@@ -1,7 +1,7 @@
 #include "ai_algorithms.h"
-#include <fftw3.h>
 #include <cmath>
 #include <complex>
+#include <cctype>
 #include <numeric>
 #include <algorithm>
 #include <map>
@@ -13,89 +13,41 @@ namespace MusicAnalysis {
 // 🔊 CORE AUDIO PROCESSING IMPLEMENTATION
 // ========================================
 
-AudioBuffer AudioProcessor::preprocessAudio(const std::vector<float>& rawAudio, int sampleRate) {
-    // Normalize audio
-    auto normalized = normalize(rawAudio);
+AudioBuffer AudioProcessor::preprocessAudio(SampleSpan rawAudio, int sampleRate) {
+    if (rawAudio.empty()) return AudioBuffer(std::vector<float>(), sampleRate, 1);
+
+    // Normalize on the fly so the only full-length allocation is the output
+    float maxVal = VectorKernels::maxValue(rawAudio.data(), rawAudio.size());
+    float minVal = VectorKernels::minValue(rawAudio.data(), rawAudio.size());
+    float range = std::max(std::abs(maxVal), std::abs(minVal));
+    auto normalized = [&](size_t i) { return range > 0 ? rawAudio[i] / range : 0.0f; };
     
     // Apply high-pass filter to remove DC component
-    std::vector<float> filtered(normalized.size());
+    std::vector<float> filtered(rawAudio.size());
     float alpha = 0.95f;
-    filtered[0] = normalized[0];
-    for (size_t i = 1; i < normalized.size(); i++) {
-        filtered[i] = alpha * (filtered[i-1] + normalized[i] - normalized[i-1]);
+    float previous = normalized(0);
+    filtered[0] = previous;
+    for (size_t i = 1; i < rawAudio.size(); i++) {
+        float current = normalized(i);
+        filtered[i] = alpha * (filtered[i-1] + current - previous);
+        previous = current;
     }
     
-    return AudioBuffer(filtered, sampleRate, 1);
+    return AudioBuffer(std::move(filtered), sampleRate, 1);
 }
 
-std::vector<std::complex<float>> AudioProcessor::calculateFFT(const std::vector<float>& signal) {
-    int N = signal.size();
-    
-    // Plan FFTW
-    float* in = (float*)fftwf_malloc(sizeof(float) * N);
-    fftwf_complex* out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * (N/2 + 1));
-    
-    // Copy input data
-    std::copy(signal.begin(), signal.end(), in);
-    
-    fftwf_plan plan = fftwf_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
-    fftwf_execute(plan);
-    
-    // Convert to std::complex
-    std::vector<std::complex<float>> result(N/2 + 1);
-    for (int i = 0; i < N/2 + 1; i++) {
-        result[i] = std::complex<float>(out[i][0], out[i][1]);
-    }
-    
-    // Cleanup
-    fftwf_destroy_plan(plan);
-    fftwf_free(in);
-    fftwf_free(out);
-    
-    return result;
-}
+// AudioProcessor::calculateFFT moved to ai_algorithms_fft.cpp (cached plans)
 
 SpectralFeatures AudioProcessor::calculateSpectralFeatures(const AudioBuffer& audio) {
     auto fft = calculateFFT(audio.samples);
     SpectralFeatures features;
+    features.sampleRate = audio.sampleRate;
     
     // Calculate magnitude spectrum
-    features.magnitude.reserve(fft.size());
-    for (const auto& complex_val : fft) {
-        features.magnitude.push_back(std::abs(complex_val));
-    }
-    
-    // Calculate frequencies
-    features.frequencies.resize(fft.size());
-    for (size_t i = 0; i < fft.size(); i++) {
-        features.frequencies[i] = (float)i * audio.sampleRate / (2.0f * (fft.size() - 1));
-    }
-    
-    // Spectral Centroid
-    float numerator = 0.0f, denominator = 0.0f;
-    for (size_t i = 0; i < features.magnitude.size(); i++) {
-        numerator += features.frequencies[i] * features.magnitude[i];
-        denominator += features.magnitude[i];
-    }
-    features.spectralCentroid = denominator > 0 ? numerator / denominator : 0.0f;
-    
-    // Spectral Rolloff (85% of energy)
-    float totalEnergy = 0.0f;
-    for (float mag : features.magnitude) {
-        totalEnergy += mag * mag;
-    }
-    
-    float cumulativeEnergy = 0.0f;
-    float threshold = 0.85f * totalEnergy;
-    features.spectralRolloff = 0.0f;
+    features.magnitude.resize(fft.size());
+    VectorKernels::complexMagnitude(fft.data(), features.magnitude.data(), fft.size());
     
-    for (size_t i = 0; i < features.magnitude.size(); i++) {
-        cumulativeEnergy += features.magnitude[i] * features.magnitude[i];
-        if (cumulativeEnergy >= threshold) {
-            features.spectralRolloff = features.frequencies[i];
-            break;
-        }
-    }
+    calculateSpectralShape(features);
     
     // Zero Crossing Rate
     int zeroCrossings = 0;
@@ -109,46 +61,204 @@ SpectralFeatures AudioProcessor::calculateSpectralFeatures(const AudioBuffer& au
     return features;
 }
 
+void AudioProcessor::calculateSpectralShape(SpectralFeatures& features) {
+    const size_t bins = features.magnitude.size();
+    SpectralMoments sums = VectorKernels::spectralMoments(features.magnitude.data(), bins);
+    
+    // Spectral Centroid
+    features.spectralCentroid = sums.magnitude > 0 ? features.binWidth() * sums.indexWeighted / sums.magnitude : 0.0f;
+    
+    // Spectral Rolloff (85% of energy)
+    size_t rolloff = SpectralDescriptorExtractor::rolloffBin(features.magnitude.data(), bins, sums.power);
+    features.spectralRolloff = features.frequency(rolloff);
+}
+
 ChromaVector AudioProcessor::calculateChroma(const AudioBuffer& audio) {
-    auto fft = calculateFFT(audio.samples);
-    ChromaVector chroma;
+    return calculateChroma(calculateSpectralFeatures(audio));
+}
+
+namespace {
+
+// Contiguous FFT bins that fall on the same pitch class
+struct ChromaRun {
+    int begin;
+    int end;
+    int pitchClass;
+};
+
+// Nearest MIDI note of a bin centre, or -1 below 80 Hz (very low bins are skipped)
+int binNote(int bin, int numBins, int sampleRate) {
+    float frequency = (float)bin * sampleRate / (2.0f * (numBins - 1));
+    if (frequency < 80.0f) return -1;
     
-    // Calculate chroma from FFT
-    for (size_t i = 0; i < fft.size(); i++) {
-        float frequency = (float)i * audio.sampleRate / (2.0f * (fft.size() - 1));
-        if (frequency < 80.0f) continue; // Skip very low frequencies
+    float midiNote = 12.0f * std::log2(frequency / 440.0f) + 69.0f;
+    return (int)std::round(midiNote);
+}
+
+std::vector<ChromaRun> buildChromaRuns(int numBins, int sampleRate) {
+    std::vector<ChromaRun> runs;
+    
+    // binNote never decreases, so each note's bins are found by bisection
+    // instead of a log2 per bin
+    int begin = 0;
+    while (begin < numBins) {
+        int note = binNote(begin, numBins, sampleRate);
         
-        // Convert frequency to MIDI note
-        float midiNote = 12.0f * std::log2(frequency / 440.0f) + 69.0f;
-        int chromaticClass = (int)std::round(midiNote) % 12;
+        int step = 1;
+        while (begin + step < numBins && binNote(begin + step, numBins, sampleRate) == note) {
+            step *= 2;
+        }
+        int low = begin + step / 2;                 // Known to share the note
+        int high = std::min(begin + step, numBins); // First bin past it, or the end
+        while (high - low > 1) {
+            int mid = low + (high - low) / 2;
+            if (binNote(mid, numBins, sampleRate) == note) low = mid;
+            else high = mid;
+        }
         
-        if (chromaticClass >= 0 && chromaticClass < 12) {
-            chroma.chroma[chromaticClass] += std::abs(fft[i]);
+        if (note >= 0) {
+            runs.push_back({begin, high, note % 12});
         }
+        begin = high;
     }
     
-    // Normalize chroma vector
+    return runs;
+}
+
+// Bin → pitch-class tables, shared across tracks and threads per (bins, sample rate)
+const std::vector<ChromaRun>& chromaRuns(int numBins, int sampleRate) {
+    static std::mutex cacheMutex;
+    static std::map<std::pair<int, int>, std::vector<ChromaRun>> cache;
+    
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto key = std::make_pair(numBins, sampleRate);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, numBins > 1 ? buildChromaRuns(numBins, sampleRate) : std::vector<ChromaRun>()).first;
+    }
+    return it->second;
+}
+
+void accumulateChroma(const float* magnitude, const std::vector<ChromaRun>& runs, float* chroma) {
+    for (const ChromaRun& run : runs) {
+        for (int i = run.begin; i < run.end; i++) {
+            chroma[run.pitchClass] += magnitude[i];
+        }
+    }
+}
+
+void normalizeChroma(ChromaVector& chroma) {
     float sum = std::accumulate(chroma.chroma.begin(), chroma.chroma.end(), 0.0f);
     if (sum > 0) {
         for (float& val : chroma.chroma) {
             val /= sum;
         }
     }
+}
+
+} // namespace
+
+ChromaVector AudioProcessor::calculateChroma(const SpectralFeatures& features) {
+    ChromaVector chroma;
+    int numBins = static_cast<int>(features.magnitude.size());
+    
+    // Calculate chroma from the magnitude spectrum
+    accumulateChroma(features.magnitude.data(), chromaRuns(numBins, features.sampleRate), chroma.chroma.data());
+    normalizeChroma(chroma);
     
     return chroma;
 }
 
-float AudioProcessor::calculateRMS(const std::vector<float>& signal) {
-    float sum = 0.0f;
-    for (float sample : signal) {
-        sum += sample * sample;
+ChromaVector AudioProcessor::calculateChroma(const float* magnitude, int numBins, int sampleRate) {
+    ChromaVector chroma;
+    accumulateChroma(magnitude, chromaRuns(numBins, sampleRate), chroma.chroma.data());
+    normalizeChroma(chroma);
+    return chroma;
+}
+
+Chromagram AudioProcessor::calculateChromagram(SampleSpan signal, int sampleRate, int frameSize, int hopSize) {
+    Chromagram chromagram;
+    chromagram.frameSize = frameSize;
+    chromagram.hopSize = hopSize;
+    chromagram.sampleRate = sampleRate;
+    chromagram.numFrames = (int)signal.size() >= frameSize
+        ? ((int)signal.size() - frameSize) / hopSize + 1
+        : 0;
+    if (chromagram.numFrames == 0) return chromagram;
+    
+    chromagram.values.assign(static_cast<size_t>(chromagram.numFrames) * 12, 0.0f);
+    const std::vector<ChromaRun>& runs = chromaRuns(frameSize / 2 + 1, sampleRate);
+    
+    // STFT in blocks of frames so the magnitude matrix stays small for long tracks
+    const int blockFrames = 64;
+    for (int first = 0; first < chromagram.numFrames; first += blockFrames) {
+        int count = std::min(blockFrames, chromagram.numFrames - first);
+        SampleSpan block = signal.subspan(static_cast<size_t>(first) * hopSize,
+                                          static_cast<size_t>(count - 1) * hopSize + frameSize);
+        STFTFrames frames = calculateSTFT(block, frameSize, hopSize);
+        
+        for (int f = 0; f < frames.numFrames; f++) {
+            float* chroma = chromagram.values.data() + static_cast<size_t>(first + f) * 12;
+            accumulateChroma(frames.frame(f), runs, chroma);
+        }
     }
+    
+    return chromagram;
+}
+
+float AudioProcessor::calculateRMS(SampleSpan signal) {
+    float sum = VectorKernels::sumOfSquares(signal.data(), signal.size());
     return std::sqrt(sum / signal.size());
 }
 
-std::vector<float> AudioProcessor::normalize(const std::vector<float>& signal) {
-    float maxVal = *std::max_element(signal.begin(), signal.end());
-    float minVal = *std::min_element(signal.begin(), signal.end());
+EnergyPrefixSum::EnergyPrefixSum(SampleSpan samples)
+    : count(samples.size()), blocks(samples.size() / BLOCK_SIZE + 1), offsets(samples.size() + 1) {
+    double total = 0.0;
+    for (size_t block = 0; block < blocks.size(); block++) {
+        blocks[block] = total;
+        
+        // Offsets restart at every block, so they stay small enough for float
+        size_t first = block * BLOCK_SIZE;
+        size_t last = std::min(first + BLOCK_SIZE, count);
+        float local = 0.0f;
+        for (size_t i = first; i < last; i++) {
+            offsets[i] = local;
+            local += samples[i] * samples[i];
+        }
+        total += local;
+    }
+    offsets[count] = static_cast<float>(total - blocks[count / BLOCK_SIZE]);
+}
+
+float EnergyPrefixSum::sum(size_t start, size_t length) const {
+    start = std::min(start, count);
+    size_t end = start + std::min(length, count - start);
+    return static_cast<float>(std::max(0.0, cumulative(end) - cumulative(start)));
+}
+
+float EnergyPrefixSum::meanSquare(size_t start, size_t length) const {
+    start = std::min(start, count);
+    length = std::min(length, count - start);
+    return length > 0 ? sum(start, length) / length : 0.0f;
+}
+
+std::vector<float> EnergyPrefixSum::windowSums(size_t windowSize, size_t hopSize,
+                                               size_t start, size_t length) const {
+    std::vector<float> sums;
+    start = std::min(start, count);
+    size_t end = start + std::min(length, count - start);
+    if (windowSize == 0 || hopSize == 0 || end - start < windowSize) return sums;
+    
+    sums.reserve((end - start - windowSize) / hopSize + 1);
+    for (size_t i = start; i + windowSize <= end; i += hopSize) {
+        sums.push_back(sum(i, windowSize));
+    }
+    return sums;
+}
+
+std::vector<float> AudioProcessor::normalize(SampleSpan signal) {
+    float maxVal = VectorKernels::maxValue(signal.data(), signal.size());
+    float minVal = VectorKernels::minValue(signal.data(), signal.size());
     float range = std::max(std::abs(maxVal), std::abs(minVal));
     
     std::vector<float> normalized(signal.size());
@@ -177,42 +287,217 @@ const std::vector<std::string> KeyDetector::KEY_NAMES = {
 };
 
 std::string KeyDetector::detectKey(const AudioBuffer& audio) {
-    ChromaVector chroma = AudioProcessor::calculateChroma(audio);
-    return matchKeyTemplate(chroma);
+    return detectKey(AnalysisContext(audio));
+}
+
+std::string KeyDetector::detectKey(const AnalysisContext& context) {
+    // Summing the frames gives the track's chroma on the same grid as the timeline
+    const Chromagram& chromagram = context.chromagram();
+    if (chromagram.numFrames == 0) {
+        return matchKeyTemplate(context.chroma());  // Shorter than one chroma frame
+    }
+    
+    ChromaVector total;
+    for (int f = 0; f < chromagram.numFrames; f++) {
+        const float* frame = chromagram.frame(f);
+        for (int c = 0; c < 12; c++) {
+            total.chroma[c] += frame[c];
+        }
+    }
+    return matchKeyTemplate(total);
 }
 
 std::string KeyDetector::matchKeyTemplate(const ChromaVector& chroma) {
-    float bestCorrelation = -1.0f;
-    std::string bestKey = "C major";
+    const std::vector<float>& profiles = profileMatrix();
     
-    // Test all 24 keys (12 major + 12 minor)
-    for (int root = 0; root < 12; root++) {
-        // Test major key
-        float majorCorr = 0.0f;
-        for (int i = 0; i < 12; i++) {
-            int chromaticIndex = (i + root) % 12;
-            majorCorr += chroma.chroma[chromaticIndex] * MAJOR_PROFILE[i];
+    // Test all 24 keys (12 major + 12 minor) as one 12 × 24 product
+    float scores[NUM_KEYS] = {};
+    for (int c = 0; c < 12; c++) {
+        const float* row = profiles.data() + c * NUM_KEYS;
+        for (int k = 0; k < NUM_KEYS; k++) {
+            scores[k] += chroma.chroma[c] * row[k];
+        }
+    }
+    
+    int bestKey = 0;
+    for (int k = 1; k < NUM_KEYS; k++) {
+        if (scores[k] > scores[bestKey]) bestKey = k;
+    }
+    return keyName(bestKey);
+}
+
+std::string KeyDetector::keyName(int key) {
+    return KEY_NAMES[key / 2] + (key % 2 ? " minor" : " major");
+}
+
+int KeyDetector::keyIndex(const std::string& name) {
+    static const int NATURAL_ROOTS[7] = { 9, 11, 0, 2, 4, 5, 7 };   // A to G
+
+    size_t i = 0;
+    while (i < name.size() && std::isspace((unsigned char)name[i])) i++;
+    if (i == name.size()) return -1;
+    char letter = (char)std::toupper((unsigned char)name[i++]);
+    if (letter < 'A' || letter > 'G') return -1;
+    int root = NATURAL_ROOTS[letter - 'A'];
+
+    if (i < name.size() && (name[i] == '#' || name[i] == 'b')) {
+        root = (root + (name[i] == '#' ? 1 : 11)) % 12;
+        i++;
+    }
+
+    std::string mode;
+    for (; i < name.size(); i++) {
+        if (!std::isspace((unsigned char)name[i])) mode += (char)std::tolower((unsigned char)name[i]);
+    }
+    if (mode.empty() || mode == "major" || mode == "maj") return root * 2;
+    if (mode == "m" || mode == "minor" || mode == "min") return root * 2 + 1;
+    return -1;
+}
+
+const std::vector<float>& KeyDetector::profileMatrix() {
+    // Column k holds the profile rotated to root k / 2, so chroma × matrix
+    // correlates every key at once
+    static const std::vector<float> matrix = []() {
+        std::vector<float> m(12 * NUM_KEYS);
+        for (int c = 0; c < 12; c++) {
+            for (int root = 0; root < 12; root++) {
+                int degree = (c - root + 12) % 12;
+                m[c * NUM_KEYS + root * 2] = MAJOR_PROFILE[degree];
+                m[c * NUM_KEYS + root * 2 + 1] = MINOR_PROFILE[degree];
+            }
         }
+        return m;
+    }();
+    return matrix;
+}
+
+std::vector<float> KeyDetector::scoreFrames(const Chromagram& chromagram) {
+    const std::vector<float>& profiles = profileMatrix();
+    std::vector<float> scores(static_cast<size_t>(chromagram.numFrames) * NUM_KEYS, 0.0f);
+    
+    for (int f = 0; f < chromagram.numFrames; f++) {
+        const float* chroma = chromagram.frame(f);
+        float* out = scores.data() + static_cast<size_t>(f) * NUM_KEYS;
         
-        if (majorCorr > bestCorrelation) {
-            bestCorrelation = majorCorr;
-            bestKey = KEY_NAMES[root] + " major";
+        float sum = 0.0f;
+        for (int c = 0; c < 12; c++) sum += chroma[c];
+        if (sum <= 0.0f) continue;  // Silent frame: no vote
+        
+        // Contiguous inner loop over keys so the compiler can vectorize it
+        for (int c = 0; c < 12; c++) {
+            const float weight = chroma[c] / sum;
+            const float* row = profiles.data() + c * NUM_KEYS;
+            for (int k = 0; k < NUM_KEYS; k++) {
+                out[k] += weight * row[k];
+            }
+        }
+    }
+    
+    return scores;
+}
+
+std::vector<KeySegment> KeyDetector::detectKeyTimeline(const AnalysisContext& context) {
+    const Chromagram& chromagram = context.chromagram();
+    const int numFrames = chromagram.numFrames;
+    if (numFrames == 0) return {};
+    
+    std::vector<float> scores = scoreFrames(chromagram);
+    const float frameSeconds = (float)chromagram.hopSize / chromagram.sampleRate;
+    
+    auto bestOf = [](const float* row) {
+        int best = 0;
+        for (int k = 1; k < NUM_KEYS; k++) {
+            if (row[k] > row[best]) best = k;
         }
+        return best;
+    };
+    
+    // Centered moving average of the scores, then the best key per frame
+    const int half = std::max(0, (int)std::lround(SMOOTHING_SECONDS / frameSeconds / 2));
+    std::vector<float> windowSum(NUM_KEYS, 0.0f);
+    std::vector<int> frameKeys(numFrames);
+    int windowEnd = 0;  // Frames [windowStart, windowEnd) are in the sum
+    int windowStart = 0;
+    
+    for (int f = 0; f < numFrames; f++) {
+        while (windowEnd < numFrames && windowEnd <= f + half) {
+            const float* row = scores.data() + static_cast<size_t>(windowEnd) * NUM_KEYS;
+            for (int k = 0; k < NUM_KEYS; k++) windowSum[k] += row[k];
+            windowEnd++;
+        }
+        while (windowStart < f - half) {
+            const float* row = scores.data() + static_cast<size_t>(windowStart) * NUM_KEYS;
+            for (int k = 0; k < NUM_KEYS; k++) windowSum[k] -= row[k];
+            windowStart++;
+        }
+        frameKeys[f] = bestOf(windowSum.data());
+    }
+    
+    // Runs of equal keys, as [first, last) frame ranges
+    struct Run { int first; int last; int key; };
+    std::vector<Run> runs;
+    for (int f = 0; f < numFrames; f++) {
+        if (runs.empty() || runs.back().key != frameKeys[f]) {
+            runs.push_back({f, f + 1, frameKeys[f]});
+        } else {
+            runs.back().last = f + 1;
+        }
+    }
+    
+    // Absorb the shortest run below the minimum into its longer neighbour until none is left
+    const int minFrames = std::max(1, (int)std::lround(MIN_SEGMENT_SECONDS / frameSeconds));
+    while (runs.size() > 1) {
+        size_t shortest = 0;
+        for (size_t i = 1; i < runs.size(); i++) {
+            if (runs[i].last - runs[i].first < runs[shortest].last - runs[shortest].first) shortest = i;
+        }
+        if (runs[shortest].last - runs[shortest].first >= minFrames) break;
         
-        // Test minor key
-        float minorCorr = 0.0f;
-        for (int i = 0; i < 12; i++) {
-            int chromaticIndex = (i + root) % 12;
-            minorCorr += chroma.chroma[chromaticIndex] * MINOR_PROFILE[i];
+        size_t target;
+        if (shortest == 0) {
+            target = 1;
+        } else if (shortest == runs.size() - 1) {
+            target = shortest - 1;
+        } else {
+            int before = runs[shortest - 1].last - runs[shortest - 1].first;
+            int after = runs[shortest + 1].last - runs[shortest + 1].first;
+            target = before >= after ? shortest - 1 : shortest + 1;
         }
+        runs[target].first = std::min(runs[target].first, runs[shortest].first);
+        runs[target].last = std::max(runs[target].last, runs[shortest].last);
+        runs.erase(runs.begin() + shortest);
         
-        if (minorCorr > bestCorrelation) {
-            bestCorrelation = minorCorr;
-            bestKey = KEY_NAMES[root] + " minor";
+        // Neighbours may now share a key
+        for (size_t i = 1; i < runs.size();) {
+            if (runs[i].key == runs[i - 1].key) {
+                runs[i - 1].last = runs[i].last;
+                runs.erase(runs.begin() + i);
+            } else {
+                i++;
+            }
         }
     }
     
-    return bestKey;
+    std::vector<KeySegment> timeline;
+    timeline.reserve(runs.size());
+    const float trackEnd = ((float)(numFrames - 1) * chromagram.hopSize + chromagram.frameSize) / chromagram.sampleRate;
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run& run = runs[i];
+        
+        int agreeing = 0;
+        for (int f = run.first; f < run.last; f++) {
+            if (bestOf(scores.data() + static_cast<size_t>(f) * NUM_KEYS) == run.key) agreeing++;
+        }
+        
+        KeySegment segment;
+        segment.startTime = run.first * frameSeconds;
+        segment.endTime = i + 1 < runs.size() ? runs[i + 1].first * frameSeconds : trackEnd;
+        segment.key = keyName(run.key);
+        segment.confidence = (float)agreeing / (run.last - run.first);
+        timeline.push_back(segment);
+    }
+    
+    return timeline;
 }
 
 // ========================================
@@ -220,20 +505,32 @@ std::string KeyDetector::matchKeyTemplate(const ChromaVector& chroma) {
 // ========================================
 
 float BPMDetector::detectBPM(const AudioBuffer& audio) {
-    OnsetVector onsets = detectOnsets(audio);
-    std::vector<float> intervals = calculateInterOnsetIntervals(onsets);
-    float bpm = autocorrelationTempo(intervals);
-    return validateGenreBPM(bpm);
+    return detectBPM(AnalysisContext(audio));
+}
+
+float BPMDetector::detectBPM(const AnalysisContext& context) {
+    return context.bpm();
+}
+
+float BPMDetector::detectBPM(const std::vector<float>& spectralFlux, int sampleRate) {
+    return BeatTracker::track(spectralFlux, sampleRate).bpm;
 }
 
 OnsetVector BPMDetector::detectOnsets(const AudioBuffer& audio) {
-    std::vector<float> spectralFlux = calculateSpectralFlux(audio);
+    return detectOnsets(AnalysisContext(audio));
+}
+
+OnsetVector BPMDetector::detectOnsets(const AnalysisContext& context) {
+    return context.onsets();
+}
+
+OnsetVector BPMDetector::detectOnsets(const std::vector<float>& spectralFlux, int sampleRate) {
     std::vector<float> thresholds = adaptiveThresholding(spectralFlux);
     
     OnsetVector onsets;
-    float timePerFrame = 512.0f / audio.sampleRate; // Assuming 512 sample hop size
+    float timePerFrame = (float)AnalysisContext::HOP_SIZE / sampleRate;
     
-    for (size_t i = 1; i < spectralFlux.size() - 1; i++) {
+    for (size_t i = 1; i + 1 < spectralFlux.size(); i++) {
         if (spectralFlux[i] > thresholds[i] && 
             spectralFlux[i] > spectralFlux[i-1] && 
             spectralFlux[i] > spectralFlux[i+1]) {
@@ -245,32 +542,16 @@ OnsetVector BPMDetector::detectOnsets(const AudioBuffer& audio) {
     return onsets;
 }
 
-std::vector<float> BPMDetector::calculateSpectralFlux(const AudioBuffer& audio) {
-    int frameSize = 1024;
-    int hopSize = 512;
+std::vector<float> BPMDetector::calculateSpectralFlux(const STFTFrames& frames) {
     std::vector<float> flux;
+    if (frames.numFrames < 2) return flux;
+    flux.reserve(frames.numFrames - 1);
     
-    std::vector<float> prevMagnitude;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - frameSize; i += hopSize) {
-        std::vector<float> frame(audio.samples.begin() + i, audio.samples.begin() + i + frameSize);
-        auto fft = AudioProcessor::calculateFFT(frame);
+    for (int f = 1; f < frames.numFrames; f++) {
+        const float* magnitude = frames.frame(f);
+        const float* prevMagnitude = frames.frame(f - 1);
         
-        std::vector<float> magnitude;
-        for (const auto& complex_val : fft) {
-            magnitude.push_back(std::abs(complex_val));
-        }
-        
-        if (!prevMagnitude.empty()) {
-            float fluxValue = 0.0f;
-            for (size_t j = 0; j < std::min(magnitude.size(), prevMagnitude.size()); j++) {
-                float diff = magnitude[j] - prevMagnitude[j];
-                if (diff > 0) fluxValue += diff;
-            }
-            flux.push_back(fluxValue);
-        }
-        
-        prevMagnitude = magnitude;
+        flux.push_back(VectorKernels::positiveDifferenceSum(magnitude, prevMagnitude, frames.numBins));
     }
     
     return flux;
@@ -302,182 +583,25 @@ std::vector<float> BPMDetector::adaptiveThresholding(const std::vector<float>& f
     return thresholds;
 }
 
-std::vector<float> BPMDetector::calculateInterOnsetIntervals(const OnsetVector& onsets) {
-    std::vector<float> intervals;
-    for (size_t i = 1; i < onsets.onsetTimes.size(); i++) {
-        intervals.push_back(onsets.onsetTimes[i] - onsets.onsetTimes[i-1]);
-    }
-    return intervals;
-}
-
-float BPMDetector::autocorrelationTempo(const std::vector<float>& intervals) {
-    if (intervals.empty()) return 120.0f; // Default BPM
-    
-    // Convert intervals to BPM candidates
-    std::map<int, float> bpmCandidates;
-    
-    for (float interval : intervals) {
-        if (interval > 0.2f && interval < 2.0f) { // Valid interval range
-            int bpm = (int)std::round(60.0f / interval);
-            if (bpm >= 60 && bpm <= 200) {
-                bpmCandidates[bpm] += 1.0f;
-            }
-        }
-    }
-    
-    // Find most common BPM
-    int bestBPM = 120;
-    float bestScore = 0.0f;
-    
-    for (const auto& candidate : bpmCandidates) {
-        if (candidate.second > bestScore) {
-            bestScore = candidate.second;
-            bestBPM = candidate.first;
-        }
-    }
-    
-    return (float)bestBPM;
-}
-
-float BPMDetector::validateGenreBPM(float estimatedBPM) {
-    // Genre-aware validation ranges
-    if (estimatedBPM < 60) return estimatedBPM * 2; // Double time
-    if (estimatedBPM > 200) return estimatedBPM / 2; // Half time
-    return estimatedBPM;
-}
-
 // ========================================
 // 🔊 AI_LOUDNESS - EBU R128 Standard
 // ========================================
 
-const std::vector<float> LoudnessAnalyzer::K_WEIGHTING_B = {1.53512485958697f, -2.69169618940638f, 1.19839281085285f};
-const std::vector<float> LoudnessAnalyzer::K_WEIGHTING_A = {1.0f, -1.69065929318241f, 0.73248077421585f};
-
 float LoudnessAnalyzer::calculateLUFS(const AudioBuffer& audio) {
-    AudioBuffer weightedAudio = applyKWeighting(audio);
-    return calculateIntegratedLoudness(weightedAudio);
-}
-
-AudioBuffer LoudnessAnalyzer::applyKWeighting(const AudioBuffer& audio) {
-    std::vector<float> filtered = audio.samples;
-    
-    // ITU-R BS.1770 K-weighting filter implementation
-    // Stage 1: Pre-filter (high-pass)
-    // Butterworth filter fc = 38 Hz
-    double f0 = 38.0;
-    double Q = 0.5;
-    double K = tan(M_PI * f0 / audio.sampleRate);
-    double norm = 1.0 / (1.0 + K / Q + K * K);
-    double a0 = 1.0 * norm;
-    double a1 = -2.0 * norm;
-    double a2 = 1.0 * norm;
-    double b1 = 2.0 * (K * K - 1.0) * norm;
-    double b2 = (1.0 - K / Q + K * K) * norm;
-    
-    std::vector<float> stage1(filtered.size());
-    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
-    
-    for (size_t i = 0; i < filtered.size(); i++) {
-        double x0 = filtered[i];
-        double y0 = a0 * x0 + a1 * x1 + a2 * x2 - b1 * y1 - b2 * y2;
-        
-        stage1[i] = y0;
-        
-        x2 = x1;
-        x1 = x0;
-        y2 = y1;
-        y1 = y0;
-    }
-    
-    // Stage 2: High-frequency shelf
-    // Butterworth high shelf fc = 1681 Hz, G = +3.999843 dB
-    double f1 = 1681.0;
-    double G = pow(10.0, 3.999843 / 20.0);
-    double K1 = tan(M_PI * f1 / audio.sampleRate);
-    double V0 = pow(10.0, G / 20.0);
-    double root2 = sqrt(2.0);
-    
-    double a0s, a1s, a2s, b0s, b1s, b2s;
-    
-    if (G >= 0) {
-        double norm1 = 1.0 / (1.0 + root2 * K1 + K1 * K1);
-        a0s = (V0 + root2 * sqrt(V0) * K1 + K1 * K1) * norm1;
-        a1s = 2.0 * (K1 * K1 - V0) * norm1;
-        a2s = (V0 - root2 * sqrt(V0) * K1 + K1 * K1) * norm1;
-        b0s = 1.0;
-        b1s = 2.0 * (K1 * K1 - 1.0) * norm1;
-        b2s = (1.0 - root2 * K1 + K1 * K1) * norm1;
-    } else {
-        double norm1 = 1.0 / (V0 + root2 * sqrt(V0) * K1 + K1 * K1);
-        a0s = (1.0 + root2 * K1 + K1 * K1) * norm1;
-        a1s = 2.0 * (K1 * K1 - 1.0) * norm1;
-        a2s = (1.0 - root2 * K1 + K1 * K1) * norm1;
-        b0s = 1.0;
-        b1s = 2.0 * (K1 * K1 - V0) * norm1;
-        b2s = (V0 - root2 * sqrt(V0) * K1 + K1 * K1) * norm1;
-    }
-    
-    std::vector<float> output(stage1.size());
-    x1 = 0; x2 = 0; y1 = 0; y2 = 0;
-    
-    for (size_t i = 0; i < stage1.size(); i++) {
-        double x0 = stage1[i];
-        double y0 = a0s * x0 + a1s * x1 + a2s * x2 - b1s * y1 - b2s * y2;
-        
-        output[i] = y0;
-        
-        x2 = x1;
-        x1 = x0;
-        y2 = y1;
-        y1 = y0;
-    }
-    
-    return AudioBuffer(output, audio.sampleRate, audio.channels);
+    LoudnessMeter meter(audio.sampleRate, false);
+    meter.process(audio.samples.data(), audio.samples.size());
+    return meter.integratedLoudness();
 }
 
-float LoudnessAnalyzer::calculateIntegratedLoudness(const AudioBuffer& weightedAudio) {
-    // Calculate mean square in 400ms blocks
-    int blockSize = (int)(0.4f * weightedAudio.sampleRate); // 400ms
-    std::vector<float> blockLoudness;
-    
-    for (int i = 0; i <= (int)weightedAudio.samples.size() - blockSize; i += blockSize) {
-        float meanSquare = 0.0f;
-        for (int j = i; j < i + blockSize; j++) {
-            meanSquare += weightedAudio.samples[j] * weightedAudio.samples[j];
-        }
-        meanSquare /= blockSize;
-        
-        if (meanSquare > 0) {
-            float loudness = -0.691f + 10.0f * std::log10(meanSquare);
-            blockLoudness.push_back(loudness);
-        }
-    }
-    
-    if (blockLoudness.empty()) return -70.0f; // Very quiet
-    
-    // Gating: remove blocks below threshold
-    std::sort(blockLoudness.begin(), blockLoudness.end());
-    float relativeThreshold = blockLoudness[blockLoudness.size() * 0.9f] - 10.0f; // 90th percentile - 10dB
-    
-    float integratedLoudness = 0.0f;
-    int validBlocks = 0;
-    
-    for (float loudness : blockLoudness) {
-        if (loudness >= relativeThreshold) {
-            integratedLoudness += std::pow(10.0f, loudness / 10.0f);
-            validBlocks++;
-        }
-    }
-    
-    if (validBlocks == 0) return -70.0f;
-    
-    integratedLoudness /= validBlocks;
-    return -0.691f + 10.0f * std::log10(integratedLoudness);
+float LoudnessAnalyzer::calculateLUFS(const AnalysisContext& context) {
+    return calculateLUFS(context.audio());
 }
 
-float LoudnessAnalyzer::convertToDBFS(float lufs) {
-    // Convert LUFS to dBFS (approximate)
-    return lufs + 23.0f; // Rough conversion
+LoudnessMeter LoudnessAnalyzer::measure(const AnalysisContext& context) {
+    const AudioBuffer& audio = context.audio();
+    LoudnessMeter meter(audio.sampleRate);
+    meter.process(audio.samples.data(), audio.samples.size());
+    return meter;
 }
 
 // ========================================
@@ -485,10 +609,14 @@ float LoudnessAnalyzer::convertToDBFS(float lufs) {
 // ========================================
 
 float AcousticnessAnalyzer::calculateAcousticness(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+    return calculateAcousticness(AnalysisContext(audio));
+}
+
+float AcousticnessAnalyzer::calculateAcousticness(const AnalysisContext& context) {
+    const SpectralFeatures& features = context.spectrum();
     
     float harmonicContent = analyzeHarmonicContent(features);
-    float instrumentScore = detectInstruments(audio);
+    float instrumentScore = detectInstruments(context);
     float syntheticElements = calculateSyntheticElements(features);
     
     // Scoring algorithm from documentation
@@ -640,8 +768,8 @@ bool AcousticnessAnalyzer::isPeak(const std::vector<float>& magnitude, int index
     return true;
 }
 
-float AcousticnessAnalyzer::detectInstruments(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+float AcousticnessAnalyzer::detectInstruments(const AnalysisContext& context) {
+    const SpectralFeatures& features = context.spectrum();
     
     float acousticScore = 0.0f;
     
@@ -651,7 +779,7 @@ float AcousticnessAnalyzer::detectInstruments(const AudioBuffer& audio) {
     }
     
     // Check attack/decay characteristics
-    float attackDecay = calculateAttackDecayCharacteristics(audio);
+    float attackDecay = calculateAttackDecayCharacteristics(context);
     acousticScore += attackDecay * 0.4f;
     
     // Check for natural harmonics
@@ -683,20 +811,15 @@ float AcousticnessAnalyzer::calculateSyntheticElements(const SpectralFeatures& f
     return std::min(1.0f, syntheticScore);
 }
 
-float AcousticnessAnalyzer::calculateAttackDecayCharacteristics(const AudioBuffer& audio) {
+float AcousticnessAnalyzer::calculateAttackDecayCharacteristics(const AnalysisContext& context) {
     // Complete attack/decay analysis with transient detection and envelope modeling
-    const int windowSize = static_cast<int>(0.002f * audio.sampleRate); // 2ms windows for fine resolution
+    const int windowSize = static_cast<int>(0.002f * context.audio().sampleRate); // 2ms windows for fine resolution
     const int hopSize = windowSize / 4; // 75% overlap
     
     // Calculate amplitude envelope
-    std::vector<float> envelope;
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += hopSize) {
-        float rms = 0.0f;
-        for (int j = 0; j < windowSize; j++) {
-            float sample = audio.samples[i + j];
-            rms += sample * sample;
-        }
-        envelope.push_back(std::sqrt(rms / windowSize));
+    std::vector<float> envelope = context.energy().windowSums(windowSize, hopSize);
+    for (float& value : envelope) {
+        value = std::sqrt(value / windowSize);
     }
     
     if (envelope.size() < 10) return 0.5f;
@@ -914,13 +1037,16 @@ float AcousticnessAnalyzer::scoreAcousticCharacteristics(const AttackProfile& at
 // ========================================
 
 float InstrumentalnessDetector::detectInstrumentalness(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    float vocalProbability = detectVocalContent(audio);
+    return detectInstrumentalness(AnalysisContext(audio));
+}
+
+float InstrumentalnessDetector::detectInstrumentalness(const AnalysisContext& context) {
+    float vocalProbability = detectVocalContent(context);
     return 1.0f - vocalProbability;
 }
 
-float InstrumentalnessDetector::detectVocalContent(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+float InstrumentalnessDetector::detectVocalContent(const AnalysisContext& context) {
+    const SpectralFeatures& features = context.spectrum();
     std::vector<float> formants = extractFormantFrequencies(features);
     
     float vocalScore = 0.0f;
@@ -940,7 +1066,7 @@ float InstrumentalnessDetector::detectVocalContent(const AudioBuffer& audio) {
     }
     
     // Check for sustained tones
-    ChromaVector chroma = AudioProcessor::calculateChroma(audio);
+    const ChromaVector& chroma = context.chroma();
     float maxChroma = *std::max_element(chroma.chroma.begin(), chroma.chroma.end());
     if (maxChroma > 0.3f) {
         vocalScore += 0.2f; // Strong pitch suggests vocals
@@ -954,12 +1080,12 @@ std::vector<float> InstrumentalnessDetector::extractFormantFrequencies(const Spe
     
     // Simple peak picking for formant detection
     for (size_t i = 2; i < features.magnitude.size() - 2; i++) {
-        if (features.frequencies[i] > 100.0f && features.frequencies[i] < 3000.0f) {
+        if (features.frequency(i) > 100.0f && features.frequency(i) < 3000.0f) {
             if (features.magnitude[i] > features.magnitude[i-1] && 
                 features.magnitude[i] > features.magnitude[i+1] &&
                 features.magnitude[i] > features.magnitude[i-2] && 
                 features.magnitude[i] > features.magnitude[i+2]) {
-                formants.push_back(features.frequencies[i]);
+                formants.push_back(features.frequency(i));
             }
         }
     }
@@ -972,11 +1098,15 @@ std::vector<float> InstrumentalnessDetector::extractFormantFrequencies(const Spe
 // ========================================
 
 float SpeechinessDetector::detectSpeechiness(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+    return detectSpeechiness(AnalysisContext(audio));
+}
+
+float SpeechinessDetector::detectSpeechiness(const AnalysisContext& context) {
+    const SpectralFeatures& features = context.spectrum();
     
     float speechPatterns = analyzeSpeechPatterns(features);
-    float rhythmicSpeech = analyzeRhythmicSpeech(audio);
-    float consonants = detectConsonants(audio);
+    float rhythmicSpeech = analyzeRhythmicSpeech(context);
+    float consonants = detectConsonants(features);
     
     // Formula from documentation
     return speechPatterns * 0.4f + consonants * 0.3f + rhythmicSpeech * 0.3f;
@@ -1003,21 +1133,17 @@ float SpeechinessDetector::analyzeSpeechPatterns(const SpectralFeatures& feature
     return std::min(1.0f, speechScore);
 }
 
-float SpeechinessDetector::analyzeRhythmicSpeech(const AudioBuffer& audio) {
+float SpeechinessDetector::analyzeRhythmicSpeech(const AnalysisContext& context) {
     // Analyze amplitude modulation patterns typical of speech
-    int windowSize = (int)(0.02f * audio.sampleRate); // 20ms windows
-    std::vector<float> amplitudes;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize/2) {
-        float rms = AudioProcessor::calculateRMS(
-            std::vector<float>(audio.samples.begin() + i, audio.samples.begin() + i + windowSize)
-        );
-        amplitudes.push_back(rms);
+    int windowSize = (int)(0.02f * context.audio().sampleRate); // 20ms windows
+    std::vector<float> amplitudes = context.energy().windowSums(windowSize, windowSize/2);
+    for (float& amplitude : amplitudes) {
+        amplitude = std::sqrt(amplitude / windowSize);
     }
     
     // Calculate amplitude modulation rate
     int modulationCount = 0;
-    for (size_t i = 1; i < amplitudes.size(); i++) {
+    for (size_t i = 2; i < amplitudes.size(); i++) {
         if ((amplitudes[i] > amplitudes[i-1]) != (amplitudes[i-1] > amplitudes[i-2])) {
             modulationCount++;
         }
@@ -1029,9 +1155,7 @@ float SpeechinessDetector::analyzeRhythmicSpeech(const AudioBuffer& audio) {
     return (modulationRate > 0.1f && modulationRate < 0.5f) ? modulationRate * 2.0f : 0.0f;
 }
 
-float SpeechinessDetector::detectConsonants(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    
+float SpeechinessDetector::detectConsonants(const SpectralFeatures& features) {
     // Consonants have high-frequency content and rapid changes
     float consonantScore = 0.0f;
     
@@ -1047,7 +1171,7 @@ float SpeechinessDetector::detectConsonants(const AudioBuffer& audio) {
     float highFreqEnergy = 0.0f, totalEnergy = 0.0f;
     for (size_t i = 0; i < features.magnitude.size(); i++) {
         totalEnergy += features.magnitude[i];
-        if (features.frequencies[i] > 4000.0f) {
+        if (features.frequency(i) > 4000.0f) {
             highFreqEnergy += features.magnitude[i];
         }
     }
@@ -1059,47 +1183,18 @@ float SpeechinessDetector::detectConsonants(const AudioBuffer& audio) {
     return std::min(1.0f, consonantScore);
 }
 
-float SpeechinessDetector::analyzeIntonationContours(const AudioBuffer& audio) {
-    // Complete pitch tracking with YIN algorithm for accurate intonation analysis
-    const int windowSize = static_cast<int>(0.05f * audio.sampleRate); // 50ms windows
-    const int hopSize = windowSize / 4; // 75% overlap
+float SpeechinessDetector::analyzeIntonationContours(const PitchTrack& pitch) {
+    // Intonation from the shared YIN track, limited to the speaking range
     const float minFreq = 80.0f;  // Minimum speech frequency
     const float maxFreq = 400.0f; // Maximum speech frequency
     
-    std::vector<float> pitchContour;
-    std::vector<float> pitchConfidence;
+    std::vector<float> pitchContour(pitch.size(), 0.0f);
+    std::vector<float> pitchConfidence(pitch.size(), 0.0f);
     
-    // YIN algorithm implementation for pitch detection
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += hopSize) {
-        // Extract window
-        std::vector<float> window(audio.samples.begin() + i, 
-                                 audio.samples.begin() + i + windowSize);
-        
-        // Apply window function
-        for (size_t j = 0; j < window.size(); ++j) {
-            window[j] *= 0.5f * (1.0f - std::cos(2.0f * M_PI * j / (window.size() - 1)));
-        }
-        
-        // Calculate autocorrelation-based difference function
-        std::vector<float> differenceFunction = calculateYinDifferenceFunction(window);
-        
-        // Cumulative mean normalized difference
-        std::vector<float> cmndf = calculateCMNDF(differenceFunction);
-        
-        // Find pitch period
-        int tau = findPitchPeriod(cmndf, audio.sampleRate, minFreq, maxFreq);
-        
-        if (tau > 0) {
-            // Refine with parabolic interpolation
-            float refinedTau = parabolicInterpolation(differenceFunction, tau);
-            float pitch = audio.sampleRate / refinedTau;
-            float confidence = 1.0f - cmndf[tau];
-            
-            pitchContour.push_back(pitch);
-            pitchConfidence.push_back(confidence);
-        } else {
-            pitchContour.push_back(0.0f);
-            pitchConfidence.push_back(0.0f);
+    for (size_t i = 0; i < pitch.size(); ++i) {
+        if (pitch.voiced[i] && pitch.f0[i] >= minFreq && pitch.f0[i] <= maxFreq) {
+            pitchContour[i] = pitch.f0[i];
+            pitchConfidence[i] = pitch.confidence[i];
         }
     }
     
@@ -1107,81 +1202,6 @@ float SpeechinessDetector::analyzeIntonationContours(const AudioBuffer& audio) {
     return analyzeSpeechIntonation(pitchContour, pitchConfidence);
 }
 
-std::vector<float> SpeechinessDetector::calculateYinDifferenceFunction(const std::vector<float>& window) {
-    int halfSize = window.size() / 2;
-    std::vector<float> diff(halfSize, 0.0f);
-    
-    for (int tau = 1; tau < halfSize; ++tau) {
-        for (int j = 0; j < halfSize; ++j) {
-            float delta = window[j] - window[j + tau];
-            diff[tau] += delta * delta;
-        }
-    }
-    
-    return diff;
-}
-
-std::vector<float> SpeechinessDetector::calculateCMNDF(const std::vector<float>& diff) {
-    std::vector<float> cmndf(diff.size());
-    cmndf[0] = 1.0f;
-    
-    float runningSum = 0.0f;
-    for (size_t tau = 1; tau < diff.size(); ++tau) {
-        runningSum += diff[tau];
-        cmndf[tau] = runningSum > 0 ? diff[tau] * tau / runningSum : 1.0f;
-    }
-    
-    return cmndf;
-}
-
-int SpeechinessDetector::findPitchPeriod(const std::vector<float>& cmndf, 
-                                        float sampleRate, float minFreq, float maxFreq) {
-    const float threshold = 0.3f; // YIN threshold
-    
-    int minPeriod = static_cast<int>(sampleRate / maxFreq);
-    int maxPeriod = static_cast<int>(sampleRate / minFreq);
-    
-    // Find first minimum below threshold
-    for (int tau = minPeriod; tau < std::min(maxPeriod, static_cast<int>(cmndf.size())); ++tau) {
-        if (cmndf[tau] < threshold) {
-            // Check if it's a local minimum
-            if (tau > 0 && tau < static_cast<int>(cmndf.size()) - 1) {
-                if (cmndf[tau] < cmndf[tau - 1] && cmndf[tau] < cmndf[tau + 1]) {
-                    return tau;
-                }
-            }
-        }
-    }
-    
-    // If no minimum found below threshold, find absolute minimum
-    int minTau = minPeriod;
-    float minValue = cmndf[minPeriod];
-    
-    for (int tau = minPeriod + 1; tau < std::min(maxPeriod, static_cast<int>(cmndf.size())); ++tau) {
-        if (cmndf[tau] < minValue) {
-            minValue = cmndf[tau];
-            minTau = tau;
-        }
-    }
-    
-    return minValue < 0.5f ? minTau : 0; // Only return if confident enough
-}
-
-float SpeechinessDetector::parabolicInterpolation(const std::vector<float>& diff, int tau) {
-    if (tau <= 0 || tau >= static_cast<int>(diff.size()) - 1) return tau;
-    
-    float s0 = diff[tau - 1];
-    float s1 = diff[tau];
-    float s2 = diff[tau + 1];
-    
-    float a = s2 - s1;
-    float b = s0 - s1;
-    
-    if (a + b == 0) return tau;
-    
-    return tau + 0.5f * (b - a) / (a + b);
-}
-
 float SpeechinessDetector::analyzeSpeechIntonation(const std::vector<float>& pitchContour,
                                                   const std::vector<float>& confidence) {
     if (pitchContour.empty()) return 0.0f;
@@ -1294,18 +1314,22 @@ float SpeechinessDetector::analyzeProsody(const std::vector<float>& semitones) {
 // ========================================
 
 float LivenessDetector::detectLiveness(const AudioBuffer& audio) {
-    float reverbScore = analyzeReverb(audio);
-    float noiseScore = analyzeBackgroundNoise(audio);
-    float spatialScore = analyzeSpatialCharacteristics(audio);
-    float crowdScore = detectCrowdNoise(audio);
+    return detectLiveness(AnalysisContext(audio));
+}
+
+float LivenessDetector::detectLiveness(const AnalysisContext& context) {
+    float reverbScore = analyzeReverb(context);
+    float noiseScore = analyzeBackgroundNoise(context);
+    float spatialScore = analyzeSpatialCharacteristics(context);
+    float crowdScore = detectCrowdNoise(context.spectrum());
     
     // Formula from documentation
     return (reverbScore + spatialScore) * 0.4f + noiseScore * 0.4f + crowdScore * 0.2f;
 }
 
-float LivenessDetector::analyzeReverb(const AudioBuffer& audio) {
+float LivenessDetector::analyzeReverb(const AnalysisContext& context) {
     // Calculate reverb time estimate
-    float reverbTime = calculateReverbTime(audio);
+    float reverbTime = calculateReverbTime(context);
     
     // Live venues typically have longer reverb times
     if (reverbTime > 0.5f) return 0.8f;      // Concert hall
@@ -1315,15 +1339,20 @@ float LivenessDetector::analyzeReverb(const AudioBuffer& audio) {
 }
 
 float LivenessDetector::calculateReverbTime(const AudioBuffer& audio) {
+    return calculateReverbTime(AnalysisContext(audio));
+}
+
+float LivenessDetector::calculateReverbTime(const AnalysisContext& context) {
     // Complete RT60 estimation using Schroeder backward integration method
+    const AudioBuffer& audio = context.audio();
     const int windowSize = static_cast<int>(0.005f * audio.sampleRate); // 5ms for fine resolution
     const int hopSize = windowSize / 2; // 50% overlap
     
     // Step 1: Detect impulse-like events in the signal
-    std::vector<int> impulseIndices = detectImpulses(audio);
+    std::vector<int> impulseIndices = detectImpulses(context);
     if (impulseIndices.empty()) {
         // No clear impulses, estimate from overall decay
-        return estimateRT60FromDecay(audio);
+        return estimateRT60FromDecay(context);
     }
     
     // Step 2: For each impulse, calculate the decay curve
@@ -1336,11 +1365,8 @@ float LivenessDetector::calculateReverbTime(const AudioBuffer& audio) {
         int startIdx = impulseIdx;
         int endIdx = std::min(impulseIdx + audio.sampleRate * 2, (int)audio.samples.size());
         
-        std::vector<float> decaySegment(audio.samples.begin() + startIdx, 
-                                       audio.samples.begin() + endIdx);
-        
         // Calculate energy decay curve
-        std::vector<float> energyCurve = calculateEnergyCurve(decaySegment, windowSize, hopSize);
+        std::vector<float> energyCurve = context.energy().windowSums(windowSize, hopSize, startIdx, endIdx - startIdx);
         
         // Apply Schroeder backward integration
         std::vector<float> schroederCurve = schroederBackwardIntegration(energyCurve);
@@ -1354,7 +1380,7 @@ float LivenessDetector::calculateReverbTime(const AudioBuffer& audio) {
     }
     
     if (rt60Estimates.empty()) {
-        return estimateRT60FromDecay(audio);
+        return estimateRT60FromDecay(context);
     }
     
     // Return median of estimates
@@ -1362,18 +1388,15 @@ float LivenessDetector::calculateReverbTime(const AudioBuffer& audio) {
     return rt60Estimates[rt60Estimates.size() / 2];
 }
 
-std::vector<int> LivenessDetector::detectImpulses(const AudioBuffer& audio) {
+std::vector<int> LivenessDetector::detectImpulses(const AnalysisContext& context) {
+    const AudioBuffer& audio = context.audio();
     std::vector<int> impulses;
     const int windowSize = static_cast<int>(0.01f * audio.sampleRate); // 10ms
     
     // Calculate short-term energy
-    std::vector<float> energy;
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize/2) {
-        float e = 0.0f;
-        for (int j = 0; j < windowSize; ++j) {
-            e += audio.samples[i+j] * audio.samples[i+j];
-        }
-        energy.push_back(e / windowSize);
+    std::vector<float> energy = context.energy().windowSums(windowSize, windowSize/2);
+    for (float& e : energy) {
+        e /= windowSize;
     }
     
     if (energy.size() < 3) return impulses;
@@ -1399,21 +1422,6 @@ std::vector<int> LivenessDetector::detectImpulses(const AudioBuffer& audio) {
     return impulses;
 }
 
-std::vector<float> LivenessDetector::calculateEnergyCurve(const std::vector<float>& signal,
-                                                         int windowSize, int hopSize) {
-    std::vector<float> energy;
-    
-    for (int i = 0; i <= (int)signal.size() - windowSize; i += hopSize) {
-        float e = 0.0f;
-        for (int j = 0; j < windowSize; ++j) {
-            e += signal[i+j] * signal[i+j];
-        }
-        energy.push_back(e);
-    }
-    
-    return energy;
-}
-
 std::vector<float> LivenessDetector::schroederBackwardIntegration(const std::vector<float>& energy) {
     std::vector<float> schroeder(energy.size());
     
@@ -1480,17 +1488,12 @@ float LivenessDetector::fitRT60(const std::vector<float>& schroederCurve, float
     return std::max(0.05f, std::min(10.0f, rt60)); // Clamp to reasonable range
 }
 
-float LivenessDetector::estimateRT60FromDecay(const AudioBuffer& audio) {
+float LivenessDetector::estimateRT60FromDecay(const AnalysisContext& context) {
     // Fallback method using overall energy decay
-    const int blockSize = static_cast<int>(0.1f * audio.sampleRate); // 100ms blocks
-    std::vector<float> blockEnergy;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - blockSize; i += blockSize) {
-        float energy = 0.0f;
-        for (int j = 0; j < blockSize; ++j) {
-            energy += audio.samples[i+j] * audio.samples[i+j];
-        }
-        blockEnergy.push_back(10.0f * std::log10(energy / blockSize + 1e-10f));
+    const int blockSize = static_cast<int>(0.1f * context.audio().sampleRate); // 100ms blocks
+    std::vector<float> blockEnergy = context.energy().windowSums(blockSize, blockSize);
+    for (float& energy : blockEnergy) {
+        energy = 10.0f * std::log10(energy / blockSize + 1e-10f);
     }
     
     if (blockEnergy.size() < 5) return 0.1f;
@@ -1522,15 +1525,13 @@ float LivenessDetector::estimateRT60FromDecay(const AudioBuffer& audio) {
     return std::max(0.05f, std::min(2.0f, rt60));
 }
 
-float LivenessDetector::analyzeBackgroundNoise(const AudioBuffer& audio) {
+float LivenessDetector::analyzeBackgroundNoise(const AnalysisContext& context) {
     // Find quiet sections and analyze their noise characteristics
-    int windowSize = (int)(0.1f * audio.sampleRate); // 100ms
+    int windowSize = (int)(0.1f * context.audio().sampleRate); // 100ms
     std::vector<float> noiseEstimates;
     
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize) {
-        float rms = AudioProcessor::calculateRMS(
-            std::vector<float>(audio.samples.begin() + i, audio.samples.begin() + i + windowSize)
-        );
+    for (float energy : context.energy().windowSums(windowSize, windowSize)) {
+        float rms = std::sqrt(energy / windowSize);
         if (rms < 0.1f) { // Quiet section
             noiseEstimates.push_back(rms);
         }
@@ -1547,8 +1548,9 @@ float LivenessDetector::analyzeBackgroundNoise(const AudioBuffer& audio) {
     return 0.1f;
 }
 
-float LivenessDetector::analyzeSpatialCharacteristics(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+float LivenessDetector::analyzeSpatialCharacteristics(const AnalysisContext& context) {
+    const AudioBuffer& audio = context.audio();
+    const SpectralFeatures& features = context.spectrum();
     
     float spatialScore = 0.0f;
     
@@ -1572,10 +1574,8 @@ float LivenessDetector::analyzeSpatialCharacteristics(const AudioBuffer& audio)
     return std::min(1.0f, spatialScore);
 }
 
-float LivenessDetector::detectCrowdNoise(const AudioBuffer& audio) {
+float LivenessDetector::detectCrowdNoise(const SpectralFeatures& features) {
     // Look for characteristics of crowd noise
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    
     float crowdScore = 0.0f;
     
     // Crowd noise has specific spectral characteristics
@@ -1602,11 +1602,13 @@ float LivenessDetector::detectCrowdNoise(const AudioBuffer& audio) {
 // ========================================
 
 float EnergyAnalyzer::calculateEnergy(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    
-    float loudnessEnergy = calculateLoudnessEnergy(audio);
-    float spectralEnergy = calculateSpectralEnergy(features);
-    float rhythmicEnergy = calculateRhythmicEnergy(audio);
+    return calculateEnergy(AnalysisContext(audio));
+}
+
+float EnergyAnalyzer::calculateEnergy(const AnalysisContext& context) {
+    float loudnessEnergy = calculateLoudnessEnergy(context.audio());
+    float spectralEnergy = calculateSpectralEnergy(context.spectrum());
+    float rhythmicEnergy = calculateRhythmicEnergy(context);
     
     // Formula from documentation
     return loudnessEnergy * 0.3f + spectralEnergy * 0.3f + rhythmicEnergy * 0.4f;
@@ -1631,7 +1633,7 @@ float EnergyAnalyzer::calculateSpectralEnergy(const SpectralFeatures& features)
     float highFreqEnergy = 0.0f, totalEnergy = 0.0f;
     for (size_t i = 0; i < features.magnitude.size(); i++) {
         totalEnergy += features.magnitude[i];
-        if (features.frequencies[i] > 2000.0f) {
+        if (features.frequency(i) > 2000.0f) {
             highFreqEnergy += features.magnitude[i];
         }
     }
@@ -1651,14 +1653,14 @@ float EnergyAnalyzer::calculateSpectralEnergy(const SpectralFeatures& features)
     return std::min(1.0f, spectralEnergy);
 }
 
-float EnergyAnalyzer::calculateRhythmicEnergy(const AudioBuffer& audio) {
-    BPMDetector bpmDetector;
-    OnsetVector onsets = bpmDetector.detectOnsets(audio);
+float EnergyAnalyzer::calculateRhythmicEnergy(const AnalysisContext& context) {
+    const OnsetVector& onsets = context.onsets();
     
     float onsetDensity = calculateOnsetDensity(onsets);
-    float dynamicRange = analyzeDynamicRange(audio);
+    float tempoEnergy = calculateTempoEnergy(context.bpm());
+    float dynamicRange = analyzeDynamicRange(context);
     
-    return std::min(1.0f, onsetDensity * 0.6f + dynamicRange * 0.4f);
+    return std::min(1.0f, onsetDensity * 0.4f + tempoEnergy * 0.2f + dynamicRange * 0.4f);
 }
 
 float EnergyAnalyzer::calculateOnsetDensity(const OnsetVector& onsets) {
@@ -1678,16 +1680,26 @@ float EnergyAnalyzer::calculateOnsetDensity(const OnsetVector& onsets) {
     return 0.1f;                           // Very low energy
 }
 
+float EnergyAnalyzer::calculateTempoEnergy(float bpm) {
+    // Faster beat grids feel more energetic
+    if (bpm > 160.0f) return 1.0f;
+    if (bpm > 135.0f) return 0.8f;
+    if (bpm > 115.0f) return 0.6f;
+    if (bpm > 95.0f) return 0.4f;
+    if (bpm > 75.0f) return 0.2f;
+    return 0.1f;
+}
+
 float EnergyAnalyzer::analyzeDynamicRange(const AudioBuffer& audio) {
+    return analyzeDynamicRange(AnalysisContext(audio));
+}
+
+float EnergyAnalyzer::analyzeDynamicRange(const AnalysisContext& context) {
     // Calculate dynamic range as contributing factor to energy
-    int windowSize = (int)(0.1f * audio.sampleRate); // 100ms windows
-    std::vector<float> rmsValues;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize) {
-        float rms = AudioProcessor::calculateRMS(
-            std::vector<float>(audio.samples.begin() + i, audio.samples.begin() + i + windowSize)
-        );
-        rmsValues.push_back(rms);
+    int windowSize = (int)(0.1f * context.audio().sampleRate); // 100ms windows
+    std::vector<float> rmsValues = context.energy().windowSums(windowSize, windowSize);
+    for (float& rms : rmsValues) {
+        rms = std::sqrt(rms / windowSize);
     }
     
     if (rmsValues.empty()) return 0.0f;
@@ -2441,8 +2453,7 @@ float ConfidenceCalculator::calculateSNR(const AudioBuffer& audio) {
     float minRMS = signal;
     
     for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize) {
-        std::vector<float> window(audio.samples.begin() + i, audio.samples.begin() + i + windowSize);
-        float windowRMS = AudioProcessor::calculateRMS(window);
+        float windowRMS = AudioProcessor::calculateRMS(audio.samples.subspan(i, windowSize));
         if (windowRMS < minRMS) minRMS = windowRMS;
     }
     
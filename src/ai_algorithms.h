@@ -9,31 +9,203 @@
 #include <cmath>
 #include <memory>
 #include <sstream>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <exception>
+#include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <unordered_map>
 
 namespace MusicAnalysis {
 
+// ========================================
+// 🚀 SIMD KERNELS
+// ========================================
+
+// Sums over one magnitude spectrum that its shape descriptors are built from;
+// k is the bin index and m the magnitude, floored at VectorKernels::LOG_FLOOR inside logs
+struct SpectralMoments {
+    float magnitude = 0.0f;             // Σ m
+    float indexWeighted = 0.0f;         // Σ k m
+    float indexSquaredWeighted = 0.0f;  // Σ k² m
+    float power = 0.0f;                 // Σ m²
+    float logMagnitude = 0.0f;          // Σ ln m
+    float powerLogMagnitude = 0.0f;     // Σ m² ln m
+};
+
+// Vectorized float reductions for the hot loops. The widest instruction set the
+// CPU supports (AVX-512, AVX2 + FMA, SSE) is picked once at first use; other
+// architectures use the scalar versions.
+class VectorKernels {
+public:
+    static float sumOfSquares(const float* data, size_t count);
+    static float dot(const float* a, const float* b, size_t count);
+    static float maxValue(const float* data, size_t count);   // -inf when empty
+    static float minValue(const float* data, size_t count);   // +inf when empty
+    // Sum of max(a[i] - b[i], 0), e.g. half-wave rectified spectral flux
+    static float positiveDifferenceSum(const float* a, const float* b, size_t count);
+    // output[i] = |input[i]|
+    static void complexMagnitude(const std::complex<float>* input, float* output, size_t count);
+    // All moments in one pass; logs use a polynomial approximation (~1e-7 relative error)
+    static SpectralMoments spectralMoments(const float* magnitude, size_t count);
+    // distances[i] = Σ_d weights[d] (columns[d][i] - query[d])², for up to MAX_DIMENSIONS columns
+    static void weightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                         const float* weights, float* distances, size_t count);
+
+    // The same over columns of unsigned codes, codeBytes 1 (uint8_t) or 2 (uint16_t) wide;
+    // query is in code units
+    static void quantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions,
+                                          const float* query, const float* weights, float* distances,
+                                          size_t count);
+
+    static constexpr int MAX_DIMENSIONS = 16;
+
+    static constexpr float LOG_FLOOR = 1e-10f;
+
+    // "avx512", "avx2", "sse" or "scalar"
+    static const char* instructionSet();
+    // Every set this CPU can run, widest first, ending with "scalar"
+    static std::vector<std::string> supportedInstructionSets();
+    // For tests: dispatch to the named set from now on; false if the CPU lacks it.
+    // Not synchronized with kernels running on other threads.
+    static bool useInstructionSet(const std::string& name);
+};
+
+// Allocator for vectors that SIMD kernels stream through: storage starts on a
+// cache line, so no vector load splits one
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* pointer, size_t) {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+using AlignedFloats = std::vector<float, AlignedAllocator<float>>;
+
+// The k smallest distances offered, as a bounded max-heap: n offers cost O(n log k)
+// and anything beyond bound() is rejected with one compare. Index identifies the
+// candidate; NearestSelection uses row numbers.
+template <typename Index>
+class BasicNearestSelection {
+public:
+    explicit BasicNearestSelection(size_t k, float radius = std::numeric_limits<float>::infinity())
+        : k(k), radius(radius) {
+        heap.reserve(k);
+    }
+
+    float bound() const {
+        if (k == 0) return -std::numeric_limits<float>::infinity();
+        return heap.size() < k ? radius : std::min(radius, heap.front().first);
+    }
+
+    void offer(float distance, Index index) {
+        if (distance > bound()) return;
+        if (heap.size() == k) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+        heap.emplace_back(distance, index);
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    // (distance, index), nearest first; leaves the selection empty
+    std::vector<std::pair<float, Index>> take() {
+        std::sort_heap(heap.begin(), heap.end());
+        return std::move(heap);
+    }
+
+private:
+    size_t k;
+    float radius;
+    std::vector<std::pair<float, Index>> heap;
+};
+
+using NearestSelection = BasicNearestSelection<size_t>;
+
 // ========================================
 // 🎵 CORE DATA STRUCTURES
 // ========================================
 
+// Non-owning, read-only view of contiguous samples (caller memory or a vector)
+class SampleSpan {
+public:
+    SampleSpan() = default;
+    SampleSpan(const float* data, size_t size) : ptr(data), count(size) {}
+    SampleSpan(const std::vector<float>& data) : ptr(data.data()), count(data.size()) {}
+
+    const float* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const float& operator[](size_t i) const { return ptr[i]; }
+    const float* begin() const { return ptr; }
+    const float* end() const { return ptr + count; }
+
+    // Clamped to the span, so a window past the end is simply shorter
+    SampleSpan subspan(size_t offset, size_t size) const {
+        offset = std::min(offset, count);
+        return SampleSpan(ptr + offset, std::min(size, count - offset));
+    }
+
+private:
+    const float* ptr = nullptr;
+    size_t count = 0;
+};
+
+// Mono audio handed to every analyzer. Either owns its samples (shared between
+// copies, never mutated) or views memory the caller keeps alive for the analysis.
 struct AudioBuffer {
-    std::vector<float> samples;
+private:
+    // Declared first: the owning constructors point samples into it
+    std::shared_ptr<const std::vector<float>> storage;
+
+public:
+    SampleSpan samples;
     int sampleRate;
     int channels;
     int length;
     
-    AudioBuffer(const std::vector<float>& data, int sr, int ch) 
-        : samples(data), sampleRate(sr), channels(ch), length(data.size()) {}
+    AudioBuffer(const std::vector<float>& data, int sr, int ch)
+        : AudioBuffer(std::vector<float>(data), sr, ch) {}
+    AudioBuffer(std::vector<float>&& data, int sr, int ch)
+        : storage(std::make_shared<const std::vector<float>>(std::move(data))),
+          samples(*storage), sampleRate(sr), channels(ch), length(static_cast<int>(samples.size())) {}
+    // Zero-copy view; data must outlive the buffer and every copy of it
+    AudioBuffer(const float* data, size_t size, int sr, int ch)
+        : samples(data, size), sampleRate(sr), channels(ch), length(static_cast<int>(size)) {}
+
+    bool ownsSamples() const { return storage != nullptr; }
 };
 
 struct SpectralFeatures {
     std::vector<float> magnitude;
     std::vector<float> phase;
-    std::vector<float> frequencies;
     float spectralCentroid;
     float spectralRolloff;
     float zeroCrossingRate;
     int sampleRate;  // Added for complete implementations
+    
+    // Bins run from 0 Hz to Nyquist
+    float binWidth() const { return magnitude.size() > 1 ? sampleRate / (2.0f * (magnitude.size() - 1)) : 0.0f; }
+    float frequency(size_t bin) const { return bin * binWidth(); }
 };
 
 struct ChromaVector {
@@ -51,6 +223,22 @@ struct BeatVector {
     std::vector<float> beatStrengths;
 };
 
+// A stretch of the track in one key
+struct KeySegment {
+    float startTime = 0.0f;   // Seconds
+    float endTime = 0.0f;
+    std::string key;          // e.g. "A minor"
+    float confidence = 0.0f;  // Share of frames in the segment whose own best key agrees
+};
+
+// EBU R128 loudness every INTERVAL seconds; entry i is the window ending at
+// 0.4 s + i * INTERVAL
+struct LoudnessTimeline {
+    static constexpr float INTERVAL = 0.1f;
+    std::vector<float> momentary;  // 400 ms windows, LUFS
+    std::vector<float> shortTerm;  // 3 s windows (the track so far during the first 3 s), LUFS
+};
+
 // ========================================
 // 🎯 HAMMS - Harmonic And Melodic Music Similarity
 // ========================================
@@ -66,14 +254,16 @@ struct HAMMSVector {
     
     // Calculate similarity between two HAMMS vectors
     float calculateSimilarity(const HAMMSVector& other) const {
-        float diff = 0.0f;
-        diff += std::pow(harmonicity - other.harmonicity, 2);
-        diff += std::pow(melodicity - other.melodicity, 2);
-        diff += std::pow(rhythmicity - other.rhythmicity, 2);
-        diff += std::pow(timbrality - other.timbrality, 2);
-        diff += std::pow(dynamics - other.dynamics, 2);
-        diff += std::pow(tonality - other.tonality, 2);
-        diff += std::pow(temporality - other.temporality, 2);
+        const float delta[7] = {
+            harmonicity - other.harmonicity,
+            melodicity - other.melodicity,
+            rhythmicity - other.rhythmicity,
+            timbrality - other.timbrality,
+            dynamics - other.dynamics,
+            tonality - other.tonality,
+            temporality - other.temporality
+        };
+        float diff = VectorKernels::sumOfSquares(delta, 7);
         
         // Return similarity score (1 = identical, 0 = completely different)
         return 1.0f - std::sqrt(diff / 7.0f);
@@ -95,7 +285,97 @@ struct HAMMSVector {
     }
 };
 
+struct BatchMatch {
+    size_t index;       // Position in the batch
+    float similarity;
+};
+
+// Many HAMMS vectors as seven aligned float columns, scored against one query at a
+// time by the vector kernels. Weights scale each dimension's squared difference; with
+// unit weights (nullptr) scores equal HAMMSVector::calculateSimilarity.
+class HAMMSBatch {
+public:
+    static constexpr int DIMENSIONS = 7;
+
+    void reserve(size_t count);
+    void add(const HAMMSVector& vector);
+    void clear();
+    size_t size() const { return columns[0].size(); }
+    HAMMSVector at(size_t index) const;
+    const float* column(int dimension) const { return columns[dimension].data(); }
+
+    // similarities[i] for every vector in the batch
+    void similarities(const HAMMSVector& query, float* similarities, const float* weights = nullptr) const;
+    // The k most similar, most similar first
+    std::vector<BatchMatch> mostSimilar(const HAMMSVector& query, size_t k, const float* weights = nullptr) const;
+
+    static void toArray(const HAMMSVector& vector, float* values);
+
+private:
+    AlignedFloats columns[DIMENSIONS];
+};
+
+// ========================================
+// 🎛️ FIELD SELECTION
+// ========================================
+
+// One bit per result field; a mask selects which analyzers run
+using FieldMask = uint32_t;
+
+enum AnalysisField : FieldMask {
+    FIELD_ACOUSTICNESS      = 1u << 0,
+    FIELD_BPM               = 1u << 1,
+    FIELD_CHARACTERISTICS   = 1u << 2,
+    FIELD_CONFIDENCE        = 1u << 3,
+    FIELD_CULTURAL_CONTEXT  = 1u << 4,
+    FIELD_DANCEABILITY      = 1u << 5,
+    FIELD_ENERGY            = 1u << 6,
+    FIELD_ERA               = 1u << 7,
+    FIELD_INSTRUMENTALNESS  = 1u << 8,
+    FIELD_KEY               = 1u << 9,
+    FIELD_LIVENESS          = 1u << 10,
+    FIELD_LOUDNESS          = 1u << 11,
+    FIELD_MODE              = 1u << 12,
+    FIELD_MOOD              = 1u << 13,
+    FIELD_OCCASION          = 1u << 14,
+    FIELD_SPEECHINESS       = 1u << 15,
+    FIELD_SUBGENRES         = 1u << 16,
+    FIELD_TIME_SIGNATURE    = 1u << 17,
+    FIELD_VALENCE           = 1u << 18,
+    FIELD_HAMMS             = 1u << 19,
+
+    FIELD_ALL               = (1u << 20) - 1
+};
+
+// Shared features an AnalysisContext can precompute
+enum ContextFeature : uint32_t {
+    FEATURE_SPECTRUM        = 1u << 0,   // Whole-track FFT
+    FEATURE_CHROMA          = 1u << 1,   // Needs the spectrum
+    FEATURE_STFT            = 1u << 2,
+    FEATURE_ONSET_ENVELOPE  = 1u << 3,   // Needs the STFT
+    FEATURE_PITCH           = 1u << 4,   // Per-frame f0 track
+    FEATURE_CHROMAGRAM      = 1u << 5,   // Per-frame pitch-class energy
+    FEATURE_ENERGY          = 1u << 6,   // Prefix sums of squared samples
+    FEATURE_DESCRIPTORS     = 1u << 7,   // Per-frame spectral shape, needs the STFT
+
+    FEATURE_ALL             = (1u << 8) - 1
+};
+
+class FieldSelection {
+public:
+    // Maps "AI_BPM"-style names to a mask; an empty list selects every field
+    static FieldMask parse(const std::vector<std::string>& names);
+
+    // Adds every field the selected fields read from the result (transitively)
+    static FieldMask withDependencies(FieldMask fields);
+
+    // Context features the selected analyzers need (call on a resolved mask)
+    static uint32_t requiredFeatures(FieldMask fields);
+};
+
 struct AIAnalysisResult {
+    FieldMask analyzedFields = 0;  // Fields below that were actually computed
+
     // Core AI_* fields
     float AI_ACOUSTICNESS = 0.0f;
     bool AI_ANALYZED = false;
@@ -108,8 +388,12 @@ struct AIAnalysisResult {
     std::string AI_ERA;
     float AI_INSTRUMENTALNESS = 0.0f;
     std::string AI_KEY;
+    std::vector<KeySegment> KEY_TIMELINE;  // Key changes over time, filled with AI_KEY
     float AI_LIVENESS = 0.0f;
     float AI_LOUDNESS = 0.0f;
+    float LOUDNESS_RANGE = 0.0f;           // LU, filled with AI_LOUDNESS
+    float TRUE_PEAK = 0.0f;                // dBTP, filled with AI_LOUDNESS
+    LoudnessTimeline LOUDNESS_TIMELINE;    // Filled with AI_LOUDNESS
     std::string AI_MODE;
     std::string AI_MOOD;
     std::vector<std::string> AI_OCCASION;
@@ -126,17 +410,320 @@ struct AIAnalysisResult {
 // 🔊 CORE AUDIO PROCESSING
 // ========================================
 
+// Framed STFT magnitudes, stored frames × bins (row-major)
+struct STFTFrames {
+    std::vector<float> magnitudes;
+    int frameSize = 0;
+    int hopSize = 0;
+    int numFrames = 0;
+    int numBins = 0;
+    
+    const float* frame(int index) const { return magnitudes.data() + static_cast<size_t>(index) * numBins; }
+};
+
+// Pitch-class energy per STFT frame, stored frames × 12 (row-major, not normalized)
+struct Chromagram {
+    std::vector<float> values;
+    int frameSize = 0;
+    int hopSize = 0;
+    int numFrames = 0;
+    int sampleRate = 0;
+    
+    const float* frame(int index) const { return values.data() + static_cast<size_t>(index) * 12; }
+};
+
+// Cumulative sum of squared samples, so the energy of any window costs O(1)
+// whatever its size or hop. Totals are kept in double once per block plus a
+// float offset within the block: precise on long tracks at ~4 bytes per sample.
+class EnergyPrefixSum {
+public:
+    EnergyPrefixSum() : EnergyPrefixSum(SampleSpan()) {}
+    explicit EnergyPrefixSum(SampleSpan samples);
+    
+    size_t size() const { return count; }
+    
+    // Over [start, start + length), clamped to the signal
+    float sum(size_t start, size_t length) const;
+    float meanSquare(size_t start, size_t length) const;
+    float rms(size_t start, size_t length) const { return std::sqrt(meanSquare(start, length)); }
+    
+    // sum() of every full window at start, start + hopSize, ... within [start, start + length)
+    std::vector<float> windowSums(size_t windowSize, size_t hopSize,
+                                  size_t start = 0, size_t length = SIZE_MAX) const;
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64;
+    
+    double cumulative(size_t index) const { return blocks[index / BLOCK_SIZE] + offsets[index]; }
+    
+    size_t count = 0;
+    std::vector<double> blocks;   // Energy before each block
+    std::vector<float> offsets;   // Energy from the block start to each index (count + 1 entries)
+};
+
+// YIN difference function d(tau) = E(0) + E(tau) - 2 r(tau) for tau < windowSize / 2,
+// with the cross-correlation r from one FFT round trip: O(W log W) instead of O(W²).
+// Transform buffers and plans are allocated once and reused for every frame.
+class YinDifference {
+public:
+    explicit YinDifference(int windowSize);
+    ~YinDifference();
+    
+    YinDifference(const YinDifference&) = delete;
+    YinDifference& operator=(const YinDifference&) = delete;
+    
+    // window must hold windowSize samples; the result stays valid until the next call
+    const std::vector<float>& compute(SampleSpan window);
+    
+private:
+    struct State;
+    std::unique_ptr<State> state;
+};
+
+// Linear autocorrelation r(tau) = sum x[j] x[j + tau] for tau <= maxLag, from one
+// FFT round trip of the zero-padded window. Buffers and plans are reused.
+class FFTAutocorrelation {
+public:
+    FFTAutocorrelation(int windowSize, int maxLag);
+    ~FFTAutocorrelation();
+    
+    FFTAutocorrelation(const FFTAutocorrelation&) = delete;
+    FFTAutocorrelation& operator=(const FFTAutocorrelation&) = delete;
+    
+    // Uses up to windowSize samples; the result stays valid until the next call
+    const std::vector<float>& compute(SampleSpan window);
+    
+private:
+    struct State;
+    std::unique_ptr<State> state;
+};
+
 class AudioProcessor {
 public:
-    static AudioBuffer preprocessAudio(const std::vector<float>& rawAudio, int sampleRate);
-    static std::vector<std::complex<float>> calculateFFT(const std::vector<float>& signal);
+    static AudioBuffer preprocessAudio(SampleSpan rawAudio, int sampleRate);
+    static std::vector<std::complex<float>> calculateFFT(SampleSpan signal);
     static SpectralFeatures calculateSpectralFeatures(const AudioBuffer& audio);
     static ChromaVector calculateChroma(const AudioBuffer& audio);
-    static float calculateRMS(const std::vector<float>& signal);
+    static ChromaVector calculateChroma(const SpectralFeatures& features);
+    static ChromaVector calculateChroma(const float* magnitude, int numBins, int sampleRate);  // One STFT frame
+    static Chromagram calculateChromagram(SampleSpan signal, int sampleRate, int frameSize, int hopSize);
+    static STFTFrames calculateSTFT(SampleSpan signal, int frameSize, int hopSize);
+    static void calculateSpectralShape(SpectralFeatures& features);  // Centroid and rolloff from magnitude
+    static float calculateRMS(SampleSpan signal);
+    
+    // Optional FFTW wisdom file: known sizes reuse measured plans, new sizes are measured once
+    static bool enableFFTWisdom(const std::string& path);
+    static bool saveFFTWisdom(const std::string& path);
+    
+private:
+    static std::vector<float> applyWindow(SampleSpan signal, int windowType = 0);
+    static std::vector<float> normalize(SampleSpan signal);
+};
+
+// ========================================
+// 🎤 PITCH TRACKING
+// ========================================
+
+// Monophonic f0 per frame; unvoiced frames have f0 = 0 and confidence = 0
+struct PitchTrack {
+    int frameSize = 0;
+    int hopSize = 0;
+    int sampleRate = 0;
+    std::vector<float> f0;          // Hz
+    std::vector<float> confidence;  // 1 - CMNDF at the chosen period
+    std::vector<uint8_t> voiced;
+    
+    size_t size() const { return f0.size(); }
+    float frameTime(size_t index) const { return static_cast<float>(index * hopSize) / sampleRate; }
+};
+
+// YIN over 50 ms Hann frames every 12.5 ms, searching MIN_FREQUENCY..MAX_FREQUENCY
+class PitchTracker {
+public:
+    static constexpr float MIN_FREQUENCY = 60.0f;
+    static constexpr float MAX_FREQUENCY = 1000.0f;
+    static constexpr float YIN_THRESHOLD = 0.3f;   // First dip below this wins
+    static constexpr float VOICING_LIMIT = 0.5f;   // Otherwise the global minimum must beat this
+    
+    static PitchTrack track(SampleSpan samples, int sampleRate);
+    
+    // Cumulative mean normalized difference d'(tau) of a YIN difference function
+    static void calculateCMNDF(const std::vector<float>& diff, std::vector<float>& cmndf);
+    
+private:
+    static int findPitchPeriod(const std::vector<float>& cmndf, int minPeriod, int maxPeriod);
+    static float parabolicInterpolation(const std::vector<float>& diff, int tau);
+};
+
+// ========================================
+// 🎨 SPECTRAL DESCRIPTORS
+// ========================================
+
+struct DescriptorSummary {
+    float mean = 0.0f;
+    float deviation = 0.0f;  // Standard deviation over frames
+};
+
+// Spectral shape of every STFT frame, plus whole-track summaries over the
+// frames that carry any signal
+struct SpectralDescriptors {
+    int sampleRate = 0;
+    int hopSize = 0;
+    std::vector<float> centroid;   // Hz
+    std::vector<float> rolloff;    // Hz below which ROLLOFF_FRACTION of the power lies
+    std::vector<float> flatness;   // Geometric over arithmetic mean magnitude (0-1)
+    std::vector<float> entropy;    // Of the power distribution over bins, normalized (0-1)
+    std::vector<float> flux;       // Half-wave rectified magnitude increase since the previous frame
+    std::vector<float> bandwidth;  // Hz, magnitude-weighted spread around the centroid
+    
+    DescriptorSummary centroidSummary, rolloffSummary, flatnessSummary;
+    DescriptorSummary entropySummary, fluxSummary, bandwidthSummary;
+    
+    size_t size() const { return centroid.size(); }
+    float frameTime(size_t index) const { return static_cast<float>(index * hopSize) / sampleRate; }
+};
+
+// One pass over each frame: the fused moments kernel gives everything but the
+// rolloff, which scans the power in blocks up to its threshold
+class SpectralDescriptorExtractor {
+public:
+    static constexpr float ROLLOFF_FRACTION = 0.85f;
+    
+    static SpectralDescriptors extract(const STFTFrames& frames, int sampleRate);
+    
+    // First bin where the cumulative power reaches ROLLOFF_FRACTION of totalPower (0 if none)
+    static size_t rolloffBin(const float* magnitude, size_t count, float totalPower);
     
 private:
-    static std::vector<float> applyWindow(const std::vector<float>& signal, int windowType = 0);
-    static std::vector<float> normalize(const std::vector<float>& signal);
+    static DescriptorSummary summarize(const std::vector<float>& values, const std::vector<uint8_t>& active);
+};
+
+// ========================================
+// 🥁 BEAT TRACKING
+// ========================================
+
+// Tempo and beat grid of one track, from the onset envelope
+struct BeatTrack {
+    float bpm = 0.0f;               // Fractional
+    BeatVector beats;               // Onset envelope value at each beat as its strength
+    std::vector<float> tempoCurve;  // Local BPM per tempogram window
+    float curveInterval = 0.0f;     // Seconds between tempo curve points
+};
+
+// Tempogram: autocorrelation of the onset envelope over TEMPOGRAM_SECONDS
+// windows every TEMPOGRAM_HOP_SECONDS. The summed tempogram under a log-normal
+// prior gives the global tempo, each window the local tempo near it, and beats
+// are aligned to the local period by dynamic programming (Ellis 2007).
+class BeatTracker {
+public:
+    static constexpr float MIN_BPM = 60.0f;
+    static constexpr float MAX_BPM = 200.0f;
+    static constexpr float PRIOR_BPM = 120.0f;        // Also the tempo of a track without rhythm
+    static constexpr float PRIOR_OCTAVES = 1.0f;      // Standard deviation of the prior
+    static constexpr float TEMPOGRAM_SECONDS = 8.0f;
+    static constexpr float TEMPOGRAM_HOP_SECONDS = 2.0f;
+    static constexpr float LOCAL_TEMPO_RANGE = 1.2f;  // Local tempo stays within this factor of the global one
+    static constexpr float TIGHTNESS = 100.0f;        // Penalty on beat intervals that stray from the period
+    
+    // onsetEnvelope holds one value per AnalysisContext::HOP_SIZE samples
+    static BeatTrack track(const std::vector<float>& onsetEnvelope, int sampleRate);
+    
+    // Global tempo fed onset envelope values as they arrive, holding one window;
+    // gives the same bpm as track() on the same envelope
+    class TempoEstimator {
+    public:
+        explicit TempoEstimator(int sampleRate, bool keepWindows = false);
+        
+        void add(const float* envelope, size_t count);
+        float bpm();  // Call once every value is in
+        
+        // Normalized autocorrelation of every window, when kept
+        const std::vector<std::vector<float>>& windows() const { return kept; }
+        
+    private:
+        void addWindow(const std::vector<float>& window);
+        
+        float frameRate;
+        int windowSize;
+        int hopSize;
+        int maxLag;
+        bool keepWindows;
+        bool finished = false;
+        std::vector<float> pending;   // The current window, filling up
+        std::vector<float> summed;    // Tempogram summed over windows
+        size_t windowCount = 0;
+        std::vector<std::vector<float>> kept;
+        std::unique_ptr<FFTAutocorrelation> autocorrelation;
+    };
+    
+private:
+    // Strongest tempo in an autocorrelation within lags [minLag, maxLag], weighted by the prior
+    static float pickTempo(const std::vector<float>& acf, float frameRate, float minBPM, float maxBPM,
+                           bool usePrior);
+    // Beat frames maximizing onset strength minus the tempo deviation penalty; periods in frames
+    static std::vector<int> alignBeats(const std::vector<float>& envelope, const std::vector<float>& periods);
+};
+
+// ========================================
+// 🧠 SHARED ANALYSIS CONTEXT
+// ========================================
+
+// Per-track features shared by every analyzer. Each one is computed on first use,
+// at most once, and accessors are safe to call from parallel analyzers.
+class AnalysisContext {
+public:
+    static constexpr int FRAME_SIZE = 1024;
+    static constexpr int HOP_SIZE = 512;
+    static constexpr int CHROMA_FRAME_SIZE = 8192;  // ~5 Hz bins resolve semitones from 80 Hz up
+    static constexpr int CHROMA_HOP_SIZE = 4096;
+    
+    // Only the requested features (plus what they are derived from) may be used
+    explicit AnalysisContext(const AudioBuffer& audio, uint32_t features = FEATURE_ALL);
+    // Uses whole-track features computed elsewhere (e.g. accumulated while streaming);
+    // an empty chromagram is computed from audio on demand like any other feature
+    AnalysisContext(const AudioBuffer& audio, SpectralFeatures spectrum, Chromagram chromagram,
+                    uint32_t features = FEATURE_ALL);
+    
+    AnalysisContext(const AnalysisContext&) = delete;
+    AnalysisContext& operator=(const AnalysisContext&) = delete;
+
+    const AudioBuffer& audio() const { return audioRef; }
+    const SpectralFeatures& spectrum() const;         // Whole-track FFT
+    const ChromaVector& chroma() const;
+    const STFTFrames& stft() const;                   // FRAME_SIZE / HOP_SIZE
+    const std::vector<float>& onsetEnvelope() const;  // One value per hop
+    const PitchTrack& pitch() const;
+    const Chromagram& chromagram() const;             // CHROMA_FRAME_SIZE / CHROMA_HOP_SIZE
+    const EnergyPrefixSum& energy() const;            // Any window's sample energy in O(1)
+    const SpectralDescriptors& descriptors() const;   // Per STFT frame
+    
+    // Rhythm derived from the onset envelope
+    const OnsetVector& onsets() const;
+    const BeatTrack& beatTrack() const;
+    const BeatVector& beats() const { return beatTrack().beats; }
+    float bpm() const { return beatTrack().bpm; }
+
+    bool has(uint32_t feature) const { return (available & feature) == feature; }
+
+private:
+    void require(uint32_t feature, const char* name) const;
+
+    const AudioBuffer& audioRef;
+    uint32_t available = 0;
+    
+    mutable std::once_flag spectrumOnce, chromaOnce, stftOnce, fluxOnce, pitchOnce, chromagramOnce, energyOnce;
+    mutable std::once_flag descriptorsOnce;
+    mutable std::once_flag onsetsOnce, beatTrackOnce;
+    mutable SpectralFeatures wholeTrackSpectrum;
+    mutable ChromaVector chromaVector;
+    mutable STFTFrames frames;
+    mutable std::vector<float> spectralFlux;
+    mutable PitchTrack pitchTrack;
+    mutable Chromagram frameChroma;
+    mutable EnergyPrefixSum sampleEnergy;
+    mutable SpectralDescriptors frameDescriptors;
+    mutable OnsetVector onsetList;
+    mutable BeatTrack beatGrid;
 };
 
 // ========================================
@@ -145,12 +732,26 @@ private:
 
 class KeyDetector {
 public:
+    static constexpr int NUM_KEYS = 24;                  // Key k: root k / 2, minor when k is odd
+    static constexpr float SMOOTHING_SECONDS = 8.0f;     // Moving average of per-frame key scores
+    static constexpr float MIN_SEGMENT_SECONDS = 16.0f;  // Shorter key changes are absorbed
+    
     std::string detectKey(const AudioBuffer& audio);
+    std::string detectKey(const AnalysisContext& context);
+    std::vector<KeySegment> detectKeyTimeline(const AnalysisContext& context);
+    
+    static std::string keyName(int key);
+    // Inverse of keyName, also accepting flats and "m"/"min"/"maj" ("Bbm", "F# min"); -1 if unparseable
+    static int keyIndex(const std::string& name);
     
 private:
     ChromaVector extractChroma(const AudioBuffer& audio);
     std::string matchKeyTemplate(const ChromaVector& chroma);
     
+    // frames × 12 chroma times the 12 × 24 profile matrix, rows scaled by their chroma sum
+    static std::vector<float> scoreFrames(const Chromagram& chromagram);
+    static const std::vector<float>& profileMatrix();
+    
     // Krumhansl-Schmuckler key profiles
     static const std::vector<float> MAJOR_PROFILE;
     static const std::vector<float> MINOR_PROFILE;
@@ -164,14 +765,15 @@ private:
 class BPMDetector {
 public:
     float detectBPM(const AudioBuffer& audio);
+    float detectBPM(const AnalysisContext& context);
+    float detectBPM(const std::vector<float>& spectralFlux, int sampleRate);
     OnsetVector detectOnsets(const AudioBuffer& audio);
+    OnsetVector detectOnsets(const AnalysisContext& context);
+    OnsetVector detectOnsets(const std::vector<float>& spectralFlux, int sampleRate);
     
-private:
-    std::vector<float> calculateInterOnsetIntervals(const OnsetVector& onsets);
-    float autocorrelationTempo(const std::vector<float>& intervals);
-    float validateGenreBPM(float estimatedBPM);
+    static std::vector<float> calculateSpectralFlux(const STFTFrames& frames);
     
-    std::vector<float> calculateSpectralFlux(const AudioBuffer& audio);
+private:
     std::vector<float> adaptiveThresholding(const std::vector<float>& flux);
 };
 
@@ -179,18 +781,92 @@ private:
 // 🔊 AI_LOUDNESS - EBU R128 Standard
 // ========================================
 
+class LoudnessMeter;
+
 class LoudnessAnalyzer {
 public:
     float calculateLUFS(const AudioBuffer& audio);
+    float calculateLUFS(const AnalysisContext& context);
+    
+    // Full R128 measurement (range, true peak, timeline) of the whole track
+    LoudnessMeter measure(const AnalysisContext& context);
+    
+    // BS.1770-4 K-weighting: high-frequency shelf then RLB high-pass, fused
+    // into one per-sample cascade so state can carry across streamed chunks
+    class KWeightingFilter {
+    public:
+        explicit KWeightingFilter(int sampleRate);
+        float process(float sample);
+        
+    private:
+        double sb0, sb1, sb2, sa1, sa2;       // Stage 1: 1682 Hz shelf, +4 dB
+        double ha1, ha2;                      // Stage 2: 38 Hz high-pass (numerator 1, -2, 1)
+        double s1 = 0, s2 = 0, h1 = 0, h2 = 0; // Transposed direct form II state
+    };
+};
+
+// Streaming ITU-R BS.1770-4 / EBU R128 meter fed mono samples in chunks of
+// any size. State is the K-weighting filter, a 3 s ring of 100 ms sub-block
+// energies, the true-peak interpolator and two fixed 0.01 LU histograms, so
+// memory does not grow with the track; only the optional timeline does
+// (two floats per 100 ms).
+class LoudnessMeter {
+public:
+    static constexpr float SILENCE = -70.0f;  // Reported when nothing passes the absolute gate
+    
+    explicit LoudnessMeter(int sampleRate, bool recordTimeline = true);
+    
+    void process(const float* samples, size_t count);
+    
+    float integratedLoudness() const;   // LUFS over 400 ms blocks with 75% overlap, gated
+    float loudnessRange() const;        // LU between the 10th and 95th short-term percentiles (EBU Tech 3342)
+    float truePeak() const;             // dBTP from 4x oversampling
+    float momentaryLoudness() const;    // Latest 400 ms window, LUFS
+    float shortTermLoudness() const;    // Latest 3 s window, LUFS
+    const LoudnessTimeline& timeline() const { return history; }
     
 private:
-    AudioBuffer applyKWeighting(const AudioBuffer& audio);
-    float calculateIntegratedLoudness(const AudioBuffer& weightedAudio);
-    float convertToDBFS(float lufs);
+    static constexpr int MOMENTARY_SUBBLOCKS = 4;     // 400 ms
+    static constexpr int SHORT_TERM_SUBBLOCKS = 30;   // 3 s
+    static constexpr int PEAK_TAPS = 12;              // Interpolator taps per phase
+    static constexpr int OVERSAMPLING = 4;
     
-    // K-weighting filter coefficients
-    static const std::vector<float> K_WEIGHTING_B;
-    static const std::vector<float> K_WEIGHTING_A;
+    // Gated loudness values binned from the absolute gate up; per-bin power
+    // lets the relative gate be applied without keeping or sorting the blocks
+    struct Histogram {
+        static constexpr float BIN_LU = 0.01f;
+        static constexpr int BIN_COUNT = 10000;   // -70 .. +30 LUFS
+        
+        std::vector<uint32_t> counts = std::vector<uint32_t>(BIN_COUNT, 0);
+        std::vector<double> power = std::vector<double>(BIN_COUNT, 0.0);  // Sum of mean squares
+        double totalPower = 0.0;
+        size_t total = 0;
+        
+        static int bin(float loudness);
+        void add(float loudness, double meanSquare);
+    };
+    
+    void finishSubBlock();
+    void trackPeak(float sample);
+    
+    LoudnessAnalyzer::KWeightingFilter filter;
+    bool recordTimeline;
+    int subBlockSize;
+    int subBlockFill = 0;
+    double subBlockSum = 0.0;
+    double subBlocks[SHORT_TERM_SUBBLOCKS] = {};
+    size_t subBlockCount = 0;
+    
+    Histogram blocks;       // 400 ms gating blocks (integrated loudness)
+    Histogram shortTerms;   // Full 3 s windows (loudness range)
+    float momentary = SILENCE;
+    float shortTerm = SILENCE;
+    LoudnessTimeline history;
+    
+    float peakPhases[OVERSAMPLING - 1][PEAK_TAPS];  // Phase 0 is the sample itself
+    float peakHistory[2 * PEAK_TAPS] = {};          // Mirrored ring, newest first from peakPos
+    int peakPos = 0;
+    float peak = 0.0f;
 };
 
 // ========================================
@@ -200,6 +876,7 @@ private:
 class AcousticnessAnalyzer {
 public:
     float calculateAcousticness(const AudioBuffer& audio);
+    float calculateAcousticness(const AnalysisContext& context);
     
 private:
     // Attack/Decay analysis structures
@@ -216,11 +893,11 @@ private:
     };
     
     float analyzeHarmonicContent(const SpectralFeatures& features);
-    float detectInstruments(const AudioBuffer& audio);
+    float detectInstruments(const AnalysisContext& context);
     float calculateSyntheticElements(const SpectralFeatures& features);
     
     bool isAcousticInstrument(const SpectralFeatures& features);
-    float calculateAttackDecayCharacteristics(const AudioBuffer& audio);
+    float calculateAttackDecayCharacteristics(const AnalysisContext& context);
     
     // New helper methods for complete implementation
     float findFundamentalFrequency(const SpectralFeatures& features);
@@ -239,10 +916,11 @@ private:
 class InstrumentalnessDetector {
 public:
     float detectInstrumentalness(const AudioBuffer& audio);
+    float detectInstrumentalness(const AnalysisContext& context);
     
 private:
     float analyzeFormants(const SpectralFeatures& features);
-    float detectVocalContent(const AudioBuffer& audio);
+    float detectVocalContent(const AnalysisContext& context);
     std::vector<float> extractFormantFrequencies(const SpectralFeatures& features);
     
     bool isVocalFrequencyRange(float frequency);
@@ -256,18 +934,13 @@ private:
 class SpeechinessDetector {
 public:
     float detectSpeechiness(const AudioBuffer& audio);
+    float detectSpeechiness(const AnalysisContext& context);
     
 private:
     float analyzeSpeechPatterns(const SpectralFeatures& features);
-    float analyzeRhythmicSpeech(const AudioBuffer& audio);
-    float detectConsonants(const AudioBuffer& audio);
-    float analyzeIntonationContours(const AudioBuffer& audio);
-    
-    // YIN pitch detection methods
-    std::vector<float> calculateYinDifferenceFunction(const std::vector<float>& window);
-    std::vector<float> calculateCMNDF(const std::vector<float>& diff);
-    int findPitchPeriod(const std::vector<float>& cmndf, float sampleRate, float minFreq, float maxFreq);
-    float parabolicInterpolation(const std::vector<float>& diff, int tau);
+    float analyzeRhythmicSpeech(const AnalysisContext& context);
+    float detectConsonants(const SpectralFeatures& features);
+    float analyzeIntonationContours(const PitchTrack& pitch);
     float analyzeSpeechIntonation(const std::vector<float>& pitchContour, const std::vector<float>& confidence);
     float analyzeProsody(const std::vector<float>& semitones);
 };
@@ -279,27 +952,28 @@ private:
 class LivenessDetector {
 public:
     float detectLiveness(const AudioBuffer& audio);
+    float detectLiveness(const AnalysisContext& context);
     
 private:
-    float analyzeReverb(const AudioBuffer& audio);
-    float analyzeBackgroundNoise(const AudioBuffer& audio);
-    float analyzeSpatialCharacteristics(const AudioBuffer& audio);
-    float detectCrowdNoise(const AudioBuffer& audio);
+    float analyzeReverb(const AnalysisContext& context);
+    float analyzeBackgroundNoise(const AnalysisContext& context);
+    float analyzeSpatialCharacteristics(const AnalysisContext& context);
+    float detectCrowdNoise(const SpectralFeatures& features);
     
 public:
     float calculateReverbTime(const AudioBuffer& audio);
+    float calculateReverbTime(const AnalysisContext& context);
     
 private:
-    bool hasStudioCharacteristics(const AudioBuffer& audio);
+    bool hasStudioCharacteristics(const AnalysisContext& context);
     
     // RT60 estimation methods
-    std::vector<int> detectImpulses(const AudioBuffer& audio);
-    std::vector<float> calculateEnergyCurve(const std::vector<float>& signal, int windowSize, int hopSize);
+    std::vector<int> detectImpulses(const AnalysisContext& context);
     std::vector<float> schroederBackwardIntegration(const std::vector<float>& energy);
     float fitRT60(const std::vector<float>& schroederCurve, float timeStep);
-    float estimateRT60FromDecay(const AudioBuffer& audio);
-    float calculateNoiseFloor(const AudioBuffer& audio);
-    float estimateReverbTime(const AudioBuffer& audio);
+    float estimateRT60FromDecay(const AnalysisContext& context);
+    float calculateNoiseFloor(const AnalysisContext& context);
+    float estimateReverbTime(const AnalysisContext& context);
 };
 
 // ========================================
@@ -309,14 +983,17 @@ private:
 class EnergyAnalyzer {
 public:
     float calculateEnergy(const AudioBuffer& audio);
+    float calculateEnergy(const AnalysisContext& context);
     float analyzeDynamicRange(const AudioBuffer& audio);
+    float analyzeDynamicRange(const AnalysisContext& context);
     
 private:
     float calculateLoudnessEnergy(const AudioBuffer& audio);
     float calculateSpectralEnergy(const SpectralFeatures& features);
-    float calculateRhythmicEnergy(const AudioBuffer& audio);
+    float calculateRhythmicEnergy(const AnalysisContext& context);
     
     float calculateOnsetDensity(const OnsetVector& onsets);
+    float calculateTempoEnergy(float bpm);
 };
 
 // ========================================
@@ -326,7 +1003,9 @@ private:
 class DanceabilityAnalyzer {
 public:
     float calculateDanceability(const AudioBuffer& audio);
+    float calculateDanceability(const AnalysisContext& context);
     BeatVector detectBeats(const AudioBuffer& audio);
+    BeatVector detectBeats(const AnalysisContext& context);
     
 private:
     float analyzeBeatStrength(const BeatVector& beats);
@@ -343,6 +1022,7 @@ private:
 class ValenceAnalyzer {
 public:
     float calculateValence(const AudioBuffer& audio);
+    float calculateValence(const AnalysisContext& context);
     
 private:
     // Melodic segment structure
@@ -355,7 +1035,7 @@ private:
     };
     
     float analyzeMajorHarmony(const ChromaVector& chroma);
-    float analyzeMelodicPositivity(const AudioBuffer& audio);
+    float analyzeMelodicPositivity(const AnalysisContext& context);
     float analyzeTempoFactor(float bpm);
     float analyzeTimbralBrightness(const SpectralFeatures& features);
     
@@ -379,6 +1059,7 @@ private:
 class ModeDetector {
 public:
     std::string detectMode(const AudioBuffer& audio);
+    std::string detectMode(const AnalysisContext& context);
     
 private:
     float analyzeMajorThirdStrength(const ChromaVector& chroma);
@@ -393,7 +1074,9 @@ private:
 class TimeSignatureDetector {
 public:
     int detectTimeSignature(const AudioBuffer& audio);
+    int detectTimeSignature(const AnalysisContext& context);
     BeatVector detectBeats(const AudioBuffer& audio);  // Made public for GenreClassifier
+    BeatVector detectBeats(const AnalysisContext& context);
     
 private:
     std::vector<float> analyzeAccentPattern(const BeatVector& beats);
@@ -411,15 +1094,17 @@ private:
 class CharacteristicsExtractor {
 public:
     std::vector<std::string> extractCharacteristics(const AudioBuffer& audio);
+    std::vector<std::string> extractCharacteristics(const AnalysisContext& context);
     bool hasCompression(const AudioBuffer& audio);
+    bool hasCompression(const AnalysisContext& context);
     
 private:
     std::vector<std::string> analyzeTimbralFeatures(const SpectralFeatures& features);
-    std::vector<std::string> analyzeRhythmicPatterns(const AudioBuffer& audio);
-    std::vector<std::string> analyzeEffects(const AudioBuffer& audio);
+    std::vector<std::string> analyzeRhythmicPatterns(const AnalysisContext& context);
+    std::vector<std::string> analyzeEffects(const AnalysisContext& context);
     
     bool hasDistortion(const SpectralFeatures& features);
-    bool hasReverb(const AudioBuffer& audio);
+    bool hasReverb(const AnalysisContext& context);
     std::string mapToSemanticTerm(float feature, const std::string& category);
 };
 
@@ -430,14 +1115,15 @@ private:
 class ConfidenceCalculator {
 public:
     float calculateOverallConfidence(const AudioBuffer& audio, const AIAnalysisResult& results);
+    float calculateOverallConfidence(const AnalysisContext& context, const AIAnalysisResult& results);
     
 private:
-    float assessAudioQuality(const AudioBuffer& audio);
+    float assessAudioQuality(const AnalysisContext& context);
     float validateConsistency(const AIAnalysisResult& results);
     float calculateFeatureCertainty(const AIAnalysisResult& results);
     
-    float calculateSNR(const AudioBuffer& audio);
-    float detectCompressionArtifacts(const AudioBuffer& audio);
+    float calculateSNR(const AnalysisContext& context);
+    float detectCompressionArtifacts(const AnalysisContext& context);
     bool isFrequencyResponseComplete(const SpectralFeatures& features);
 };
 
@@ -449,6 +1135,7 @@ class GenreClassifier {
 public:
     std::vector<std::string> classifySubgenres(const AudioBuffer& audio, const AIAnalysisResult& features);
     std::string classifyEra(const AudioBuffer& audio, const AIAnalysisResult& features);
+    std::string classifyEra(const AnalysisContext& context, const AIAnalysisResult& features);
     std::string analyzeCulturalContext(const AudioBuffer& audio, const AIAnalysisResult& features);
     
 private:
@@ -467,7 +1154,7 @@ private:
     };
     
     std::string analyzeProductionTechniques(const SpectralFeatures& features);
-    std::string analyzeInstrumentationPatterns(const AudioBuffer& audio);
+    std::string analyzeInstrumentationPatterns(const SpectralFeatures& features);
     bool hasVintageCharacteristics(const SpectralFeatures& features);
     
     // Cultural context analysis methods
@@ -494,6 +1181,116 @@ private:
     std::vector<std::string> mapBPMEnergyToOccasions(float bpm, float energy);
 };
 
+// ========================================
+// ⚡ PARALLEL TASK SCHEDULING
+// ========================================
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0);  // 0 = one worker per hardware thread
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task) {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+    
+    // Tasks queued from a worker go to its own deque; idle workers steal the oldest work
+    void enqueue(std::function<void()> task);
+    size_t size() const { return workers.size(); }
+    
+    static ThreadPool& shared();
+    
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    
+    void workerLoop(size_t index);
+    bool popTask(size_t index, std::function<void()>& task);
+    
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<size_t> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    bool stopping = false;
+};
+
+// Dependency graph of tasks; each task starts once all of its dependencies finished
+class TaskGraph {
+public:
+    using TaskId = size_t;
+    
+    TaskGraph();
+    
+    TaskId addTask(std::function<void()> work, const std::vector<TaskId>& dependencies = {});
+    void run(ThreadPool& pool);  // Blocks until every task ran; rethrows the first failure
+    
+private:
+    struct State;  // Shared with queued pool tasks, which may outlive run()
+    
+    static void schedule(const std::shared_ptr<State>& state, ThreadPool& pool, TaskId id);
+    static bool runReadyTask(const std::shared_ptr<State>& state, ThreadPool& pool);
+    
+    std::shared_ptr<State> state;
+};
+
+// ========================================
+// 🎧 AUDIO FILE DECODING
+// ========================================
+
+// Receives each decoded block of mono samples in order
+using AudioChunkCallback = std::function<void(const float* samples, size_t count)>;
+
+struct AudioStreamInfo {
+    int sampleRate = 0;
+    int channels = 0;          // Channels in the file (chunks are always mono)
+    int64_t frames = 0;        // Frames actually decoded
+};
+
+class AudioDecoder {
+public:
+    static constexpr size_t CHUNK_FRAMES = 16384;  // Frames read per libsndfile call
+
+    // Decodes in CHUNK_FRAMES blocks, downmixing each block straight into one
+    // preallocated mono buffer; throws std::runtime_error on failure
+    static AudioBuffer decodeFile(const std::string& filePath);
+
+    // Same decoding, but hands every mono block to onChunk instead of keeping the track.
+    // onOpen (optional) receives the header info before the first block.
+    static AudioStreamInfo decodeStream(const std::string& filePath, const AudioChunkCallback& onChunk,
+                                        const std::function<void(const AudioStreamInfo&)>& onOpen = nullptr);
+};
+
+// ========================================
+// 📚 BATCH ANALYSIS
+// ========================================
+
+struct BatchOptions {
+    size_t threadCount = 0;   // 0 = shared pool sized to the cores
+    bool verbose = false;     // Per-track analysis logging
+    FieldMask fields = FIELD_ALL;
+};
+
+struct BatchItemResult {
+    std::string filePath;
+    bool success = false;
+    std::string error;
+    AIAnalysisResult result;
+};
+
+using BatchResultCallback = std::function<void(const BatchItemResult&)>;
+
 // Forward declarations
 class HAMMSAnalyzer;
 
@@ -503,9 +1300,27 @@ class HAMMSAnalyzer;
 
 class AIMetadataAnalyzer {
 public:
-    AIAnalysisResult analyzeAudio(const AudioBuffer& audio);
+    AIMetadataAnalyzer() = default;
+    explicit AIMetadataAnalyzer(ThreadPool& pool);
+    
+    // Runs the requested fields plus everything they depend on
+    AIAnalysisResult analyzeAudio(const AudioBuffer& audio, FieldMask fields = FIELD_ALL);
+    
+    // Runs the requested fields on a prepared context. Fields flagged in
+    // known.analyzedFields are taken from `known` instead of being recomputed.
+    AIAnalysisResult analyzeContext(const AnalysisContext& context, FieldMask fields, const AIAnalysisResult& known);
+    void setVerbose(bool enabled) { verbose = enabled; }
+    
+    // Decodes and analyzes every file in parallel. onResult is called once per file
+    // as soon as it finishes (calls are serialized); returns the number of successes.
+    static size_t analyzeBatch(const std::vector<std::string>& filePaths,
+                               const BatchOptions& options,
+                               const BatchResultCallback& onResult);
     
 private:
+    ThreadPool* pool = nullptr;  // Defaults to ThreadPool::shared()
+    bool verbose = true;
+    
     // Individual analyzers
     std::unique_ptr<KeyDetector> keyDetector;
     std::unique_ptr<BPMDetector> bpmDetector;
@@ -526,50 +1341,355 @@ private:
     std::unique_ptr<HAMMSAnalyzer> hammsAnalyzer;
     
     void initializeAnalyzers();
-    AIAnalysisResult combineResults(const AudioBuffer& audio);
+    AIAnalysisResult combineResults(const AnalysisContext& context, FieldMask fields, const AIAnalysisResult& known);
 };
 
 class HAMMSAnalyzer {
 public:
     HAMMSVector calculateHAMMS(const AudioBuffer& audio);
+    HAMMSVector calculateHAMMS(const AnalysisContext& context);
     
 private:
     // Harmonic analysis
-    float analyzeHarmonicity(const AudioBuffer& audio);
+    float analyzeHarmonicity(const AnalysisContext& context);
     float calculateHarmonicToNoiseRatio(const SpectralFeatures& features);
     float detectHarmonicSeries(const std::vector<float>& spectrum);
     
     // Melodic analysis  
-    float analyzeMelodicity(const AudioBuffer& audio);
-    std::vector<float> extractMelodicContour(const AudioBuffer& audio);
+    float analyzeMelodicity(const AnalysisContext& context);
+    std::vector<float> extractMelodicContour(const PitchTrack& pitch);
     float calculateMelodicComplexity(const std::vector<float>& contour);
     
     // Rhythmic analysis
-    float analyzeRhythmicity(const AudioBuffer& audio);
+    float analyzeRhythmicity(const AnalysisContext& context);
     float calculateRhythmicRegularity(const OnsetVector& onsets);
     float analyzeSyncopation(const BeatVector& beats);
     
     // Timbral analysis
-    float analyzeTimbrality(const AudioBuffer& audio);
-    float calculateSpectralComplexity(const SpectralFeatures& features);
-    float analyzeTimbralVariation(const AudioBuffer& audio);
+    float analyzeTimbrality(const AnalysisContext& context);
+    float calculateSpectralComplexity(const SpectralDescriptors& descriptors);
+    float analyzeTimbralVariation(const SpectralDescriptors& descriptors);
     
     // Dynamic analysis
-    float analyzeDynamics(const AudioBuffer& audio);
-    float calculateDynamicRange(const AudioBuffer& audio);
+    float analyzeDynamics(const AnalysisContext& context);
+    float calculateDynamicRange(const AnalysisContext& context);
     float analyzeDynamicVariation(const std::vector<float>& envelope);
     
     // Tonal analysis
-    float analyzeTonality(const AudioBuffer& audio);
+    float analyzeTonality(const AnalysisContext& context);
     float calculateTonalClarity(const ChromaVector& chroma);
-    float analyzeKeyStability(const AudioBuffer& audio);
+    float analyzeKeyStability(const Chromagram& chromagram, const AudioBuffer& audio);
     
     // Temporal analysis
-    float analyzeTemporality(const AudioBuffer& audio);
-    float calculateTempoStability(const AudioBuffer& audio);
+    float analyzeTemporality(const AnalysisContext& context);
+    float calculateTempoStability(const AnalysisContext& context);
     float analyzeRhythmicConsistency(const BeatVector& beats);
 };
 
+// ========================================
+// 🌊 STREAMING ANALYSIS
+// ========================================
+
+struct StreamingOptions {
+    FieldMask fields = FIELD_ALL;
+    float excerptSeconds = 600.0f;   // Memory ceiling: at most this much audio is held
+    bool verbose = true;
+    ThreadPool* pool = nullptr;      // Defaults to ThreadPool::shared()
+};
+
+// Push-style analysis whose memory does not grow with track length.
+// Tracks that fit in the excerpt get exactly the analyzeAudio() result. For longer
+// tracks BPM, loudness and the spectrum (and chroma) come from whole-track streaming
+// accumulators, and the remaining analyzers run on an excerpt of evenly spaced segments.
+class StreamingAnalyzer {
+public:
+    static constexpr int SPECTRUM_SIZE = 16384;   // Running-spectrum frame length
+    static constexpr int EXCERPT_SEGMENTS = 8;    // Excerpt is held as up to this many segments
+
+    explicit StreamingAnalyzer(int sampleRate, const StreamingOptions& options = StreamingOptions());
+    ~StreamingAnalyzer();
+
+    void push(const float* samples, size_t count);   // Mono PCM, in order
+    AIAnalysisResult finish();                        // Call once after the last push
+    size_t samplesPushed() const;
+
+    // Decodes a file chunk by chunk straight into a streaming analysis
+    static AIAnalysisResult analyzeFile(const std::string& filePath, const StreamingOptions& options = StreamingOptions());
+
+private:
+    struct State;
+    std::unique_ptr<State> state;
+};
+
+// ========================================
+// 🔎 SIMILARITY INDEX
+// ========================================
+
+// Optional bounds on findSimilar() results. A bounded attribute excludes tracks
+// where it is unknown (NaN); an unbounded one accepts them.
+struct SimilarityFilters {
+    float minBPM = -std::numeric_limits<float>::infinity();
+    float maxBPM = std::numeric_limits<float>::infinity();
+    float minEnergy = -std::numeric_limits<float>::infinity();
+    float maxEnergy = std::numeric_limits<float>::infinity();
+    float minSimilarity = 0.0f;   // On the HAMMSVector::calculateSimilarity scale
+
+    bool accepts(float bpm, float energy) const;
+};
+
+struct SimilarTrack {
+    int64_t trackId;
+    float similarity;   // 1 = identical, as HAMMSVector::calculateSimilarity
+};
+
+// Exact k-nearest-neighbour search over a library of HAMMS vectors.
+// Vectors are kept as seven aligned columns scanned by the vector kernels.
+// Past TREE_MIN_ROWS tracks a KD-tree with per-node bounding boxes covers the
+// rows that existed at its last build; rows added since are scanned, and the
+// tree is rebuilt once they outgrow a quarter of it.
+// Not synchronized: use from one thread at a time.
+class HAMMSIndex {
+public:
+    static constexpr int DIMENSIONS = HAMMSBatch::DIMENSIONS;
+    static constexpr size_t TREE_MIN_ROWS = 4096;   // Below this a scan beats the tree
+    static constexpr size_t LEAF_SIZE = 64;
+
+    // Adds a track or replaces its vector and attributes
+    void upsert(int64_t trackId, const HAMMSVector& vector,
+                float bpm = std::numeric_limits<float>::quiet_NaN(),
+                float energy = std::numeric_limits<float>::quiet_NaN());
+    bool remove(int64_t trackId);
+    bool contains(int64_t trackId) const { return rows.count(trackId) > 0; }
+    size_t size() const { return rows.size(); }
+
+    // Nearest tracks to an indexed track, itself excluded, most similar first.
+    // Empty when trackId is not indexed.
+    std::vector<SimilarTrack> findSimilar(int64_t trackId, size_t k,
+                                          const SimilarityFilters& filters = SimilarityFilters()) const;
+    std::vector<SimilarTrack> findSimilar(const HAMMSVector& query, size_t k,
+                                          const SimilarityFilters& filters = SimilarityFilters()) const;
+
+private:
+    struct Node {
+        uint32_t begin, end;        // Row range, contiguous after the build reorders rows
+        int32_t left = -1, right = -1;
+        float lower[DIMENSIONS], upper[DIMENSIONS];
+    };
+    class Search;
+
+    void append(int64_t trackId, const float* values, float bpm, float energy);
+    void rebuild();
+    int32_t buildNode(std::vector<uint32_t>& order, uint32_t begin, uint32_t end);
+    std::vector<SimilarTrack> search(const float* query, size_t k, const SimilarityFilters& filters,
+                                     int64_t exclude) const;
+
+    AlignedFloats columns[DIMENSIONS];
+    std::vector<float> bpms, energies;
+    std::vector<int64_t> trackIds;
+    std::vector<uint8_t> live;                  // Removed and replaced rows stay until the next build
+    std::unordered_map<int64_t, uint32_t> rows; // trackId -> live row
+
+    std::vector<Node> nodes;                    // nodes[0] is the root
+    size_t treeRows = 0;                        // Rows [0, treeRows) are in the tree
+};
+
+// ========================================
+// 🗜️ COMPACT HAMMS STORAGE
+// ========================================
+
+// HAMMS vectors quantized to 8 or 16 bits per dimension: a fixed record of 7 or 14
+// bytes per track plus a 32-bit track id, so 10M tracks take about 110 MB at 8 bits.
+// Records are stored as one column per dimension and scored on the codes directly.
+// save() writes the same columns, 64-byte aligned, and open() maps the file read-only,
+// so a library loads without parsing and pages in as it is scanned.
+class QuantizedHAMMSStore {
+public:
+    static constexpr int DIMENSIONS = HAMMSBatch::DIMENSIONS;
+
+    explicit QuantizedHAMMSStore(int bits = 8);   // 8 or 16, else std::invalid_argument
+
+    int bits() const { return codeBytes * 8; }
+    size_t recordSize() const { return DIMENSIONS * codeBytes; }
+    size_t size() const { return count; }
+    bool mapped() const { return mapping != nullptr; }
+
+    // Opened stores are read-only: add() throws std::logic_error
+    void add(uint32_t trackId, const HAMMSVector& vector);
+    uint32_t trackId(size_t index) const { return ids()[index]; }
+    HAMMSVector at(size_t index) const;
+
+    // One record: the dimension codes in order, each little-endian
+    void encode(const HAMMSVector& vector, uint8_t* record) const;
+    HAMMSVector decode(const uint8_t* record) const;
+
+    // Most similar first, on the HAMMSVector::calculateSimilarity scale
+    std::vector<SimilarTrack> mostSimilar(const HAMMSVector& query, size_t k, const float* weights = nullptr) const;
+    // Excludes the track itself; looks it up by a scan of the ids. Empty when absent.
+    std::vector<SimilarTrack> findSimilar(uint32_t trackId, size_t k, const float* weights = nullptr) const;
+
+    // Both throw std::runtime_error on I/O errors or a malformed file
+    void save(const std::string& path) const;
+    static QuantizedHAMMSStore open(const std::string& path);
+
+private:
+    struct Mapping;
+
+    uint32_t maxCode() const { return codeBytes == 1 ? 0xFFu : 0xFFFFu; }
+    uint32_t quantize(float value) const;
+    const uint32_t* ids() const;
+    const void* column(int dimension) const;
+    std::vector<SimilarTrack> search(const HAMMSVector& query, size_t k, const float* weights, size_t exclude) const;
+
+    int codeBytes;
+    size_t count = 0;
+    std::vector<uint32_t> ownedIds;
+    std::vector<uint8_t, AlignedAllocator<uint8_t>> ownedColumns[DIMENSIONS];
+    std::shared_ptr<const Mapping> mapping;   // Shared by copies; unmapped with the last one
+};
+
+// ========================================
+// 🗂️ LIBRARY CLUSTERING
+// ========================================
+
+// What library-wide comparison knows about one track; NaN and -1 mark unknown values
+struct TrackFeatures {
+    int64_t trackId = 0;
+    HAMMSVector hamms;
+    float energy = std::numeric_limits<float>::quiet_NaN();          // AI_ENERGY (0-1)
+    float valence = std::numeric_limits<float>::quiet_NaN();         // AI_VALENCE (0-1)
+    float danceability = std::numeric_limits<float>::quiet_NaN();    // AI_DANCEABILITY (0-1)
+    float bpm = std::numeric_limits<float>::quiet_NaN();             // AI_BPM
+    int key = -1;                                                    // KeyDetector::keyIndex(AI_KEY)
+};
+
+// Relative weight of each feature group in the distance
+struct ClusteringOptions {
+    float hammsWeight = 1.0f;
+    float moodWeight = 1.0f;      // Energy, valence, danceability
+    float tempoWeight = 1.0f;
+    float keyWeight = 1.0f;
+    ThreadPool* pool = nullptr;   // Defaults to ThreadPool::shared()
+};
+
+// Row i lists track i's k nearest tracks (indices into the input), most similar first
+struct NeighborGraph {
+    size_t k = 0;
+    std::vector<uint32_t> neighbors;    // size × k
+    std::vector<float> similarities;    // size × k, 1 = identical, 0 = farthest possible
+};
+
+struct TrackClusters {
+    int count = 0;
+    std::vector<int> assignments;       // Cluster of each track
+    std::vector<size_t> sizes;          // Tracks in each cluster
+};
+
+// Similarity structure of a whole library. Each track becomes a 14-dimensional
+// point: the HAMMS vector, energy / valence / danceability, tempo folded by octave
+// onto a circle (half and double time coincide) and key on the circle of fifths
+// (relative major and minor coincide, as on the Camelot wheel), each group scaled
+// by the square root of its weight. Points are stored as aligned columns.
+class LibraryClustering {
+public:
+    static constexpr int DIMENSIONS = 14;
+    static constexpr size_t QUERY_TILE = 64;          // Tracks whose neighbours one task finds
+    static constexpr size_t CANDIDATE_TILE = 2048;    // Rows scanned while they stay in L2
+
+    explicit LibraryClustering(const std::vector<TrackFeatures>& tracks,
+                               const ClusteringOptions& options = ClusteringOptions());
+
+    size_t size() const { return columns[0].size(); }
+    void embed(const TrackFeatures& track, float* values) const;
+
+    // Exact k nearest neighbours of every track: all pairs, tiled so a candidate tile
+    // is reused by QUERY_TILE queries, tiles spread over the pool. Memory stays size × k.
+    NeighborGraph nearestNeighbors(size_t k) const;
+
+    // Lloyd's k-means from k-means++ seeds, assignment and update steps in parallel.
+    // clusters = 0 picks sqrt(size / 2).
+    TrackClusters kMeans(int clusters = 0, int maxIterations = 50, uint32_t seed = 1) const;
+
+private:
+    static constexpr size_t POINT_BLOCK = 1024;       // Tracks per k-means task
+
+    void point(size_t index, float* values) const;
+    float similarity(float distance) const { return 1.0f - std::sqrt(std::min(1.0f, distance / maxDistance)); }
+    ThreadPool& pool() const { return options.pool ? *options.pool : ThreadPool::shared(); }
+
+    ClusteringOptions options;
+    float maxDistance;                  // Squared diameter of the weighted feature space
+    AlignedFloats columns[DIMENSIONS];
+};
+
+// ========================================
+// 🎛️ HARMONIC MIXING
+// ========================================
+
+// What makes a track a good next track for a DJ mix
+struct MixingFilters {
+    float bpmTolerance = 0.06f;           // Fraction of the seed's BPM
+    bool tempoMultiples = true;           // Also accept half and double time
+    float maxEnergyDifference = 0.2f;     // Ignored when either energy is unknown
+};
+
+struct MixingMatch {
+    int64_t trackId;
+    int camelot;          // HarmonicMixingIndex code of the track's key
+    float bpm;
+    float energy;
+    float tempoRatio;     // 1, 0.5 or 2: how the track's BPM lines up with the seed's
+};
+
+// Tracks bucketed by Camelot code, whole BPM and tenth of energy. A query reads
+// only the cells of the (at most four) compatible keys inside the tempo and energy
+// windows, nearest first, and stops once no unread cell can beat its results.
+// Upserts and removals move a single entry.
+class HarmonicMixingIndex {
+public:
+    static constexpr int CAMELOT_CODES = 24;
+    static constexpr int BPM_BUCKETS = 320;     // 1 BPM wide; faster tempos share the last one
+    static constexpr int ENERGY_BUCKETS = 11;   // 0.1 wide, then one for unknown energy
+
+    // Camelot code of a KeyDetector key index: (number - 1) * 2, plus 1 for "B" (major).
+    // -1 for an unknown key.
+    static int camelotCode(int key);
+    static std::string camelotName(int code);        // "8A"
+    static uint32_t compatibleCodes(int code);       // Bit c set when code c mixes with this one
+
+    // Tracks without a key or BPM cannot be placed and are left out; returns whether indexed
+    bool upsert(int64_t trackId, int key, float bpm, float energy = std::numeric_limits<float>::quiet_NaN());
+    bool remove(int64_t trackId);
+    size_t size() const { return locations.size(); }
+
+    // Compatible tracks, closest in tempo and energy first; the seed itself is excluded
+    std::vector<MixingMatch> compatibleTracks(int64_t trackId, size_t limit,
+                                              const MixingFilters& filters = MixingFilters()) const;
+    std::vector<MixingMatch> compatibleTracks(int key, float bpm, float energy, size_t limit,
+                                              const MixingFilters& filters = MixingFilters()) const;
+
+private:
+    struct Entry {
+        int64_t trackId;
+        float bpm;
+        float energy;
+    };
+    struct Location {
+        uint32_t cell;
+        uint32_t slot;
+    };
+
+    static constexpr int UNKNOWN_ENERGY = ENERGY_BUCKETS - 1;
+
+    static int bpmBucket(float bpm);
+    static int energyBucket(float energy);
+    static uint32_t cellOf(int code, int bpmBucket, int energyBucket);
+    std::vector<MixingMatch> search(int code, float bpm, float energy, size_t limit,
+                                    const MixingFilters& filters, int64_t exclude) const;
+
+    std::vector<std::vector<Entry>> cells = std::vector<std::vector<Entry>>(CAMELOT_CODES * BPM_BUCKETS * ENERGY_BUCKETS);
+    std::unordered_map<int64_t, Location> locations;
+};
+
 } // namespace MusicAnalysis
 
 #endif // AI_ALGORITHMS_H
\ No newline at end of file
@@ -10,7 +10,7 @@ namespace MusicAnalysis {
 // AudioProcessor - Missing Implementation
 // ========================================
 
-std::vector<float> AudioProcessor::applyWindow(const std::vector<float>& signal, int windowType) {
+std::vector<float> AudioProcessor::applyWindow(SampleSpan signal, int windowType) {
     std::vector<float> windowed(signal.size());
     
     for (size_t i = 0; i < signal.size(); ++i) {
@@ -111,43 +111,23 @@ float InstrumentalnessDetector::calculateVocalProbability(const std::vector<floa
 // LivenessDetector - Missing Implementation
 // ========================================
 
-bool LivenessDetector::hasStudioCharacteristics(const AudioBuffer& audio) {
+bool LivenessDetector::hasStudioCharacteristics(const AnalysisContext& context) {
     // Analyze characteristics typical of studio recordings
     
     // 1. Check for consistent noise floor (studio recordings have controlled noise)
-    float noiseFloor = calculateNoiseFloor(audio);
+    float noiseFloor = calculateNoiseFloor(context);
     bool consistentNoise = noiseFloor < -60.0f && noiseFloor > -90.0f;
     
     // 2. Check for studio reverb characteristics
-    float rt60 = estimateReverbTime(audio);
+    float rt60 = estimateReverbTime(context);
     bool studioReverb = rt60 > 0.1f && rt60 < 0.5f; // Typical studio reverb
     
     // 3. Check for compression/limiting (common in studio recordings)
     CharacteristicsExtractor extractor;
-    bool hasCompression = extractor.hasCompression(audio);
+    bool hasCompression = extractor.hasCompression(context);
     
     // 4. Check spectral consistency (studio recordings have controlled frequency response)
-    AudioProcessor processor;
-    SpectralFeatures features = processor.calculateSpectralFeatures(audio);
-    
-    // Calculate spectral flatness
-    float spectralFlatness = 0.0f;
-    if (!features.magnitude.empty()) {
-        float geometricMean = 1.0f;
-        float arithmeticMean = 0.0f;
-        
-        for (float mag : features.magnitude) {
-            if (mag > 0) {
-                geometricMean *= std::pow(mag, 1.0f / features.magnitude.size());
-                arithmeticMean += mag;
-            }
-        }
-        arithmeticMean /= features.magnitude.size();
-        
-        if (arithmeticMean > 0) {
-            spectralFlatness = geometricMean / arithmeticMean;
-        }
-    }
+    float spectralFlatness = context.descriptors().flatnessSummary.mean;
     
     bool controlledSpectrum = spectralFlatness > 0.5f;
     
@@ -270,11 +250,7 @@ private:
         
         for (int i = 0; i <= audio.length - windowSize; i += hopSize) {
             // Extract window
-            AudioBuffer window(
-                std::vector<float>(audio.samples.begin() + i, 
-                                 audio.samples.begin() + i + windowSize),
-                audio.sampleRate, audio.channels
-            );
+            AudioBuffer window(audio.samples.data() + i, windowSize, audio.sampleRate, audio.channels);
             
             // Calculate spectrum
             SpectralFeatures features = processor.calculateSpectralFeatures(window);
@@ -370,19 +346,14 @@ BeatVector TimeSignatureDetector::detectBeats(const AudioBuffer& audio) {
 // LivenessDetector - Missing Methods
 // ========================================
 
-float LivenessDetector::calculateNoiseFloor(const AudioBuffer& audio) {
+float LivenessDetector::calculateNoiseFloor(const AnalysisContext& context) {
     // Calculate noise floor in dB
     const int windowSize = 2048;
     const int hopSize = 1024;
     
-    std::vector<float> energies;
-    
-    for (int i = 0; i <= audio.length - windowSize; i += hopSize) {
-        float windowEnergy = 0.0f;
-        for (int j = 0; j < windowSize; ++j) {
-            windowEnergy += audio.samples[i + j] * audio.samples[i + j];
-        }
-        energies.push_back(windowEnergy / windowSize);
+    std::vector<float> energies = context.energy().windowSums(windowSize, hopSize);
+    for (float& energy : energies) {
+        energy /= windowSize;
     }
     
     // Sort energies and take 10th percentile as noise floor
@@ -394,9 +365,9 @@ float LivenessDetector::calculateNoiseFloor(const AudioBuffer& audio) {
     return 20.0f * std::log10(std::sqrt(noiseFloorEnergy) + 1e-10f);
 }
 
-float LivenessDetector::estimateReverbTime(const AudioBuffer& audio) {
+float LivenessDetector::estimateReverbTime(const AnalysisContext& context) {
     // Wrapper for calculateReverbTime
-    return calculateReverbTime(audio);
+    return calculateReverbTime(context);
 }
 
 } // namespace MusicAnalysis
\ No newline at end of file
@@ -0,0 +1,204 @@
+// Beat tracking - one tempogram and beat grid per song, shared by every rhythm analyzer
+
+#include "ai_algorithms.h"
+#include <numeric>
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🥁 TEMPOGRAM TEMPO ESTIMATE
+// ========================================
+
+BeatTracker::TempoEstimator::TempoEstimator(int sampleRate, bool keepWindows)
+    : frameRate((float)sampleRate / AnalysisContext::HOP_SIZE), keepWindows(keepWindows) {
+    windowSize = std::max(2, (int)std::round(TEMPOGRAM_SECONDS * frameRate));
+    hopSize = std::max(1, (int)std::round(TEMPOGRAM_HOP_SECONDS * frameRate));
+    // Twice the slowest beat period, plus one lag for the duple-meter sum around it
+    maxLag = std::min(windowSize - 1, 2 * (int)std::ceil(60.0f * frameRate / MIN_BPM) + 1);
+
+    pending.reserve(windowSize);
+    summed.assign(maxLag + 1, 0.0f);
+    autocorrelation = std::make_unique<FFTAutocorrelation>(windowSize, maxLag);
+}
+
+void BeatTracker::TempoEstimator::add(const float* envelope, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        pending.push_back(envelope[i]);
+        if ((int)pending.size() == windowSize) {
+            addWindow(pending);
+            pending.erase(pending.begin(), pending.begin() + hopSize);
+        }
+    }
+}
+
+float BeatTracker::TempoEstimator::bpm() {
+    // A track shorter than one window is its own window
+    if (!finished && windowCount == 0 && pending.size() > 1) {
+        addWindow(pending);
+    }
+    finished = true;
+
+    float tempo = windowCount > 0 ? pickTempo(summed, frameRate, MIN_BPM, MAX_BPM, true) : 0.0f;
+    return tempo > 0.0f ? tempo : PRIOR_BPM;
+}
+
+void BeatTracker::TempoEstimator::addWindow(const std::vector<float>& window) {
+    // Log compression keeps a loud backbeat from outvoting the softer beats between,
+    // and without its mean the envelope correlates on rhythm, not on loudness
+    std::vector<float> centered(window.size());
+    for (size_t i = 0; i < window.size(); i++) {
+        centered[i] = std::log1p(window[i]);
+    }
+    float mean = std::accumulate(centered.begin(), centered.end(), 0.0f) / centered.size();
+    for (float& value : centered) {
+        value -= mean;
+    }
+
+    std::vector<float> acf = autocorrelation->compute(centered);
+    if (acf[0] <= 0.0f) return;  // Flat window: no rhythm to vote with
+
+    const float scale = 1.0f / acf[0];
+    for (int tau = 0; tau < (int)acf.size(); tau++) {
+        acf[tau] *= scale;
+        summed[tau] += acf[tau];
+    }
+    windowCount++;
+
+    if (keepWindows) {
+        kept.push_back(std::move(acf));
+    }
+}
+
+float BeatTracker::pickTempo(const std::vector<float>& acf, float frameRate, float minBPM, float maxBPM,
+                             bool usePrior) {
+    int minLag = std::max(1, (int)std::floor(60.0f * frameRate / maxBPM));
+    int maxLag = std::min((int)acf.size() - 2, (int)std::ceil(60.0f * frameRate / minBPM));
+    const int lastLag = (int)acf.size() - 1;
+
+    int bestLag = 0;
+    float bestScore = 0.0f;
+    for (int tau = minLag; tau <= maxLag; tau++) {
+        if (acf[tau] < acf[tau - 1] || acf[tau] < acf[tau + 1]) continue;  // Peaks only
+
+        // Duple meter: the bar-level lag backs the beat (Ellis's TPS2), so a loud
+        // backbeat cannot halve the tempo
+        float score = acf[tau];
+        if (2 * tau + 1 <= lastLag) {
+            score += 0.5f * acf[2 * tau] + 0.25f * (acf[2 * tau - 1] + acf[2 * tau + 1]);
+        }
+        if (usePrior) {
+            float octaves = std::log2(60.0f * frameRate / tau / PRIOR_BPM) / PRIOR_OCTAVES;
+            score *= std::exp(-0.5f * octaves * octaves);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = tau;
+        }
+    }
+    if (bestLag == 0) return 0.0f;
+
+    // Parabolic interpolation gives the fractional lag
+    float left = acf[bestLag - 1], center = acf[bestLag], right = acf[bestLag + 1];
+    float denominator = left - 2.0f * center + right;
+    float offset = denominator < 0.0f ? 0.5f * (left - right) / denominator : 0.0f;
+    float lag = bestLag + std::max(-0.5f, std::min(0.5f, offset));
+
+    return std::max(minBPM, std::min(maxBPM, 60.0f * frameRate / lag));
+}
+
+// ========================================
+// 🥁 BEAT GRID
+// ========================================
+
+BeatTrack BeatTracker::track(const std::vector<float>& onsetEnvelope, int sampleRate) {
+    BeatTrack result;
+
+    TempoEstimator estimator(sampleRate, true);
+    estimator.add(onsetEnvelope.data(), onsetEnvelope.size());
+    result.bpm = estimator.bpm();
+    if (onsetEnvelope.size() < 2) return result;
+
+    const float frameRate = (float)sampleRate / AnalysisContext::HOP_SIZE;
+    const int windowSize = std::max(2, (int)std::round(TEMPOGRAM_SECONDS * frameRate));
+    const int hopSize = std::max(1, (int)std::round(TEMPOGRAM_HOP_SECONDS * frameRate));
+
+    // Local tempo of each window, kept near the global one so octave jumps cannot happen
+    result.curveInterval = hopSize / frameRate;
+    for (const auto& acf : estimator.windows()) {
+        float local = pickTempo(acf, frameRate, result.bpm / LOCAL_TEMPO_RANGE, result.bpm * LOCAL_TEMPO_RANGE, false);
+        result.tempoCurve.push_back(local > 0.0f ? local : result.bpm);
+    }
+
+    // Beat period at every frame, interpolated between window centres
+    std::vector<float> periods(onsetEnvelope.size(), 60.0f * frameRate / result.bpm);
+    const auto& curve = result.tempoCurve;
+    if (!curve.empty()) {
+        const float firstCentre = windowSize / 2.0f;
+        for (size_t i = 0; i < periods.size(); i++) {
+            float position = std::max(0.0f, (i - firstCentre) / hopSize);
+            size_t k = std::min((size_t)position, curve.size() - 1);
+            float local = curve[k];
+            if (k + 1 < curve.size()) {
+                float t = position - k;
+                local = curve[k] * (1.0f - t) + curve[k + 1] * t;
+            }
+            periods[i] = 60.0f * frameRate / local;
+        }
+    }
+
+    for (int frame : alignBeats(onsetEnvelope, periods)) {
+        result.beats.beatTimes.push_back(frame / frameRate);
+        result.beats.beatStrengths.push_back(onsetEnvelope[frame]);
+    }
+
+    return result;
+}
+
+std::vector<int> BeatTracker::alignBeats(const std::vector<float>& envelope, const std::vector<float>& periods) {
+    const int n = (int)envelope.size();
+    std::vector<int> beats;
+
+    // Onset strength in units of its standard deviation, so TIGHTNESS means the same for every track
+    float mean = std::accumulate(envelope.begin(), envelope.end(), 0.0f) / n;
+    float variance = 0.0f;
+    for (float value : envelope) {
+        variance += (value - mean) * (value - mean);
+    }
+    float deviation = std::sqrt(variance / n);
+    if (deviation <= 0.0f) return beats;
+
+    // best[i]: score of the best beat sequence ending at i; previous[i]: the beat before it
+    std::vector<float> best(n);
+    std::vector<int> previous(n, -1);
+    for (int i = 0; i < n; i++) {
+        const float period = periods[i];
+        const int first = std::max(0, i - (int)std::round(2.0f * period));
+        const int last = i - (int)std::round(0.5f * period);
+
+        float bestPrevious = 0.0f;
+        for (int j = first; j <= last; j++) {
+            float deviationFromPeriod = std::log((i - j) / period);
+            float candidate = best[j] - TIGHTNESS * deviationFromPeriod * deviationFromPeriod;
+            if (previous[i] < 0 || candidate > bestPrevious) {
+                bestPrevious = candidate;
+                previous[i] = j;
+            }
+        }
+        best[i] = envelope[i] / deviation + (previous[i] >= 0 ? bestPrevious : 0.0f);
+    }
+
+    // The sequence ends at its best-scoring frame within the last period
+    int end = n - 1;
+    for (int i = std::max(0, n - (int)std::round(periods[n - 1])); i < n; i++) {
+        if (best[i] > best[end]) end = i;
+    }
+
+    for (int i = end; i >= 0; i = previous[i]) {
+        beats.push_back(i);
+    }
+    std::reverse(beats.begin(), beats.end());
+
+    return beats;
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,254 @@
+// Library clustering - all-pairs nearest neighbours and k-means over HAMMS, mood, tempo and key
+
+#include "ai_algorithms.h"
+#include <random>
+#include <stdexcept>
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🗂️ LIBRARY CLUSTERING
+// ========================================
+
+namespace {
+
+const float UNIT_WEIGHTS[LibraryClustering::DIMENSIONS] = {
+    1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f
+};
+
+const float TWO_PI = 6.28318530718f;
+
+float orNeutral(float value) {
+    return std::isnan(value) ? 0.5f : std::max(0.0f, std::min(1.0f, value));
+}
+
+// Runs body(begin, end) over [0, count) in blocks of blockSize, spread over the pool
+template <typename Body>
+void forEachBlock(ThreadPool& pool, size_t count, size_t blockSize, Body body) {
+    TaskGraph graph;
+    for (size_t begin = 0; begin < count; begin += blockSize) {
+        const size_t end = std::min(count, begin + blockSize);
+        graph.addTask([&body, begin, end]() { body(begin, end); });
+    }
+    graph.run(pool);
+}
+
+} // namespace
+
+LibraryClustering::LibraryClustering(const std::vector<TrackFeatures>& tracks, const ClusteringOptions& options)
+    : options(options) {
+    if (options.hammsWeight < 0 || options.moodWeight < 0 || options.tempoWeight < 0 || options.keyWeight < 0) {
+        throw std::invalid_argument("LibraryClustering: weights must not be negative");
+    }
+
+    // Each group's largest possible squared distance: unit ranges, circles of diameter 1
+    maxDistance = 7.0f * options.hammsWeight + 3.0f * options.moodWeight + options.tempoWeight + options.keyWeight;
+    if (!(maxDistance > 0.0f)) {
+        throw std::invalid_argument("LibraryClustering: at least one weight must be positive");
+    }
+
+    for (auto& column : columns) column.resize(tracks.size());
+    float values[DIMENSIONS];
+    for (size_t i = 0; i < tracks.size(); i++) {
+        embed(tracks[i], values);
+        for (int d = 0; d < DIMENSIONS; d++) columns[d][i] = values[d];
+    }
+}
+
+void LibraryClustering::embed(const TrackFeatures& track, float* values) const {
+    const float hamms = std::sqrt(options.hammsWeight);
+    const float mood = std::sqrt(options.moodWeight);
+    const float tempo = 0.5f * std::sqrt(options.tempoWeight);
+    const float key = 0.5f * std::sqrt(options.keyWeight);
+
+    HAMMSBatch::toArray(track.hamms, values);
+    for (int d = 0; d < HAMMSBatch::DIMENSIONS; d++) values[d] *= hamms;
+
+    values[7] = orNeutral(track.energy) * mood;
+    values[8] = orNeutral(track.valence) * mood;
+    values[9] = orNeutral(track.danceability) * mood;
+
+    // log2 tempo modulo 1: 64, 128 and 256 BPM land on the same angle
+    if (track.bpm > 0.0f && std::isfinite(track.bpm)) {
+        float angle = TWO_PI * std::log2(track.bpm);
+        values[10] = tempo * std::cos(angle);
+        values[11] = tempo * std::sin(angle);
+    } else {
+        values[10] = values[11] = 0.0f;
+    }
+
+    // Circle of fifths, a minor key at its relative major: neighbours mix harmonically
+    if (track.key >= 0 && track.key < 24) {
+        int root = track.key / 2;
+        int major = track.key % 2 ? (root + 3) % 12 : root;
+        float angle = TWO_PI * ((major * 7) % 12) / 12.0f;
+        values[12] = key * std::cos(angle);
+        values[13] = key * std::sin(angle);
+    } else {
+        values[12] = values[13] = 0.0f;
+    }
+}
+
+void LibraryClustering::point(size_t index, float* values) const {
+    for (int d = 0; d < DIMENSIONS; d++) values[d] = columns[d][index];
+}
+
+NeighborGraph LibraryClustering::nearestNeighbors(size_t k) const {
+    const size_t count = size();
+    NeighborGraph graph;
+    graph.k = count > 1 ? std::min(k, count - 1) : 0;
+    if (graph.k == 0) return graph;
+
+    graph.neighbors.resize(count * graph.k);
+    graph.similarities.resize(count * graph.k);
+
+    forEachBlock(pool(), count, QUERY_TILE, [this, &graph, count](size_t begin, size_t end) {
+        float queries[QUERY_TILE][DIMENSIONS];
+        std::vector<NearestSelection> nearest;
+        nearest.reserve(end - begin);
+        for (size_t q = begin; q < end; q++) {
+            point(q, queries[q - begin]);
+            nearest.emplace_back(graph.k);
+        }
+
+        // Candidate tile outer, queries inner: the tile is read from memory once per QUERY_TILE queries
+        std::vector<float> distances(CANDIDATE_TILE);
+        const float* rows[DIMENSIONS];
+        for (size_t first = 0; first < count; first += CANDIDATE_TILE) {
+            const size_t tile = std::min(CANDIDATE_TILE, count - first);
+            for (int d = 0; d < DIMENSIONS; d++) rows[d] = columns[d].data() + first;
+
+            for (size_t q = begin; q < end; q++) {
+                NearestSelection& selection = nearest[q - begin];
+                VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, queries[q - begin], UNIT_WEIGHTS,
+                                                        distances.data(), tile);
+                float bound = selection.bound();
+                for (size_t i = 0; i < tile; i++) {
+                    if (distances[i] > bound || first + i == q) continue;
+                    selection.offer(distances[i], first + i);
+                    bound = selection.bound();
+                }
+            }
+        }
+
+        for (size_t q = begin; q < end; q++) {
+            size_t slot = q * graph.k;
+            for (const auto& candidate : nearest[q - begin].take()) {
+                graph.neighbors[slot] = (uint32_t)candidate.second;
+                graph.similarities[slot] = similarity(candidate.first);
+                slot++;
+            }
+        }
+    });
+
+    return graph;
+}
+
+TrackClusters LibraryClustering::kMeans(int clusters, int maxIterations, uint32_t seed) const {
+    const size_t count = size();
+    if (clusters <= 0) clusters = (int)std::lround(std::sqrt(count / 2.0));
+    clusters = (int)std::min<size_t>(std::max(clusters, 1), count);
+
+    TrackClusters result;
+    if (count == 0) return result;
+    result.count = clusters;
+    result.assignments.assign(count, -1);
+
+    AlignedFloats centroids[DIMENSIONS];
+    for (auto& column : centroids) column.resize(clusters);
+    auto setCentroid = [&centroids](int c, const float* values) {
+        for (int d = 0; d < DIMENSIONS; d++) centroids[d][c] = values[d];
+    };
+
+    // k-means++: each seed drawn with probability proportional to its squared distance from the nearest one
+    std::mt19937 random(seed);
+    std::vector<float> nearestDistance(count, std::numeric_limits<float>::infinity());
+    float values[DIMENSIONS];
+    size_t chosen = std::uniform_int_distribution<size_t>(0, count - 1)(random);
+    for (int c = 0; c < clusters; c++) {
+        point(chosen, values);
+        setCentroid(c, values);
+        if (c + 1 == clusters) break;
+
+        forEachBlock(pool(), count, POINT_BLOCK, [&](size_t begin, size_t end) {
+            float distances[POINT_BLOCK];
+            const float* rows[DIMENSIONS];
+            for (int d = 0; d < DIMENSIONS; d++) rows[d] = columns[d].data() + begin;
+            VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, values, UNIT_WEIGHTS, distances, end - begin);
+            for (size_t i = begin; i < end; i++) {
+                nearestDistance[i] = std::min(nearestDistance[i], distances[i - begin]);
+            }
+        });
+
+        double total = 0.0;
+        for (float distance : nearestDistance) total += distance;
+        if (!(total > 0.0)) {
+            // Fewer distinct tracks than clusters: the remaining seeds repeat a point
+            chosen = std::uniform_int_distribution<size_t>(0, count - 1)(random);
+            continue;
+        }
+        double target = std::uniform_real_distribution<double>(0.0, total)(random);
+        for (chosen = 0; chosen + 1 < count; chosen++) {
+            target -= nearestDistance[chosen];
+            if (target < 0.0) break;
+        }
+    }
+
+    // Lloyd: assign every track to its nearest centroid, move each centroid to its tracks' mean.
+    // Blocks keep their own sums, merged afterwards, so no two tasks write the same memory.
+    struct BlockSums {
+        std::vector<double> sums;
+        std::vector<size_t> sizes;
+        size_t changed = 0;
+    };
+    const size_t blockCount = (count + POINT_BLOCK - 1) / POINT_BLOCK;
+    std::vector<BlockSums> blocks(blockCount);
+
+    for (int iteration = 0; iteration < maxIterations; iteration++) {
+        forEachBlock(pool(), count, POINT_BLOCK, [&](size_t begin, size_t end) {
+            BlockSums& block = blocks[begin / POINT_BLOCK];
+            block.sums.assign((size_t)clusters * DIMENSIONS, 0.0);
+            block.sizes.assign(clusters, 0);
+            block.changed = 0;
+
+            std::vector<float> distances(clusters);
+            const float* rows[DIMENSIONS];
+            for (int d = 0; d < DIMENSIONS; d++) rows[d] = centroids[d].data();
+            float query[DIMENSIONS];
+            for (size_t i = begin; i < end; i++) {
+                point(i, query);
+                VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, query, UNIT_WEIGHTS,
+                                                        distances.data(), clusters);
+                int best = (int)(std::min_element(distances.begin(), distances.end()) - distances.begin());
+
+                if (result.assignments[i] != best) block.changed++;
+                result.assignments[i] = best;
+                block.sizes[best]++;
+                double* sum = block.sums.data() + (size_t)best * DIMENSIONS;
+                for (int d = 0; d < DIMENSIONS; d++) sum[d] += query[d];
+            }
+        });
+
+        size_t changed = 0;
+        std::vector<double> sums((size_t)clusters * DIMENSIONS, 0.0);
+        result.sizes.assign(clusters, 0);
+        for (const auto& block : blocks) {
+            changed += block.changed;
+            for (int c = 0; c < clusters; c++) result.sizes[c] += block.sizes[c];
+            for (size_t i = 0; i < sums.size(); i++) sums[i] += block.sums[i];
+        }
+        if (changed == 0) break;
+
+        // An empty cluster keeps its centroid
+        for (int c = 0; c < clusters; c++) {
+            if (result.sizes[c] == 0) continue;
+            for (int d = 0; d < DIMENSIONS; d++) {
+                centroids[d][c] = (float)(sums[(size_t)c * DIMENSIONS + d] / result.sizes[c]);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,124 @@
+// Shared per-track analysis context - features computed once, on demand, for all analyzers
+
+#include "ai_algorithms.h"
+#include <stdexcept>
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🧠 SHARED ANALYSIS CONTEXT
+// ========================================
+
+namespace {
+
+// Derived features pull in what they are built from
+uint32_t withSources(uint32_t features) {
+    if (features & FEATURE_CHROMA) features |= FEATURE_SPECTRUM;
+    if (features & FEATURE_ONSET_ENVELOPE) features |= FEATURE_STFT;
+    if (features & FEATURE_DESCRIPTORS) features |= FEATURE_STFT;
+    return features;
+}
+
+} // namespace
+
+AnalysisContext::AnalysisContext(const AudioBuffer& audio, uint32_t features)
+    : audioRef(audio), available(withSources(features)) {}
+
+AnalysisContext::AnalysisContext(const AudioBuffer& audio, SpectralFeatures spectrum, Chromagram chromagram,
+                                 uint32_t features)
+    : audioRef(audio), available(withSources(features) | FEATURE_SPECTRUM),
+      wholeTrackSpectrum(std::move(spectrum)), frameChroma(std::move(chromagram)) {
+    // Already provided
+    std::call_once(spectrumOnce, []() {});
+    if (frameChroma.numFrames > 0) {
+        std::call_once(chromagramOnce, []() {});
+    }
+}
+
+const SpectralFeatures& AnalysisContext::spectrum() const {
+    require(FEATURE_SPECTRUM, "spectrum");
+    std::call_once(spectrumOnce, [this]() {
+        wholeTrackSpectrum = AudioProcessor::calculateSpectralFeatures(audioRef);
+    });
+    return wholeTrackSpectrum;
+}
+
+const ChromaVector& AnalysisContext::chroma() const {
+    require(FEATURE_CHROMA, "chroma");
+    std::call_once(chromaOnce, [this]() {
+        chromaVector = AudioProcessor::calculateChroma(spectrum());
+    });
+    return chromaVector;
+}
+
+const STFTFrames& AnalysisContext::stft() const {
+    require(FEATURE_STFT, "STFT");
+    std::call_once(stftOnce, [this]() {
+        frames = AudioProcessor::calculateSTFT(audioRef.samples, FRAME_SIZE, HOP_SIZE);
+    });
+    return frames;
+}
+
+const std::vector<float>& AnalysisContext::onsetEnvelope() const {
+    require(FEATURE_ONSET_ENVELOPE, "onset envelope");
+    std::call_once(fluxOnce, [this]() {
+        spectralFlux = BPMDetector::calculateSpectralFlux(stft());
+    });
+    return spectralFlux;
+}
+
+const PitchTrack& AnalysisContext::pitch() const {
+    require(FEATURE_PITCH, "pitch track");
+    std::call_once(pitchOnce, [this]() {
+        pitchTrack = PitchTracker::track(audioRef.samples, audioRef.sampleRate);
+    });
+    return pitchTrack;
+}
+
+const Chromagram& AnalysisContext::chromagram() const {
+    require(FEATURE_CHROMAGRAM, "chromagram");
+    std::call_once(chromagramOnce, [this]() {
+        frameChroma = AudioProcessor::calculateChromagram(audioRef.samples, audioRef.sampleRate,
+                                                          CHROMA_FRAME_SIZE, CHROMA_HOP_SIZE);
+    });
+    return frameChroma;
+}
+
+const EnergyPrefixSum& AnalysisContext::energy() const {
+    require(FEATURE_ENERGY, "sample energy");
+    std::call_once(energyOnce, [this]() {
+        sampleEnergy = EnergyPrefixSum(audioRef.samples);
+    });
+    return sampleEnergy;
+}
+
+const SpectralDescriptors& AnalysisContext::descriptors() const {
+    require(FEATURE_DESCRIPTORS, "spectral descriptors");
+    std::call_once(descriptorsOnce, [this]() {
+        frameDescriptors = SpectralDescriptorExtractor::extract(stft(), audioRef.sampleRate);
+    });
+    return frameDescriptors;
+}
+
+const OnsetVector& AnalysisContext::onsets() const {
+    std::call_once(onsetsOnce, [this]() {
+        BPMDetector detector;
+        onsetList = detector.detectOnsets(onsetEnvelope(), audioRef.sampleRate);
+    });
+    return onsetList;
+}
+
+const BeatTrack& AnalysisContext::beatTrack() const {
+    std::call_once(beatTrackOnce, [this]() {
+        beatGrid = BeatTracker::track(onsetEnvelope(), audioRef.sampleRate);
+    });
+    return beatGrid;
+}
+
+void AnalysisContext::require(uint32_t feature, const char* name) const {
+    if (!has(feature)) {
+        throw std::logic_error(std::string("AnalysisContext: ") + name + " was not requested for this track");
+    }
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,156 @@
+// Audio file decoding - chunked libsndfile reads downmixed to mono
+
+#include "ai_algorithms.h"
+#include <sndfile.h>
+#include <stdexcept>
+#include <limits>
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🎧 AUDIO FILE DECODING
+// ========================================
+
+namespace {
+
+std::string lowercaseExtension(const std::string& filePath) {
+    size_t dot = filePath.find_last_of('.');
+    if (dot == std::string::npos) return "";
+
+    std::string ext = filePath.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext;
+}
+
+// Owns an open libsndfile handle and one interleaved block buffer
+class SndfileReader {
+public:
+    explicit SndfileReader(const std::string& filePath) {
+        file = sf_open(filePath.c_str(), SFM_READ, &info);
+
+        if (!file) {
+            std::string message = "Could not open audio file: " + filePath + " (" + sf_strerror(nullptr) + ")";
+
+            // libsndfile has no AAC decoder, and MP3 needs libsndfile >= 1.1.0
+            std::string ext = lowercaseExtension(filePath);
+            if (ext == ".m4a" || ext == ".aac" || ext == ".mp4") {
+                message += " - AAC/M4A is not supported by libsndfile";
+            } else if (ext == ".mp3") {
+                message += " - MP3 requires libsndfile 1.1.0 or newer";
+            }
+            throw std::runtime_error(message);
+        }
+
+        if (info.channels <= 0 || info.samplerate <= 0) {
+            sf_close(file);
+            throw std::runtime_error("Invalid audio stream in: " + filePath);
+        }
+
+        if (info.channels > 1) {
+            interleaved.resize(AudioDecoder::CHUNK_FRAMES * info.channels);
+        }
+    }
+
+    ~SndfileReader() {
+        sf_close(file);
+    }
+
+    SndfileReader(const SndfileReader&) = delete;
+    SndfileReader& operator=(const SndfileReader&) = delete;
+
+    // Frame count from the header; 0 when the container does not know it
+    size_t expectedFrames() const {
+        if (info.frames <= 0 || info.frames == std::numeric_limits<sf_count_t>::max()) return 0;
+        return static_cast<size_t>(info.frames);
+    }
+
+    // Reads up to CHUNK_FRAMES frames as mono into out; returns frames read (0 at end)
+    size_t readMono(float* out, size_t maxFrames) {
+        sf_count_t frames = static_cast<sf_count_t>(std::min(maxFrames, AudioDecoder::CHUNK_FRAMES));
+
+        if (info.channels == 1) {
+            sf_count_t read = sf_readf_float(file, out, frames);
+            return read > 0 ? static_cast<size_t>(read) : 0;
+        }
+
+        sf_count_t read = sf_readf_float(file, interleaved.data(), frames);
+        if (read <= 0) return 0;
+
+        // Downmix in the same pass
+        const int channels = info.channels;
+        const float scale = 1.0f / channels;
+        for (sf_count_t i = 0; i < read; i++) {
+            const float* frame = interleaved.data() + i * channels;
+            float sum = 0.0f;
+            for (int c = 0; c < channels; c++) {
+                sum += frame[c];
+            }
+            out[i] = sum * scale;
+        }
+        return static_cast<size_t>(read);
+    }
+
+    SF_INFO info = {};
+
+private:
+    SNDFILE* file = nullptr;
+    std::vector<float> interleaved;
+};
+
+} // namespace
+
+AudioBuffer AudioDecoder::decodeFile(const std::string& filePath) {
+    SndfileReader reader(filePath);
+
+    // Sized from the header so every block is downmixed straight into place
+    std::vector<float> samples(reader.expectedFrames());
+    size_t decoded = 0;
+    size_t read;
+    while (decoded < samples.size() &&
+           (read = reader.readMono(samples.data() + decoded, samples.size() - decoded)) > 0) {
+        decoded += read;
+    }
+    samples.resize(decoded);
+
+    // Headers can omit or under-report the length; append whatever follows
+    std::vector<float> block(CHUNK_FRAMES);
+    while ((read = reader.readMono(block.data(), block.size())) > 0) {
+        samples.insert(samples.end(), block.begin(), block.begin() + read);
+    }
+
+    if (samples.empty()) {
+        throw std::runtime_error("Could not read samples from: " + filePath);
+    }
+
+    return AudioBuffer(std::move(samples), reader.info.samplerate, 1);
+}
+
+AudioStreamInfo AudioDecoder::decodeStream(const std::string& filePath, const AudioChunkCallback& onChunk,
+                                           const std::function<void(const AudioStreamInfo&)>& onOpen) {
+    SndfileReader reader(filePath);
+
+    AudioStreamInfo stream;
+    stream.sampleRate = reader.info.samplerate;
+    stream.channels = reader.info.channels;
+
+    if (onOpen) {
+        AudioStreamInfo header = stream;
+        header.frames = static_cast<int64_t>(reader.expectedFrames());
+        onOpen(header);
+    }
+
+    std::vector<float> block(CHUNK_FRAMES);
+    size_t read;
+    while ((read = reader.readMono(block.data(), block.size())) > 0) {
+        onChunk(block.data(), read);
+        stream.frames += read;
+    }
+
+    if (stream.frames == 0) {
+        throw std::runtime_error("Could not read samples from: " + filePath);
+    }
+
+    return stream;
+}
+
+} // namespace MusicAnalysis
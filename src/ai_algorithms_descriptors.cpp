@@ -0,0 +1,103 @@
+// Spectral descriptors - centroid, rolloff, flatness, entropy, flux and bandwidth of every STFT frame
+
+#include "ai_algorithms.h"
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🎨 SPECTRAL DESCRIPTORS
+// ========================================
+
+SpectralDescriptors SpectralDescriptorExtractor::extract(const STFTFrames& frames, int sampleRate) {
+    SpectralDescriptors result;
+    result.sampleRate = sampleRate;
+    result.hopSize = frames.hopSize;
+    if (frames.numFrames == 0 || frames.numBins < 2) return result;
+
+    const size_t count = frames.numFrames;
+    const size_t bins = frames.numBins;
+    const float binWidth = (float)sampleRate / frames.frameSize;
+    const float logBins = std::log((float)bins);
+
+    result.centroid.resize(count);
+    result.rolloff.resize(count);
+    result.flatness.resize(count);
+    result.entropy.resize(count);
+    result.flux.resize(count);
+    result.bandwidth.resize(count);
+    std::vector<uint8_t> active(count, 0);
+
+    for (int f = 0; f < frames.numFrames; f++) {
+        const float* magnitude = frames.frame(f);
+        result.flux[f] = f > 0 ? VectorKernels::positiveDifferenceSum(magnitude, frames.frame(f - 1), bins) : 0.0f;
+
+        const SpectralMoments sums = VectorKernels::spectralMoments(magnitude, bins);
+        if (sums.magnitude <= 0.0f || sums.power <= 0.0f) continue;  // Silent frame: all zero
+        active[f] = 1;
+
+        // Centroid and bandwidth are the mean and spread of the bin index under the magnitude
+        float meanIndex = sums.indexWeighted / sums.magnitude;
+        float spread = sums.indexSquaredWeighted / sums.magnitude - meanIndex * meanIndex;
+        result.centroid[f] = meanIndex * binWidth;
+        result.bandwidth[f] = std::sqrt(std::max(spread, 0.0f)) * binWidth;
+
+        // exp(mean ln m) / mean m
+        result.flatness[f] = std::min(1.0f, std::exp(sums.logMagnitude / bins) / (sums.magnitude / bins));
+
+        // With p = m² / P: H = -Σ p ln p = ln P - 2 Σ m² ln m / P
+        float entropy = std::log(sums.power) - 2.0f * sums.powerLogMagnitude / sums.power;
+        result.entropy[f] = std::max(0.0f, std::min(1.0f, entropy / logBins));
+
+        result.rolloff[f] = rolloffBin(magnitude, bins, sums.power) * binWidth;
+    }
+
+    result.centroidSummary = summarize(result.centroid, active);
+    result.rolloffSummary = summarize(result.rolloff, active);
+    result.flatnessSummary = summarize(result.flatness, active);
+    result.entropySummary = summarize(result.entropy, active);
+    result.fluxSummary = summarize(result.flux, active);
+    result.bandwidthSummary = summarize(result.bandwidth, active);
+
+    return result;
+}
+
+size_t SpectralDescriptorExtractor::rolloffBin(const float* magnitude, size_t count, float totalPower) {
+    const size_t BLOCK = 64;
+    const float threshold = ROLLOFF_FRACTION * totalPower;
+
+    // Whole blocks while the threshold is out of reach, then bin by bin
+    float cumulative = 0.0f;
+    size_t i = 0;
+    for (; i + BLOCK <= count; i += BLOCK) {
+        float block = VectorKernels::sumOfSquares(magnitude + i, BLOCK);
+        if (cumulative + block >= threshold) break;
+        cumulative += block;
+    }
+    for (; i < count; i++) {
+        cumulative += magnitude[i] * magnitude[i];
+        if (cumulative >= threshold) return i;
+    }
+
+    return 0;
+}
+
+DescriptorSummary SpectralDescriptorExtractor::summarize(const std::vector<float>& values,
+                                                         const std::vector<uint8_t>& active) {
+    DescriptorSummary summary;
+    double sum = 0.0, squares = 0.0;
+    size_t used = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (!active[i]) continue;
+        sum += values[i];
+        squares += (double)values[i] * values[i];
+        used++;
+    }
+    if (used == 0) return summary;
+
+    double mean = sum / used;
+    summary.mean = static_cast<float>(mean);
+    summary.deviation = static_cast<float>(std::sqrt(std::max(0.0, squares / used - mean * mean)));
+    return summary;
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,407 @@
+// FFT engine - cached FFTW plans and optional persistent wisdom
+
+#include "ai_algorithms.h"
+#include <fftw3.h>
+#include <mutex>
+#include <iostream>
+
+namespace MusicAnalysis {
+
+// ========================================
+// ⚙️ FFT PLAN CACHE
+// ========================================
+
+namespace {
+
+// FFTW plans are only valid for arrays with the alignment they were planned on
+struct PlanKey {
+    int size;
+    int batch;      // Number of transforms per execution (1 = single FFT)
+    int alignment;
+
+    bool operator<(const PlanKey& other) const {
+        if (size != other.size) return size < other.size;
+        if (batch != other.batch) return batch < other.batch;
+        return alignment < other.alignment;
+    }
+};
+
+class FFTPlanCache {
+public:
+    static FFTPlanCache& instance() {
+        static FFTPlanCache cache;
+        return cache;
+    }
+
+    ~FFTPlanCache() {
+        std::lock_guard<std::mutex> lock(plannerMutex);
+        for (auto& entry : r2cPlans) {
+            fftwf_destroy_plan(entry.second);
+        }
+        for (auto& entry : c2rPlans) {
+            fftwf_destroy_plan(entry.second);
+        }
+    }
+
+    // Returns a plan usable with fftwf_execute_dft_r2c on any arrays of this alignment.
+    // Batched plans transform `batch` contiguous frames of `size` samples into
+    // `batch` contiguous rows of size/2 + 1 bins.
+    fftwf_plan getR2C(int size, int alignment, int batch = 1) {
+        std::lock_guard<std::mutex> lock(plannerMutex);
+
+        PlanKey key{size, batch, alignment};
+        auto it = r2cPlans.find(key);
+        if (it != r2cPlans.end()) return it->second;
+
+        // Plan on scratch arrays so FFTW_MEASURE never clobbers caller data
+        int bins = size / 2 + 1;
+        float* in = (float*)fftwf_malloc(sizeof(float) * size * batch);
+        fftwf_complex* out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * bins * batch);
+        unsigned alignFlag = alignment == 0 ? 0 : FFTW_UNALIGNED;
+
+        // Prefer measured plans from wisdom, fall back to an estimate
+        unsigned rigor = measurePlans ? FFTW_MEASURE : FFTW_ESTIMATE;
+        fftwf_plan plan = createPlan(size, batch, in, out, FFTW_MEASURE | FFTW_WISDOM_ONLY | alignFlag);
+        if (!plan) {
+            plan = createPlan(size, batch, in, out, rigor | alignFlag);
+        }
+
+        fftwf_free(in);
+        fftwf_free(out);
+
+        r2cPlans[key] = plan;
+        return plan;
+    }
+
+    // Inverse of getR2C: size/2 + 1 bins back to size real samples (unnormalized).
+    // FFTW c2r transforms overwrite their input.
+    fftwf_plan getC2R(int size, int alignment) {
+        std::lock_guard<std::mutex> lock(plannerMutex);
+
+        PlanKey key{size, 1, alignment};
+        auto it = c2rPlans.find(key);
+        if (it != c2rPlans.end()) return it->second;
+
+        int bins = size / 2 + 1;
+        fftwf_complex* in = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * bins);
+        float* out = (float*)fftwf_malloc(sizeof(float) * size);
+        unsigned alignFlag = alignment == 0 ? 0 : FFTW_UNALIGNED;
+
+        unsigned rigor = measurePlans ? FFTW_MEASURE : FFTW_ESTIMATE;
+        fftwf_plan plan = fftwf_plan_dft_c2r_1d(size, in, out, FFTW_MEASURE | FFTW_WISDOM_ONLY | alignFlag);
+        if (!plan) {
+            plan = fftwf_plan_dft_c2r_1d(size, in, out, rigor | alignFlag);
+        }
+
+        fftwf_free(in);
+        fftwf_free(out);
+
+        c2rPlans[key] = plan;
+        return plan;
+    }
+
+    bool importWisdom(const std::string& path) {
+        std::lock_guard<std::mutex> lock(plannerMutex);
+        measurePlans = true;
+        return fftwf_import_wisdom_from_filename(path.c_str()) != 0;
+    }
+
+    bool exportWisdom(const std::string& path) {
+        std::lock_guard<std::mutex> lock(plannerMutex);
+        return fftwf_export_wisdom_to_filename(path.c_str()) != 0;
+    }
+
+private:
+    FFTPlanCache() = default;
+
+    static fftwf_plan createPlan(int size, int batch, float* in, fftwf_complex* out, unsigned flags) {
+        if (batch == 1) {
+            return fftwf_plan_dft_r2c_1d(size, in, out, flags);
+        }
+        int bins = size / 2 + 1;
+        return fftwf_plan_many_dft_r2c(1, &size, batch,
+                                       in, nullptr, 1, size,
+                                       out, nullptr, 1, bins,
+                                       flags);
+    }
+
+    std::mutex plannerMutex;  // FFTW planner calls are not thread-safe
+    std::map<PlanKey, fftwf_plan> r2cPlans;
+    std::map<PlanKey, fftwf_plan> c2rPlans;
+    bool measurePlans = false;
+};
+
+// Per-thread aligned transform buffers, grown on demand
+struct FFTScratch {
+    float* in = nullptr;
+    fftwf_complex* out = nullptr;
+    size_t inCapacity = 0;
+    size_t outCapacity = 0;
+
+    ~FFTScratch() {
+        if (in) fftwf_free(in);
+        if (out) fftwf_free(out);
+    }
+
+    void reserve(size_t inSize, size_t outSize) {
+        if (inSize > inCapacity) {
+            if (in) fftwf_free(in);
+            in = (float*)fftwf_malloc(sizeof(float) * inSize);
+            inCapacity = inSize;
+        }
+        if (outSize > outCapacity) {
+            if (out) fftwf_free(out);
+            out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * outSize);
+            outCapacity = outSize;
+        }
+    }
+};
+
+FFTScratch& threadScratch() {
+    thread_local FFTScratch scratch;
+    return scratch;
+}
+
+// Frames transformed per batched execution; keeps the frame matrix around 1 MB
+int stftBatchSize(int frameSize) {
+    const int targetSamples = 1 << 18;
+    return std::max(1, std::min(64, targetSamples / frameSize));
+}
+
+} // namespace
+
+std::vector<std::complex<float>> AudioProcessor::calculateFFT(SampleSpan signal) {
+    int N = signal.size();
+    if (N == 0) return {};
+
+    FFTScratch& scratch = threadScratch();
+    scratch.reserve(N, N/2 + 1);
+
+    // Copy input data
+    std::copy(signal.begin(), signal.end(), scratch.in);
+
+    fftwf_plan plan = FFTPlanCache::instance().getR2C(N, fftwf_alignment_of(scratch.in));
+    fftwf_execute_dft_r2c(plan, scratch.in, scratch.out);
+
+    // Convert to std::complex
+    std::vector<std::complex<float>> result(N/2 + 1);
+    for (int i = 0; i < N/2 + 1; i++) {
+        result[i] = std::complex<float>(scratch.out[i][0], scratch.out[i][1]);
+    }
+
+    return result;
+}
+
+// ========================================
+// 🎞️ BATCHED STFT ENGINE
+// ========================================
+
+STFTFrames AudioProcessor::calculateSTFT(SampleSpan signal, int frameSize, int hopSize) {
+    STFTFrames stft;
+    stft.frameSize = frameSize;
+    stft.hopSize = hopSize;
+    stft.numBins = frameSize / 2 + 1;
+    stft.numFrames = (int)signal.size() >= frameSize
+        ? ((int)signal.size() - frameSize) / hopSize + 1
+        : 0;
+    if (stft.numFrames == 0) return stft;
+
+    stft.magnitudes.resize(static_cast<size_t>(stft.numFrames) * stft.numBins);
+
+    // Frames are written straight into one aligned matrix and transformed together
+    const int batch = stftBatchSize(frameSize);
+    FFTScratch& scratch = threadScratch();
+    scratch.reserve(static_cast<size_t>(frameSize) * batch, static_cast<size_t>(stft.numBins) * batch);
+
+    fftwf_plan plan = FFTPlanCache::instance().getR2C(frameSize, fftwf_alignment_of(scratch.in), batch);
+
+    for (int first = 0; first < stft.numFrames; first += batch) {
+        int count = std::min(batch, stft.numFrames - first);
+
+        for (int b = 0; b < count; b++) {
+            const float* src = signal.data() + static_cast<size_t>(first + b) * hopSize;
+            std::copy(src, src + frameSize, scratch.in + static_cast<size_t>(b) * frameSize);
+        }
+        // Zero the unused tail of the final block
+        std::fill(scratch.in + static_cast<size_t>(count) * frameSize,
+                  scratch.in + static_cast<size_t>(batch) * frameSize, 0.0f);
+
+        fftwf_execute_dft_r2c(plan, scratch.in, scratch.out);
+
+        float* dst = stft.magnitudes.data() + static_cast<size_t>(first) * stft.numBins;
+        size_t values = static_cast<size_t>(count) * stft.numBins;
+        VectorKernels::complexMagnitude(reinterpret_cast<const std::complex<float>*>(scratch.out), dst, values);
+    }
+
+    return stft;
+}
+
+// ========================================
+// 🎤 FFT-BASED YIN DIFFERENCE
+// ========================================
+
+struct YinDifference::State {
+    int windowSize = 0;
+    int halfSize = 0;
+    int fftSize = 0;
+    int bins = 0;
+    
+    float* frame = nullptr;              // Zero-padded input, then the correlation output
+    fftwf_complex* windowSpectrum = nullptr;
+    fftwf_complex* headSpectrum = nullptr;
+    fftwf_plan forward = nullptr;
+    fftwf_plan inverse = nullptr;
+    
+    std::vector<double> energyPrefix;    // energyPrefix[k] = sum of x[j]² for j < k
+    std::vector<float> diff;
+    
+    ~State() {
+        if (frame) fftwf_free(frame);
+        if (windowSpectrum) fftwf_free(windowSpectrum);
+        if (headSpectrum) fftwf_free(headSpectrum);
+    }
+};
+
+YinDifference::YinDifference(int windowSize)
+    : state(std::make_unique<State>()) {
+    State& s = *state;
+    s.windowSize = std::max(windowSize, 2);
+    s.halfSize = s.windowSize / 2;
+    
+    // Lags never wrap: j + tau < 2 * halfSize <= windowSize <= fftSize
+    s.fftSize = 1;
+    while (s.fftSize < s.windowSize) s.fftSize <<= 1;
+    s.bins = s.fftSize / 2 + 1;
+    
+    s.frame = (float*)fftwf_malloc(sizeof(float) * s.fftSize);
+    s.windowSpectrum = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * s.bins);
+    s.headSpectrum = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * s.bins);
+    s.forward = FFTPlanCache::instance().getR2C(s.fftSize, fftwf_alignment_of(s.frame));
+    s.inverse = FFTPlanCache::instance().getC2R(s.fftSize, fftwf_alignment_of(s.frame));
+    
+    s.energyPrefix.resize(s.windowSize + 1);
+    s.diff.resize(s.halfSize);
+}
+
+YinDifference::~YinDifference() = default;
+
+const std::vector<float>& YinDifference::compute(SampleSpan window) {
+    State& s = *state;
+    const int W = std::min(s.windowSize, static_cast<int>(window.size()));
+    const int H = s.halfSize;
+    
+    s.energyPrefix[0] = 0.0;
+    for (int j = 0; j < s.windowSize; j++) {
+        float x = j < W ? window[j] : 0.0f;
+        s.energyPrefix[j + 1] = s.energyPrefix[j] + static_cast<double>(x) * x;
+    }
+    
+    // Spectrum of the whole window
+    std::copy(window.begin(), window.begin() + W, s.frame);
+    std::fill(s.frame + W, s.frame + s.fftSize, 0.0f);
+    fftwf_execute_dft_r2c(s.forward, s.frame, s.windowSpectrum);
+    
+    // Spectrum of its first half, the segment YIN slides across the window
+    std::fill(s.frame + std::min(H, W), s.frame + s.fftSize, 0.0f);
+    fftwf_execute_dft_r2c(s.forward, s.frame, s.headSpectrum);
+    
+    // r(tau) = sum x[j] x[j + tau] = IFFT(conj(Head) * Window)
+    for (int k = 0; k < s.bins; k++) {
+        float hr = s.headSpectrum[k][0], hi = s.headSpectrum[k][1];
+        float wr = s.windowSpectrum[k][0], wi = s.windowSpectrum[k][1];
+        s.headSpectrum[k][0] = hr * wr + hi * wi;
+        s.headSpectrum[k][1] = hr * wi - hi * wr;
+    }
+    fftwf_execute_dft_c2r(s.inverse, s.headSpectrum, s.frame);
+    
+    const double scale = 1.0 / s.fftSize;
+    const double headEnergy = s.energyPrefix[H];
+    s.diff[0] = 0.0f;
+    for (int tau = 1; tau < H; tau++) {
+        double shiftedEnergy = s.energyPrefix[tau + H] - s.energyPrefix[tau];
+        double d = headEnergy + shiftedEnergy - 2.0 * s.frame[tau] * scale;
+        s.diff[tau] = static_cast<float>(std::max(0.0, d));  // Rounding can dip just below zero
+    }
+    
+    return s.diff;
+}
+
+struct FFTAutocorrelation::State {
+    int windowSize = 0;
+    int maxLag = 0;
+    int fftSize = 0;
+    int bins = 0;
+    
+    float* frame = nullptr;              // Zero-padded input, then the correlation output
+    fftwf_complex* spectrum = nullptr;
+    fftwf_plan forward = nullptr;
+    fftwf_plan inverse = nullptr;
+    
+    std::vector<float> result;
+    
+    ~State() {
+        if (frame) fftwf_free(frame);
+        if (spectrum) fftwf_free(spectrum);
+    }
+};
+
+FFTAutocorrelation::FFTAutocorrelation(int windowSize, int maxLag)
+    : state(std::make_unique<State>()) {
+    State& s = *state;
+    s.windowSize = std::max(windowSize, 1);
+    s.maxLag = std::max(0, std::min(maxLag, s.windowSize - 1));
+    
+    // Lags never wrap: j + tau < windowSize + maxLag <= fftSize
+    s.fftSize = 1;
+    while (s.fftSize < s.windowSize + s.maxLag) s.fftSize <<= 1;
+    s.bins = s.fftSize / 2 + 1;
+    
+    s.frame = (float*)fftwf_malloc(sizeof(float) * s.fftSize);
+    s.spectrum = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * s.bins);
+    s.forward = FFTPlanCache::instance().getR2C(s.fftSize, fftwf_alignment_of(s.frame));
+    s.inverse = FFTPlanCache::instance().getC2R(s.fftSize, fftwf_alignment_of(s.frame));
+    
+    s.result.resize(s.maxLag + 1);
+}
+
+FFTAutocorrelation::~FFTAutocorrelation() = default;
+
+const std::vector<float>& FFTAutocorrelation::compute(SampleSpan window) {
+    State& s = *state;
+    const int W = std::min(s.windowSize, static_cast<int>(window.size()));
+    
+    std::copy(window.begin(), window.begin() + W, s.frame);
+    std::fill(s.frame + W, s.frame + s.fftSize, 0.0f);
+    fftwf_execute_dft_r2c(s.forward, s.frame, s.spectrum);
+    
+    // r = IFFT(|X|²)
+    for (int k = 0; k < s.bins; k++) {
+        float re = s.spectrum[k][0], im = s.spectrum[k][1];
+        s.spectrum[k][0] = re * re + im * im;
+        s.spectrum[k][1] = 0.0f;
+    }
+    fftwf_execute_dft_c2r(s.inverse, s.spectrum, s.frame);
+    
+    const float scale = 1.0f / s.fftSize;
+    for (int tau = 0; tau <= s.maxLag; tau++) {
+        s.result[tau] = s.frame[tau] * scale;
+    }
+    
+    return s.result;
+}
+
+bool AudioProcessor::enableFFTWisdom(const std::string& path) {
+    bool loaded = FFTPlanCache::instance().importWisdom(path);
+    std::cout << (loaded ? "🧙 FFTW wisdom loaded from " : "🧙 No FFTW wisdom yet at ") << path << std::endl;
+    return loaded;
+}
+
+bool AudioProcessor::saveFFTWisdom(const std::string& path) {
+    bool saved = FFTPlanCache::instance().exportWisdom(path);
+    if (!saved) {
+        std::cerr << "❌ Failed to save FFTW wisdom to " << path << std::endl;
+    }
+    return saved;
+}
+
+} // namespace MusicAnalysis
@@ -5,24 +5,27 @@
 namespace MusicAnalysis {
 
 HAMMSVector HAMMSAnalyzer::calculateHAMMS(const AudioBuffer& audio) {
+    return calculateHAMMS(AnalysisContext(audio));
+}
+
+HAMMSVector HAMMSAnalyzer::calculateHAMMS(const AnalysisContext& context) {
     HAMMSVector hamms;
     
     // Calculate each dimension of the HAMMS vector
-    hamms.harmonicity = analyzeHarmonicity(audio);
-    hamms.melodicity = analyzeMelodicity(audio);
-    hamms.rhythmicity = analyzeRhythmicity(audio);
-    hamms.timbrality = analyzeTimbrality(audio);
-    hamms.dynamics = analyzeDynamics(audio);
-    hamms.tonality = analyzeTonality(audio);
-    hamms.temporality = analyzeTemporality(audio);
+    hamms.harmonicity = analyzeHarmonicity(context);
+    hamms.melodicity = analyzeMelodicity(context);
+    hamms.rhythmicity = analyzeRhythmicity(context);
+    hamms.timbrality = analyzeTimbrality(context);
+    hamms.dynamics = analyzeDynamics(context);
+    hamms.tonality = analyzeTonality(context);
+    hamms.temporality = analyzeTemporality(context);
     
     return hamms;
 }
 
 // Harmonic Analysis
-float HAMMSAnalyzer::analyzeHarmonicity(const AudioBuffer& audio) {
-    AudioProcessor processor;
-    SpectralFeatures features = processor.calculateSpectralFeatures(audio);
+float HAMMSAnalyzer::analyzeHarmonicity(const AnalysisContext& context) {
+    const SpectralFeatures& features = context.spectrum();
     
     float hnr = calculateHarmonicToNoiseRatio(features);
     float harmonicSeries = detectHarmonicSeries(features.magnitude);
@@ -40,7 +43,7 @@ float HAMMSAnalyzer::calculateHarmonicToNoiseRatio(const SpectralFeatures& featu
         totalEnergy += features.magnitude[i] * features.magnitude[i];
         
         // Check if frequency is near a harmonic
-        float freq = features.frequencies[i];
+        float freq = features.frequency(i);
         float fundamental = 100.0f; // Assume fundamental around 100Hz
         
         for (int harmonic = 1; harmonic <= 10; ++harmonic) {
@@ -85,43 +88,22 @@ float HAMMSAnalyzer::detectHarmonicSeries(const std::vector<float>& spectrum) {
 }
 
 // Melodic Analysis
-float HAMMSAnalyzer::analyzeMelodicity(const AudioBuffer& audio) {
-    std::vector<float> contour = extractMelodicContour(audio);
+float HAMMSAnalyzer::analyzeMelodicity(const AnalysisContext& context) {
+    std::vector<float> contour = extractMelodicContour(context.pitch());
     float complexity = calculateMelodicComplexity(contour);
     
     // Higher complexity indicates more melodic content
     return std::min(1.0f, complexity);
 }
 
-std::vector<float> HAMMSAnalyzer::extractMelodicContour(const AudioBuffer& audio) {
-    // Simplified pitch tracking
+std::vector<float> HAMMSAnalyzer::extractMelodicContour(const PitchTrack& pitch) {
+    // Voiced frames of the shared pitch track
     std::vector<float> pitches;
-    const int windowSize = 2048;
-    const int hopSize = windowSize / 2;
+    pitches.reserve(pitch.size());
     
-    for (int i = 0; i < audio.length - windowSize; i += hopSize) {
-        // Extract window
-        std::vector<float> window(audio.samples.begin() + i, 
-                                 audio.samples.begin() + i + windowSize);
-        
-        // Simple autocorrelation for pitch detection
-        float maxCorr = 0.0f;
-        int bestLag = 0;
-        
-        for (int lag = 20; lag < windowSize / 2; ++lag) {
-            float corr = 0.0f;
-            for (int j = 0; j < windowSize - lag; ++j) {
-                corr += window[j] * window[j + lag];
-            }
-            if (corr > maxCorr) {
-                maxCorr = corr;
-                bestLag = lag;
-            }
-        }
-        
-        if (bestLag > 0) {
-            float pitch = (float)audio.sampleRate / bestLag;
-            pitches.push_back(pitch);
+    for (size_t i = 0; i < pitch.size(); ++i) {
+        if (pitch.voiced[i]) {
+            pitches.push_back(pitch.f0[i]);
         }
     }
     
@@ -145,9 +127,8 @@ float HAMMSAnalyzer::calculateMelodicComplexity(const std::vector<float>& contou
 }
 
 // Rhythmic Analysis
-float HAMMSAnalyzer::analyzeRhythmicity(const AudioBuffer& audio) {
-    BPMDetector bpmDetector;
-    OnsetVector onsets = bpmDetector.detectOnsets(audio);
+float HAMMSAnalyzer::analyzeRhythmicity(const AnalysisContext& context) {
+    const OnsetVector& onsets = context.onsets();
     
     float regularity = calculateRhythmicRegularity(onsets);
     
@@ -208,7 +189,7 @@ float HAMMSAnalyzer::analyzeSyncopation(const BeatVector& beats) {
                                 (measurePosition > 0.45f && measurePosition < 0.55f));
         
         // Check if this is actually a weak beat based on strength
-        if (beats.strengths[i] > 0.7f) {
+        if (beats.beatStrengths[i] > 0.7f) {
             totalStrongBeats++;
             
             // Syncopation: strong accent on weak position
@@ -231,85 +212,35 @@ float HAMMSAnalyzer::analyzeSyncopation(const BeatVector& beats) {
 
 
 // Timbral Analysis
-float HAMMSAnalyzer::analyzeTimbrality(const AudioBuffer& audio) {
-    AudioProcessor processor;
-    SpectralFeatures features = processor.calculateSpectralFeatures(audio);
-    
-    float complexity = calculateSpectralComplexity(features);
-    float variation = analyzeTimbralVariation(audio);
+float HAMMSAnalyzer::analyzeTimbrality(const AnalysisContext& context) {
+    const SpectralDescriptors& descriptors = context.descriptors();
+    float complexity = calculateSpectralComplexity(descriptors);
+    float variation = analyzeTimbralVariation(descriptors);
     
     return (0.5f * complexity + 0.5f * variation);
 }
 
-float HAMMSAnalyzer::calculateSpectralComplexity(const SpectralFeatures& features) {
-    // Spectral entropy as complexity measure
-    float totalEnergy = 0.0f;
-    for (float mag : features.magnitude) {
-        totalEnergy += mag * mag;
-    }
-    
-    if (totalEnergy == 0.0f) return 0.0f;
-    
-    float entropy = 0.0f;
-    for (float mag : features.magnitude) {
-        float p = (mag * mag) / totalEnergy;
-        if (p > 0.0f) {
-            entropy -= p * std::log2(p);
-        }
-    }
-    
-    // Normalize entropy (max ~10 for typical spectra)
-    return std::min(1.0f, entropy / 10.0f);
+float HAMMSAnalyzer::calculateSpectralComplexity(const SpectralDescriptors& descriptors) {
+    // Spectral entropy as complexity measure, already normalized per frame
+    return descriptors.entropySummary.mean;
 }
 
-float HAMMSAnalyzer::analyzeTimbralVariation(const AudioBuffer& audio) {
-    // Simplified: analyze spectral centroid variation over time
-    const int windowSize = 2048;
-    const int hopSize = windowSize / 2;
-    std::vector<float> centroids;
-    
-    AudioProcessor processor;
-    
-    for (int i = 0; i < audio.length - windowSize; i += hopSize) {
-        AudioBuffer window(
-            std::vector<float>(audio.samples.begin() + i, 
-                             audio.samples.begin() + i + windowSize),
-            audio.sampleRate, audio.channels
-        );
-        
-        SpectralFeatures features = processor.calculateSpectralFeatures(window);
-        centroids.push_back(features.spectralCentroid);
-    }
-    
-    // Calculate variation
-    if (centroids.size() < 2) return 0.0f;
-    
-    float variance = 0.0f;
-    float mean = std::accumulate(centroids.begin(), centroids.end(), 0.0f) / centroids.size();
-    
-    for (float centroid : centroids) {
-        variance += std::pow(centroid - mean, 2);
-    }
-    variance /= centroids.size();
-    
-    // Normalize (assuming max centroid around 5000Hz)
-    return std::min(1.0f, std::sqrt(variance) / 5000.0f);
+float HAMMSAnalyzer::analyzeTimbralVariation(const SpectralDescriptors& descriptors) {
+    // Spectral centroid variation over time (max centroid around 5000Hz)
+    return std::min(1.0f, descriptors.centroidSummary.deviation / 5000.0f);
 }
 
 // Dynamic Analysis
-float HAMMSAnalyzer::analyzeDynamics(const AudioBuffer& audio) {
-    float range = calculateDynamicRange(audio);
+float HAMMSAnalyzer::analyzeDynamics(const AnalysisContext& context) {
+    float range = calculateDynamicRange(context);
     
-    // Simple envelope for variation analysis
-    std::vector<float> envelope;
+    // Simple envelope for variation analysis; blocks end before the last sample
+    // so stored vectors stay comparable
     const int blockSize = 1024;
-    
-    for (int i = 0; i < audio.length - blockSize; i += blockSize) {
-        float blockEnergy = 0.0f;
-        for (int j = 0; j < blockSize; ++j) {
-            blockEnergy += audio.samples[i + j] * audio.samples[i + j];
-        }
-        envelope.push_back(std::sqrt(blockEnergy / blockSize));
+    const size_t span = std::max(context.audio().length - 1, 0);
+    std::vector<float> envelope = context.energy().windowSums(blockSize, blockSize, 0, span);
+    for (float& blockEnergy : envelope) {
+        blockEnergy = std::sqrt(blockEnergy / blockSize);
     }
     
     float variation = analyzeDynamicVariation(envelope);
@@ -317,17 +248,14 @@ float HAMMSAnalyzer::analyzeDynamics(const AudioBuffer& audio) {
     return (0.7f * range + 0.3f * variation);
 }
 
-float HAMMSAnalyzer::calculateDynamicRange(const AudioBuffer& audio) {
+float HAMMSAnalyzer::calculateDynamicRange(const AnalysisContext& context) {
     // Find RMS values in dB
-    const int blockSize = audio.sampleRate / 10; // 100ms blocks
+    const int blockSize = context.audio().sampleRate / 10; // 100ms blocks
+    const size_t span = std::max(context.audio().length - 1, 0);
     std::vector<float> rmsValues;
     
-    for (int i = 0; i < audio.length - blockSize; i += blockSize) {
-        float rms = 0.0f;
-        for (int j = 0; j < blockSize; ++j) {
-            rms += audio.samples[i + j] * audio.samples[i + j];
-        }
-        rms = std::sqrt(rms / blockSize);
+    for (float blockEnergy : context.energy().windowSums(blockSize, blockSize, 0, span)) {
+        float rms = std::sqrt(blockEnergy / blockSize);
         
         if (rms > 0.001f) { // Avoid log(0)
             rmsValues.push_back(20.0f * std::log10(rms));
@@ -362,12 +290,9 @@ float HAMMSAnalyzer::analyzeDynamicVariation(const std::vector<float>& envelope)
 }
 
 // Tonal Analysis
-float HAMMSAnalyzer::analyzeTonality(const AudioBuffer& audio) {
-    AudioProcessor processor;
-    ChromaVector chroma = processor.calculateChroma(audio);
-    
-    float clarity = calculateTonalClarity(chroma);
-    float stability = analyzeKeyStability(audio);
+float HAMMSAnalyzer::analyzeTonality(const AnalysisContext& context) {
+    float clarity = calculateTonalClarity(context.chroma());
+    float stability = analyzeKeyStability(context.chromagram(), context.audio());
     
     return (0.6f * clarity + 0.4f * stability);
 }
@@ -390,22 +315,36 @@ float HAMMSAnalyzer::calculateTonalClarity(const ChromaVector& chroma) {
     return totalSum > 0 ? topSum / totalSum : 0.0f;
 }
 
-float HAMMSAnalyzer::analyzeKeyStability(const AudioBuffer& audio) {
+float HAMMSAnalyzer::analyzeKeyStability(const Chromagram& chromagram, const AudioBuffer& audio) {
     // Simplified: analyze chroma vector stability over time
     const int windowSize = audio.sampleRate * 2; // 2 second windows
     const int hopSize = audio.sampleRate; // 1 second hop
     
     std::vector<ChromaVector> chromaSequence;
-    AudioProcessor processor;
-    
-    for (int i = 0; i < audio.length - windowSize; i += hopSize) {
-        AudioBuffer window(
-            std::vector<float>(audio.samples.begin() + i, 
-                             audio.samples.begin() + i + windowSize),
-            audio.sampleRate, audio.channels
-        );
+    
+    // Pool the shared chromagram frames that fit inside each window
+    const int framesPerWindow = chromagram.hopSize > 0
+        ? (windowSize - chromagram.frameSize) / chromagram.hopSize + 1
+        : 0;
+    for (int start = 0; framesPerWindow > 0 && start < audio.length - windowSize; start += hopSize) {
+        int firstFrame = (start + chromagram.hopSize - 1) / chromagram.hopSize;
+        if (firstFrame + framesPerWindow > chromagram.numFrames) break;
         
-        chromaSequence.push_back(processor.calculateChroma(window));
+        ChromaVector chroma;
+        for (int f = firstFrame; f < firstFrame + framesPerWindow; ++f) {
+            const float* frame = chromagram.frame(f);
+            for (int j = 0; j < 12; ++j) {
+                chroma.chroma[j] += frame[j];
+            }
+        }
+        
+        float sum = std::accumulate(chroma.chroma.begin(), chroma.chroma.end(), 0.0f);
+        if (sum > 0) {
+            for (float& val : chroma.chroma) {
+                val /= sum;
+            }
+        }
+        chromaSequence.push_back(chroma);
     }
     
     if (chromaSequence.size() < 2) return 1.0f;
@@ -424,36 +363,19 @@ float HAMMSAnalyzer::analyzeKeyStability(const AudioBuffer& audio) {
 }
 
 // Temporal Analysis
-float HAMMSAnalyzer::analyzeTemporality(const AudioBuffer& audio) {
-    float tempoStability = calculateTempoStability(audio);
+float HAMMSAnalyzer::analyzeTemporality(const AnalysisContext& context) {
+    float tempoStability = calculateTempoStability(context);
     
     // Get beat tracking for consistency analysis
-    TimeSignatureDetector detector;
-    BeatVector beats = detector.detectBeats(audio);
+    const BeatVector& beats = context.beats();
     float consistency = analyzeRhythmicConsistency(beats);
     
     return (0.5f * tempoStability + 0.5f * consistency);
 }
 
-float HAMMSAnalyzer::calculateTempoStability(const AudioBuffer& audio) {
-    // Analyze tempo variation over time
-    const int segmentLength = audio.sampleRate * 10; // 10 second segments
-    std::vector<float> tempos;
-    
-    BPMDetector bpmDetector;
-    
-    for (int i = 0; i < audio.length - segmentLength; i += segmentLength / 2) {
-        AudioBuffer segment(
-            std::vector<float>(audio.samples.begin() + i, 
-                             audio.samples.begin() + i + segmentLength),
-            audio.sampleRate, audio.channels
-        );
-        
-        float tempo = bpmDetector.detectBPM(segment);
-        if (tempo > 0) {
-            tempos.push_back(tempo);
-        }
-    }
+float HAMMSAnalyzer::calculateTempoStability(const AnalysisContext& context) {
+    // Analyze tempo variation over time, along the shared tempo curve
+    const std::vector<float>& tempos = context.beatTrack().tempoCurve;
     
     if (tempos.size() < 2) return 1.0f;
     
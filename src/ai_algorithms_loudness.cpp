@@ -0,0 +1,228 @@
+// Loudness metering - streaming ITU-R BS.1770-4 / EBU R128 measurement
+
+#include "ai_algorithms.h"
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🔊 AI_LOUDNESS - EBU R128 Standard
+// ========================================
+
+namespace {
+
+// Gating block / window loudness from a mean square of K-weighted samples
+float loudnessOf(double meanSquare) {
+    return -0.691f + 10.0f * (float)std::log10(meanSquare);
+}
+
+float sinc(double x) {
+    if (std::abs(x) < 1e-9) return 1.0f;
+    return (float)(std::sin(M_PI * x) / (M_PI * x));
+}
+
+} // namespace
+
+LoudnessAnalyzer::KWeightingFilter::KWeightingFilter(int sampleRate) {
+    // BS.1770-4 analog prototypes, mapped to this rate with the bilinear
+    // transform; at 48 kHz they reproduce the coefficients in the standard
+
+    // Stage 1: High-frequency shelf
+    double f0 = 1681.974450955533;
+    double G = 3.999843853973347;
+    double Q = 0.7071752369554196;
+    double K = tan(M_PI * f0 / sampleRate);
+    double Vh = pow(10.0, G / 20.0);
+    double Vb = pow(Vh, 0.4996667741545416);
+    double norm = 1.0 / (1.0 + K / Q + K * K);
+    sb0 = (Vh + Vb * K / Q + K * K) * norm;
+    sb1 = 2.0 * (K * K - Vh) * norm;
+    sb2 = (Vh - Vb * K / Q + K * K) * norm;
+    sa1 = 2.0 * (K * K - 1.0) * norm;
+    sa2 = (1.0 - K / Q + K * K) * norm;
+
+    // Stage 2: RLB high-pass
+    f0 = 38.13547087602444;
+    Q = 0.5003270373238773;
+    K = tan(M_PI * f0 / sampleRate);
+    norm = 1.0 / (1.0 + K / Q + K * K);
+    ha1 = 2.0 * (K * K - 1.0) * norm;
+    ha2 = (1.0 - K / Q + K * K) * norm;
+}
+
+float LoudnessAnalyzer::KWeightingFilter::process(float sample) {
+    double x = sample;
+    double y = sb0 * x + s1;
+    s1 = sb1 * x - sa1 * y + s2;
+    s2 = sb2 * x - sa2 * y;
+
+    double z = y + h1;
+    h1 = -2.0 * y - ha1 * z + h2;
+    h2 = y - ha2 * z;
+
+    return (float)z;
+}
+
+// ========================================
+// 📏 LOUDNESS METER
+// ========================================
+
+int LoudnessMeter::Histogram::bin(float loudness) {
+    int index = (int)std::floor((loudness - SILENCE) / BIN_LU);
+    return std::max(0, std::min(BIN_COUNT - 1, index));
+}
+
+void LoudnessMeter::Histogram::add(float loudness, double meanSquare) {
+    int index = bin(loudness);
+    counts[index]++;
+    power[index] += meanSquare;
+    totalPower += meanSquare;
+    total++;
+}
+
+LoudnessMeter::LoudnessMeter(int sampleRate, bool recordTimeline)
+    : filter(sampleRate),
+      recordTimeline(recordTimeline),
+      subBlockSize(std::max(1, sampleRate / 10)) {
+    // Windowed-sinc interpolator for the three in-between phases; tap k
+    // weights the sample k steps back, and the output sits half the window
+    // (PEAK_TAPS / 2 samples) behind the newest input
+    const double halfWidth = PEAK_TAPS / 2 + 0.5;
+    for (int p = 1; p < OVERSAMPLING; p++) {
+        float sum = 0.0f;
+        for (int k = 0; k < PEAK_TAPS; k++) {
+            double distance = PEAK_TAPS / 2 - k - (double)p / OVERSAMPLING;
+            double window = 0.5 * (1.0 + std::cos(M_PI * distance / halfWidth));
+            peakPhases[p - 1][k] = sinc(distance) * (float)window;
+            sum += peakPhases[p - 1][k];
+        }
+        for (int k = 0; k < PEAK_TAPS; k++) {
+            peakPhases[p - 1][k] /= sum;
+        }
+    }
+}
+
+void LoudnessMeter::process(const float* samples, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        trackPeak(samples[i]);
+
+        double weighted = filter.process(samples[i]);
+        subBlockSum += weighted * weighted;
+
+        if (++subBlockFill == subBlockSize) {
+            finishSubBlock();
+        }
+    }
+}
+
+void LoudnessMeter::finishSubBlock() {
+    subBlocks[subBlockCount % SHORT_TERM_SUBBLOCKS] = subBlockSum;
+    subBlockCount++;
+    subBlockSum = 0.0;
+    subBlockFill = 0;
+
+    if (subBlockCount < MOMENTARY_SUBBLOCKS) return;
+
+    // Every 100 ms the last four sub-blocks form a gating block (75% overlap)
+    // and up to the last thirty a short-term window
+    size_t available = std::min<size_t>(subBlockCount, SHORT_TERM_SUBBLOCKS);
+    double momentarySum = 0.0;
+    double shortTermSum = 0.0;
+    for (size_t i = 1; i <= available; i++) {
+        double energy = subBlocks[(subBlockCount - i) % SHORT_TERM_SUBBLOCKS];
+        if (i <= MOMENTARY_SUBBLOCKS) momentarySum += energy;
+        shortTermSum += energy;
+    }
+
+    double momentaryMeanSquare = momentarySum / (MOMENTARY_SUBBLOCKS * (double)subBlockSize);
+    double shortTermMeanSquare = shortTermSum / (available * (double)subBlockSize);
+    momentary = momentaryMeanSquare > 0 ? std::max(SILENCE, loudnessOf(momentaryMeanSquare)) : SILENCE;
+    shortTerm = shortTermMeanSquare > 0 ? std::max(SILENCE, loudnessOf(shortTermMeanSquare)) : SILENCE;
+
+    // Absolute gate
+    if (momentary > SILENCE) {
+        blocks.add(momentary, momentaryMeanSquare);
+    }
+    if (available == SHORT_TERM_SUBBLOCKS && shortTerm > SILENCE) {
+        shortTerms.add(shortTerm, shortTermMeanSquare);
+    }
+
+    if (recordTimeline) {
+        history.momentary.push_back(momentary);
+        history.shortTerm.push_back(shortTerm);
+    }
+}
+
+void LoudnessMeter::trackPeak(float sample) {
+    peakPos = (peakPos + PEAK_TAPS - 1) % PEAK_TAPS;
+    peakHistory[peakPos] = sample;
+    peakHistory[peakPos + PEAK_TAPS] = sample;
+
+    const float* recent = peakHistory + peakPos;
+    float level = std::abs(sample);
+    for (int p = 0; p < OVERSAMPLING - 1; p++) {
+        float interpolated = 0.0f;
+        for (int k = 0; k < PEAK_TAPS; k++) {
+            interpolated += peakPhases[p][k] * recent[k];
+        }
+        level = std::max(level, std::abs(interpolated));
+    }
+    peak = std::max(peak, level);
+}
+
+float LoudnessMeter::integratedLoudness() const {
+    if (blocks.total == 0) return SILENCE;
+
+    // Relative gate: 10 LU below the loudness of the absolute-gated blocks
+    float relativeGate = loudnessOf(blocks.totalPower / blocks.total) - 10.0f;
+
+    double power = 0.0;
+    size_t gated = 0;
+    for (int b = Histogram::bin(relativeGate); b < Histogram::BIN_COUNT; b++) {
+        power += blocks.power[b];
+        gated += blocks.counts[b];
+    }
+
+    if (gated == 0) return SILENCE;
+    return loudnessOf(power / gated);
+}
+
+float LoudnessMeter::loudnessRange() const {
+    if (shortTerms.total == 0) return 0.0f;
+
+    // Relative gate: 20 LU below the loudness of the absolute-gated windows
+    float relativeGate = loudnessOf(shortTerms.totalPower / shortTerms.total) - 20.0f;
+    int firstBin = Histogram::bin(relativeGate);
+
+    size_t gated = 0;
+    for (int b = firstBin; b < Histogram::BIN_COUNT; b++) {
+        gated += shortTerms.counts[b];
+    }
+    if (gated == 0) return 0.0f;
+
+    auto percentileBin = [&](float percentile) {
+        size_t rank = (size_t)std::round(percentile * (gated - 1));
+        size_t seen = 0;
+        for (int b = firstBin; b < Histogram::BIN_COUNT; b++) {
+            seen += shortTerms.counts[b];
+            if (seen > rank) return b;
+        }
+        return Histogram::BIN_COUNT - 1;
+    };
+
+    return (percentileBin(0.95f) - percentileBin(0.10f)) * Histogram::BIN_LU;
+}
+
+float LoudnessMeter::truePeak() const {
+    if (peak <= 0.0f) return SILENCE;
+    return std::max(SILENCE, 20.0f * std::log10(peak));
+}
+
+float LoudnessMeter::momentaryLoudness() const {
+    return momentary;
+}
+
+float LoudnessMeter::shortTermLoudness() const {
+    return shortTerm;
+}
+
+} // namespace MusicAnalysis
@@ -11,9 +11,21 @@ namespace MusicAnalysis {
 // 🚀 MASTER ANALYZER IMPLEMENTATION
 // ========================================
 
-AIAnalysisResult AIMetadataAnalyzer::analyzeAudio(const AudioBuffer& audio) {
+AIMetadataAnalyzer::AIMetadataAnalyzer(ThreadPool& pool)
+    : pool(&pool) {}
+
+AIAnalysisResult AIMetadataAnalyzer::analyzeAudio(const AudioBuffer& audio, FieldMask fields) {
     initializeAnalyzers();
-    return combineResults(audio);
+    
+    // Only the shared features the selected analyzers read are computed, once
+    FieldMask resolved = FieldSelection::withDependencies(fields);
+    AnalysisContext context(audio, FieldSelection::requiredFeatures(resolved));
+    return combineResults(context, resolved, AIAnalysisResult());
+}
+
+AIAnalysisResult AIMetadataAnalyzer::analyzeContext(const AnalysisContext& context, FieldMask fields, const AIAnalysisResult& known) {
+    initializeAnalyzers();
+    return combineResults(context, FieldSelection::withDependencies(fields), known);
 }
 
 void AIMetadataAnalyzer::initializeAnalyzers() {
@@ -36,102 +48,133 @@ void AIMetadataAnalyzer::initializeAnalyzers() {
     hammsAnalyzer = std::make_unique<HAMMSAnalyzer>(); // HAMMS analysis now active
 }
 
-AIAnalysisResult AIMetadataAnalyzer::combineResults(const AudioBuffer& audio) {
-    AIAnalysisResult result;
+AIAnalysisResult AIMetadataAnalyzer::combineResults(const AnalysisContext& context, FieldMask fields, const AIAnalysisResult& known) {
+    const AudioBuffer& audio = context.audio();
+    AIAnalysisResult result = known;
+    fields |= known.analyzedFields;
     
     try {
-        std::cout << "🎵 Starting AI analysis..." << std::endl;
-        
-        // Core analysis
-        result.AI_KEY = keyDetector->detectKey(audio);
-        std::cout << "🎹 Key detected: " << result.AI_KEY << std::endl;
-        
-        result.AI_BPM = bpmDetector->detectBPM(audio);
-        std::cout << "🥁 BPM detected: " << result.AI_BPM << std::endl;
+        if (verbose) std::cout << "🎵 Starting AI analysis..." << std::endl;
         
-        result.AI_LOUDNESS = loudnessAnalyzer->calculateLUFS(audio);
-        std::cout << "🔊 Loudness: " << result.AI_LOUDNESS << " LUFS" << std::endl;
+        // Each selected field is one task; a task waits only for the fields it reads
+        // from the result, so independent analyzers all run in parallel.
+        // Fields are added in dependency order; known fields are already in place.
+        TaskGraph graph;
+        std::map<FieldMask, TaskGraph::TaskId> tasks;
+        auto add = [&](AnalysisField field, std::function<void()> work) {
+            if (!(fields & field) || (known.analyzedFields & field)) return;
+            
+            std::vector<TaskGraph::TaskId> dependencies;
+            for (const auto& entry : tasks) {
+                if (FieldSelection::withDependencies(field) & entry.first) {
+                    dependencies.push_back(entry.second);
+                }
+            }
+            tasks[field] = graph.addTask(std::move(work), dependencies);
+        };
         
-        result.AI_ACOUSTICNESS = acousticnessAnalyzer->calculateAcousticness(audio);
-        std::cout << "🎸 Acousticness: " << result.AI_ACOUSTICNESS << std::endl;
+        // Core analyzers only read the shared context
+        add(FIELD_KEY, [&]() {
+            result.AI_KEY = keyDetector->detectKey(context);
+            result.KEY_TIMELINE = keyDetector->detectKeyTimeline(context);
+        });
+        add(FIELD_BPM, [&]() { result.AI_BPM = bpmDetector->detectBPM(context); });
+        add(FIELD_LOUDNESS, [&]() {
+            LoudnessMeter meter = loudnessAnalyzer->measure(context);
+            result.AI_LOUDNESS = meter.integratedLoudness();
+            result.LOUDNESS_RANGE = meter.loudnessRange();
+            result.TRUE_PEAK = meter.truePeak();
+            result.LOUDNESS_TIMELINE = meter.timeline();
+        });
+        add(FIELD_ACOUSTICNESS, [&]() { result.AI_ACOUSTICNESS = acousticnessAnalyzer->calculateAcousticness(context); });
+        add(FIELD_INSTRUMENTALNESS, [&]() { result.AI_INSTRUMENTALNESS = instrumentalnessDetector->detectInstrumentalness(context); });
+        add(FIELD_SPEECHINESS, [&]() { result.AI_SPEECHINESS = speechinessDetector->detectSpeechiness(context); });
+        add(FIELD_LIVENESS, [&]() { result.AI_LIVENESS = livenessDetector->detectLiveness(context); });
+        add(FIELD_ENERGY, [&]() { result.AI_ENERGY = energyAnalyzer->calculateEnergy(context); });
+        add(FIELD_DANCEABILITY, [&]() { result.AI_DANCEABILITY = danceabilityAnalyzer->calculateDanceability(context); });
+        add(FIELD_VALENCE, [&]() { result.AI_VALENCE = valenceAnalyzer->calculateValence(context); });
+        add(FIELD_MODE, [&]() { result.AI_MODE = modeDetector->detectMode(context); });
+        add(FIELD_TIME_SIGNATURE, [&]() { result.AI_TIME_SIGNATURE = timeSignatureDetector->detectTimeSignature(context); });
+        add(FIELD_CHARACTERISTICS, [&]() { result.AI_CHARACTERISTICS = characteristicsExtractor->extractCharacteristics(context); });
+        add(FIELD_HAMMS, [&]() { result.HAMMS_VECTOR = hammsAnalyzer->calculateHAMMS(context); });
         
-        result.AI_INSTRUMENTALNESS = instrumentalnessDetector->detectInstrumentalness(audio);
-        std::cout << "🎤 Instrumentalness: " << result.AI_INSTRUMENTALNESS << std::endl;
+        // Classification analysis reads core results
+        add(FIELD_SUBGENRES, [&]() { result.AI_SUBGENRES = genreClassifier->classifySubgenres(audio, result); });
+        add(FIELD_ERA, [&]() { result.AI_ERA = genreClassifier->classifyEra(context, result); });
+        add(FIELD_CULTURAL_CONTEXT, [&]() { result.AI_CULTURAL_CONTEXT = genreClassifier->analyzeCulturalContext(audio, result); });
+        add(FIELD_MOOD, [&]() { result.AI_MOOD = moodAnalyzer->analyzeMood(result); });
+        add(FIELD_OCCASION, [&]() { result.AI_OCCASION = moodAnalyzer->analyzeOccasions(result); });
         
-        result.AI_SPEECHINESS = speechinessDetector->detectSpeechiness(audio);
-        std::cout << "🗣️ Speechiness: " << result.AI_SPEECHINESS << std::endl;
+        // Final confidence calculation
+        add(FIELD_CONFIDENCE, [&]() { result.AI_CONFIDENCE = confidenceCalculator->calculateOverallConfidence(context, result); });
         
-        result.AI_LIVENESS = livenessDetector->detectLiveness(audio);
-        std::cout << "🎪 Liveness: " << result.AI_LIVENESS << std::endl;
+        graph.run(pool ? *pool : ThreadPool::shared());
         
-        result.AI_ENERGY = energyAnalyzer->calculateEnergy(audio);
-        std::cout << "⚡ Energy: " << result.AI_ENERGY << std::endl;
+        // Report in a stable order once every analyzer has joined
+        if (verbose) {
+            if (fields & FIELD_KEY) std::cout << "🎹 Key detected: " << result.AI_KEY << std::endl;
+            if (fields & FIELD_BPM) std::cout << "🥁 BPM detected: " << result.AI_BPM << std::endl;
+            if (fields & FIELD_LOUDNESS) std::cout << "🔊 Loudness: " << result.AI_LOUDNESS << " LUFS" << std::endl;
+            if (fields & FIELD_ACOUSTICNESS) std::cout << "🎸 Acousticness: " << result.AI_ACOUSTICNESS << std::endl;
+            if (fields & FIELD_INSTRUMENTALNESS) std::cout << "🎤 Instrumentalness: " << result.AI_INSTRUMENTALNESS << std::endl;
+            if (fields & FIELD_SPEECHINESS) std::cout << "🗣️ Speechiness: " << result.AI_SPEECHINESS << std::endl;
+            if (fields & FIELD_LIVENESS) std::cout << "🎪 Liveness: " << result.AI_LIVENESS << std::endl;
+            if (fields & FIELD_ENERGY) std::cout << "⚡ Energy: " << result.AI_ENERGY << std::endl;
+            if (fields & FIELD_DANCEABILITY) std::cout << "🕺 Danceability: " << result.AI_DANCEABILITY << std::endl;
+            if (fields & FIELD_VALENCE) std::cout << "😊 Valence: " << result.AI_VALENCE << std::endl;
+            if (fields & FIELD_MODE) std::cout << "🎼 Mode: " << result.AI_MODE << std::endl;
+            if (fields & FIELD_TIME_SIGNATURE) std::cout << "🎵 Time Signature: " << result.AI_TIME_SIGNATURE << "/4" << std::endl;
         
-        result.AI_DANCEABILITY = danceabilityAnalyzer->calculateDanceability(audio);
-        std::cout << "🕺 Danceability: " << result.AI_DANCEABILITY << std::endl;
+            if (fields & FIELD_CHARACTERISTICS) {
+                std::cout << "🎨 Characteristics: ";
+                for (const auto& char_str : result.AI_CHARACTERISTICS) {
+                    std::cout << char_str << " ";
+                }
+                std::cout << std::endl;
+            }
         
-        result.AI_VALENCE = valenceAnalyzer->calculateValence(audio);
-        std::cout << "😊 Valence: " << result.AI_VALENCE << std::endl;
+            if (fields & FIELD_SUBGENRES) {
+                std::cout << "🎭 Subgenres: ";
+                for (const auto& genre : result.AI_SUBGENRES) {
+                    std::cout << genre << " ";
+                }
+                std::cout << std::endl;
+            }
         
-        result.AI_MODE = modeDetector->detectMode(audio);
-        std::cout << "🎼 Mode: " << result.AI_MODE << std::endl;
+            if (fields & FIELD_ERA) std::cout << "📅 Era: " << result.AI_ERA << std::endl;
+            if (fields & FIELD_CULTURAL_CONTEXT) std::cout << "🌍 Cultural Context: " << result.AI_CULTURAL_CONTEXT << std::endl;
+            if (fields & FIELD_MOOD) std::cout << "😊 Mood: " << result.AI_MOOD << std::endl;
         
-        result.AI_TIME_SIGNATURE = timeSignatureDetector->detectTimeSignature(audio);
-        std::cout << "🎵 Time Signature: " << result.AI_TIME_SIGNATURE << "/4" << std::endl;
+            if (fields & FIELD_OCCASION) {
+                std::cout << "🎉 Occasions: ";
+                for (const auto& occasion : result.AI_OCCASION) {
+                    std::cout << occasion << " ";
+                }
+                std::cout << std::endl;
+            }
         
-        result.AI_CHARACTERISTICS = characteristicsExtractor->extractCharacteristics(audio);
-        std::cout << "🎨 Characteristics: ";
-        for (const auto& char_str : result.AI_CHARACTERISTICS) {
-            std::cout << char_str << " ";
-        }
-        std::cout << std::endl;
+            if (fields & FIELD_HAMMS) {
+                std::cout << "🎯 HAMMS Vector: " << std::endl;
+                std::cout << "  Harmonicity: " << result.HAMMS_VECTOR.harmonicity << std::endl;
+                std::cout << "  Melodicity: " << result.HAMMS_VECTOR.melodicity << std::endl;
+                std::cout << "  Rhythmicity: " << result.HAMMS_VECTOR.rhythmicity << std::endl;
+                std::cout << "  Timbrality: " << result.HAMMS_VECTOR.timbrality << std::endl;
+                std::cout << "  Dynamics: " << result.HAMMS_VECTOR.dynamics << std::endl;
+                std::cout << "  Tonality: " << result.HAMMS_VECTOR.tonality << std::endl;
+                std::cout << "  Temporality: " << result.HAMMS_VECTOR.temporality << std::endl;
+            }
         
-        // Classification analysis
-        result.AI_SUBGENRES = genreClassifier->classifySubgenres(audio, result);
-        std::cout << "🎭 Subgenres: ";
-        for (const auto& genre : result.AI_SUBGENRES) {
-            std::cout << genre << " ";
+            if (fields & FIELD_CONFIDENCE) std::cout << "📊 Confidence: " << result.AI_CONFIDENCE << std::endl;
         }
-        std::cout << std::endl;
-        
-        result.AI_ERA = genreClassifier->classifyEra(audio, result);
-        std::cout << "📅 Era: " << result.AI_ERA << std::endl;
-        
-        result.AI_CULTURAL_CONTEXT = genreClassifier->analyzeCulturalContext(audio, result);
-        std::cout << "🌍 Cultural Context: " << result.AI_CULTURAL_CONTEXT << std::endl;
-        
-        result.AI_MOOD = moodAnalyzer->analyzeMood(result);
-        std::cout << "😊 Mood: " << result.AI_MOOD << std::endl;
-        
-        result.AI_OCCASION = moodAnalyzer->analyzeOccasions(result);
-        std::cout << "🎉 Occasions: ";
-        for (const auto& occasion : result.AI_OCCASION) {
-            std::cout << occasion << " ";
-        }
-        std::cout << std::endl;
-        
-        // HAMMS Analysis
-        result.HAMMS_VECTOR = hammsAnalyzer->calculateHAMMS(audio);
-        
-        std::cout << "🎯 HAMMS Vector: " << std::endl;
-        std::cout << "  Harmonicity: " << result.HAMMS_VECTOR.harmonicity << std::endl;
-        std::cout << "  Melodicity: " << result.HAMMS_VECTOR.melodicity << std::endl;
-        std::cout << "  Rhythmicity: " << result.HAMMS_VECTOR.rhythmicity << std::endl;
-        std::cout << "  Timbrality: " << result.HAMMS_VECTOR.timbrality << std::endl;
-        std::cout << "  Dynamics: " << result.HAMMS_VECTOR.dynamics << std::endl;
-        std::cout << "  Tonality: " << result.HAMMS_VECTOR.tonality << std::endl;
-        std::cout << "  Temporality: " << result.HAMMS_VECTOR.temporality << std::endl;
-        
-        // Final confidence calculation
-        result.AI_CONFIDENCE = confidenceCalculator->calculateOverallConfidence(audio, result);
-        std::cout << "📊 Confidence: " << result.AI_CONFIDENCE << std::endl;
         
+        result.analyzedFields = fields;
         result.AI_ANALYZED = true;
         
-        std::cout << "✅ AI analysis completed successfully!" << std::endl;
+        if (verbose) std::cout << "✅ AI analysis completed successfully!" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "❌ Error during AI analysis: " << e.what() << std::endl;
+        result.analyzedFields = 0;
         result.AI_ANALYZED = false;
         result.AI_CONFIDENCE = 0.0f;
     }
@@ -139,6 +182,150 @@ AIAnalysisResult AIMetadataAnalyzer::combineResults(const AudioBuffer& audio) {
     return result;
 }
 
+// ========================================
+// 🎛️ FIELD SELECTION
+// ========================================
+
+namespace {
+
+struct FieldSpec {
+    AnalysisField field;
+    const char* name;
+    FieldMask reads;       // Result fields the analyzer consumes
+    uint32_t features;     // Context features the analyzer consumes
+};
+
+const FieldMask CORE_FIELDS =
+    FIELD_ACOUSTICNESS | FIELD_BPM | FIELD_CHARACTERISTICS | FIELD_DANCEABILITY |
+    FIELD_ENERGY | FIELD_INSTRUMENTALNESS | FIELD_KEY | FIELD_LIVENESS |
+    FIELD_LOUDNESS | FIELD_MODE | FIELD_SPEECHINESS | FIELD_TIME_SIGNATURE | FIELD_VALENCE;
+
+const FieldSpec FIELD_SPECS[] = {
+    { FIELD_ACOUSTICNESS,     "AI_ACOUSTICNESS",     0, FEATURE_SPECTRUM | FEATURE_ENERGY },
+    { FIELD_BPM,              "AI_BPM",              0, FEATURE_ONSET_ENVELOPE },
+    { FIELD_CHARACTERISTICS,  "AI_CHARACTERISTICS",  0, FEATURE_SPECTRUM | FEATURE_ONSET_ENVELOPE | FEATURE_ENERGY },
+    { FIELD_CONFIDENCE,       "AI_CONFIDENCE",       CORE_FIELDS, FEATURE_SPECTRUM | FEATURE_ENERGY },
+    { FIELD_CULTURAL_CONTEXT, "AI_CULTURAL_CONTEXT",
+        FIELD_ACOUSTICNESS | FIELD_BPM | FIELD_DANCEABILITY | FIELD_ENERGY |
+        FIELD_SUBGENRES | FIELD_TIME_SIGNATURE | FIELD_VALENCE, 0 },
+    { FIELD_DANCEABILITY,     "AI_DANCEABILITY",     0, FEATURE_ONSET_ENVELOPE },
+    { FIELD_ENERGY,           "AI_ENERGY",           0, FEATURE_SPECTRUM | FEATURE_ONSET_ENVELOPE | FEATURE_ENERGY },
+    { FIELD_ERA,              "AI_ERA",
+        FIELD_ACOUSTICNESS | FIELD_ENERGY | FIELD_LIVENESS | FIELD_LOUDNESS | FIELD_VALENCE, FEATURE_SPECTRUM },
+    { FIELD_INSTRUMENTALNESS, "AI_INSTRUMENTALNESS", 0, FEATURE_SPECTRUM | FEATURE_CHROMA },
+    { FIELD_KEY,              "AI_KEY",              0, FEATURE_CHROMA | FEATURE_CHROMAGRAM },
+    { FIELD_LIVENESS,         "AI_LIVENESS",         0, FEATURE_SPECTRUM | FEATURE_ENERGY },
+    { FIELD_LOUDNESS,         "AI_LOUDNESS",         0, 0 },
+    { FIELD_MODE,             "AI_MODE",             0, FEATURE_CHROMA },
+    { FIELD_MOOD,             "AI_MOOD",             FIELD_ENERGY | FIELD_VALENCE, 0 },
+    { FIELD_OCCASION,         "AI_OCCASION",         FIELD_BPM | FIELD_ENERGY, 0 },
+    { FIELD_SPEECHINESS,      "AI_SPEECHINESS",      0, FEATURE_SPECTRUM | FEATURE_ENERGY },
+    { FIELD_SUBGENRES,        "AI_SUBGENRES",
+        FIELD_ACOUSTICNESS | FIELD_BPM | FIELD_DANCEABILITY | FIELD_ENERGY |
+        FIELD_INSTRUMENTALNESS | FIELD_SPEECHINESS | FIELD_VALENCE, 0 },
+    { FIELD_TIME_SIGNATURE,   "AI_TIME_SIGNATURE",   0, FEATURE_ONSET_ENVELOPE },
+    { FIELD_VALENCE,          "AI_VALENCE",          0, FEATURE_SPECTRUM | FEATURE_CHROMA | FEATURE_ONSET_ENVELOPE },
+    { FIELD_HAMMS,            "HAMMS_VECTOR",        0,
+        FEATURE_SPECTRUM | FEATURE_CHROMA | FEATURE_ONSET_ENVELOPE | FEATURE_PITCH | FEATURE_CHROMAGRAM | FEATURE_ENERGY |
+        FEATURE_DESCRIPTORS },
+};
+
+} // namespace
+
+FieldMask FieldSelection::parse(const std::vector<std::string>& names) {
+    if (names.empty()) return FIELD_ALL;
+    
+    FieldMask fields = 0;
+    for (const auto& name : names) {
+        auto spec = std::find_if(std::begin(FIELD_SPECS), std::end(FIELD_SPECS),
+                                 [&](const FieldSpec& s) { return name == s.name; });
+        if (spec != std::end(FIELD_SPECS)) {
+            fields |= spec->field;
+        } else {
+            std::cerr << "⚠️ Unknown analysis field ignored: " << name << std::endl;
+        }
+    }
+    return fields;
+}
+
+FieldMask FieldSelection::withDependencies(FieldMask fields) {
+    // Expand until no selected field reads an unselected one
+    FieldMask resolved = fields & FIELD_ALL;
+    FieldMask previous;
+    do {
+        previous = resolved;
+        for (const auto& spec : FIELD_SPECS) {
+            if (resolved & spec.field) resolved |= spec.reads;
+        }
+    } while (resolved != previous);
+    return resolved;
+}
+
+uint32_t FieldSelection::requiredFeatures(FieldMask fields) {
+    uint32_t features = 0;
+    for (const auto& spec : FIELD_SPECS) {
+        if (fields & spec.field) features |= spec.features;
+    }
+    return features;
+}
+
+// ========================================
+// 📚 BATCH ANALYSIS
+// ========================================
+
+size_t AIMetadataAnalyzer::analyzeBatch(const std::vector<std::string>& filePaths,
+                                        const BatchOptions& options,
+                                        const BatchResultCallback& onResult) {
+    // Files and their analyzer graphs share one work-stealing pool
+    std::unique_ptr<ThreadPool> ownedPool;
+    if (options.threadCount > 0) {
+        ownedPool = std::make_unique<ThreadPool>(options.threadCount);
+    }
+    ThreadPool& pool = ownedPool ? *ownedPool : ThreadPool::shared();
+    
+    std::mutex callbackMutex;
+    std::atomic<size_t> succeeded{0};
+    
+    TaskGraph graph;
+    for (const auto& filePath : filePaths) {
+        graph.addTask([&, filePath]() {
+            BatchItemResult item;
+            item.filePath = filePath;
+            
+            try {
+                // Streamed so long mixes do not hold the whole track in memory
+                StreamingOptions streaming;
+                streaming.fields = options.fields;
+                streaming.verbose = options.verbose;
+                streaming.pool = &pool;
+                item.result = StreamingAnalyzer::analyzeFile(filePath, streaming);
+                
+                item.success = item.result.AI_ANALYZED;
+                if (!item.success) item.error = "Analysis failed";
+            } catch (const std::exception& e) {
+                item.error = e.what();
+            }
+            
+            if (item.success) succeeded++;
+            
+            if (onResult) {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                onResult(item);
+            }
+        });
+    }
+    
+    if (options.verbose) {
+        std::cout << "📚 Analyzing " << filePaths.size() << " files on " << pool.size() << " threads" << std::endl;
+    }
+    graph.run(pool);
+    if (options.verbose) {
+        std::cout << "✅ Batch complete: " << succeeded << "/" << filePaths.size() << " analyzed" << std::endl;
+    }
+    
+    return succeeded;
+}
+
 } // namespace MusicAnalysis
 
 // ========================================
@@ -157,21 +344,32 @@ extern "C" {
         delete analyzer;
     }
     
-    // Analyze audio buffer
-    MusicAnalysis::AIAnalysisResult* analyze_audio_buffer(
+    // Load FFTW wisdom (returns false if the file does not exist yet)
+    bool load_fftw_wisdom(const char* path) {
+        return path ? MusicAnalysis::AudioProcessor::enableFFTWisdom(path) : false;
+    }
+    
+    // Save accumulated FFTW wisdom for the next run
+    bool save_fftw_wisdom(const char* path) {
+        return path ? MusicAnalysis::AudioProcessor::saveFFTWisdom(path) : false;
+    }
+    
+    // Analyze audio buffer, computing only the fields in field_mask (and their dependencies)
+    MusicAnalysis::AIAnalysisResult* analyze_audio_buffer_fields(
         MusicAnalysis::AIMetadataAnalyzer* analyzer,
         float* samples,
         int sample_count,
-        int sample_rate
+        int sample_rate,
+        uint32_t field_mask
     ) {
         try {
-            std::vector<float> audioData(samples, samples + sample_count);
-            MusicAnalysis::AudioBuffer buffer(audioData, sample_rate, 1);
+            // Analyze the caller's samples in place; they outlive this call
+            MusicAnalysis::AudioBuffer buffer(samples, sample_count > 0 ? sample_count : 0, sample_rate, 1);
             
-            MusicAnalysis::AIAnalysisResult result = analyzer->analyzeAudio(buffer);
+            MusicAnalysis::AIAnalysisResult result = analyzer->analyzeAudio(buffer, field_mask);
             
             // Allocate result on heap for C interface
-            auto* heapResult = new MusicAnalysis::AIAnalysisResult(result);
+            auto* heapResult = new MusicAnalysis::AIAnalysisResult(std::move(result));
             return heapResult;
             
         } catch (const std::exception& e) {
@@ -180,6 +378,92 @@ extern "C" {
         }
     }
     
+    // Analyze audio buffer
+    MusicAnalysis::AIAnalysisResult* analyze_audio_buffer(
+        MusicAnalysis::AIMetadataAnalyzer* analyzer,
+        float* samples,
+        int sample_count,
+        int sample_rate
+    ) {
+        return analyze_audio_buffer_fields(analyzer, samples, sample_count, sample_rate, MusicAnalysis::FIELD_ALL);
+    }
+    
+    // Batch analysis: callback receives a heap result owned by the caller
+    // (free with destroy_ai_result) or nullptr plus an error message
+    typedef void (*ai_batch_result_callback)(const char* file_path,
+                                             MusicAnalysis::AIAnalysisResult* result,
+                                             const char* error,
+                                             void* user_data);
+    
+    int analyze_audio_batch(
+        const char** file_paths,
+        int file_count,
+        int thread_count,
+        ai_batch_result_callback callback,
+        void* user_data
+    ) {
+        if (file_count < 0 || (file_count > 0 && !file_paths)) {
+            return -1;
+        }
+        
+        for (int i = 0; i < file_count; i++) {
+            if (!file_paths[i]) {
+                return -1;
+            }
+        }
+        
+        try {
+            std::vector<std::string> paths(file_paths, file_paths + file_count);
+            
+            MusicAnalysis::BatchOptions options;
+            options.threadCount = thread_count > 0 ? thread_count : 0;
+            
+            return (int)MusicAnalysis::AIMetadataAnalyzer::analyzeBatch(paths, options,
+                [callback, user_data](const MusicAnalysis::BatchItemResult& item) {
+                    if (!callback) return;
+                    if (item.success) {
+                        callback(item.filePath.c_str(), new MusicAnalysis::AIAnalysisResult(item.result), nullptr, user_data);
+                    } else {
+                        callback(item.filePath.c_str(), nullptr, item.error.c_str(), user_data);
+                    }
+                });
+            
+        } catch (const std::exception& e) {
+            std::cerr << "Error in analyze_audio_batch: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+    
+    // Streaming analysis: push mono chunks, then finish once (result freed with destroy_ai_result)
+    MusicAnalysis::StreamingAnalyzer* create_streaming_analyzer(int sample_rate) {
+        if (sample_rate <= 0) {
+            return nullptr;
+        }
+        return new MusicAnalysis::StreamingAnalyzer(sample_rate);
+    }
+    
+    void streaming_analyzer_push(MusicAnalysis::StreamingAnalyzer* analyzer, const float* samples, int sample_count) {
+        if (analyzer && samples && sample_count > 0) {
+            analyzer->push(samples, sample_count);
+        }
+    }
+    
+    MusicAnalysis::AIAnalysisResult* streaming_analyzer_finish(MusicAnalysis::StreamingAnalyzer* analyzer) {
+        if (!analyzer) {
+            return nullptr;
+        }
+        try {
+            return new MusicAnalysis::AIAnalysisResult(analyzer->finish());
+        } catch (const std::exception& e) {
+            std::cerr << "Error in streaming_analyzer_finish: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+    
+    void destroy_streaming_analyzer(MusicAnalysis::StreamingAnalyzer* analyzer) {
+        delete analyzer;
+    }
+    
     // Get analysis result fields
     float get_ai_acousticness(MusicAnalysis::AIAnalysisResult* result) {
         return result ? result->AI_ACOUSTICNESS : 0.0f;
@@ -242,6 +526,14 @@ extern "C" {
         return result ? result->AI_LOUDNESS : 0.0f;
     }
     
+    float get_loudness_range(MusicAnalysis::AIAnalysisResult* result) {
+        return result ? result->LOUDNESS_RANGE : 0.0f;
+    }
+    
+    float get_true_peak(MusicAnalysis::AIAnalysisResult* result) {
+        return result ? result->TRUE_PEAK : 0.0f;
+    }
+    
     const char* get_ai_mode(MusicAnalysis::AIAnalysisResult* result) {
         return result ? result->AI_MODE.c_str() : "";
     }
@@ -0,0 +1,204 @@
+// Harmonic mixing - Camelot, BPM and energy buckets answering "what can follow this track"
+
+#include "ai_algorithms.h"
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🎛️ HARMONIC MIXING
+// ========================================
+
+namespace {
+
+// Both tables indexed once at startup; queries only read them
+struct CamelotTables {
+    int codeOfKey[24];
+    uint32_t compatible[HarmonicMixingIndex::CAMELOT_CODES];
+};
+
+CamelotTables makeCamelotTables() {
+    CamelotTables tables;
+    for (int key = 0; key < 24; key++) {
+        int root = key / 2;
+        bool minor = key % 2;
+        int major = minor ? (root + 3) % 12 : root;       // Relative major shares the number
+        int number = ((major * 7) % 12 + 7) % 12 + 1;     // C major is 8B, G major 9B
+        tables.codeOfKey[key] = (number - 1) * 2 + (minor ? 0 : 1);
+    }
+
+    // Same code, one step around the wheel, or the relative major / minor
+    for (int code = 0; code < HarmonicMixingIndex::CAMELOT_CODES; code++) {
+        int number = code / 2;
+        int letter = code % 2;
+        tables.compatible[code] = (1u << code) |
+                                  (1u << (((number + 1) % 12) * 2 + letter)) |
+                                  (1u << (((number + 11) % 12) * 2 + letter)) |
+                                  (1u << (number * 2 + 1 - letter));
+    }
+    return tables;
+}
+
+const CamelotTables CAMELOT = makeCamelotTables();
+
+} // namespace
+
+int HarmonicMixingIndex::camelotCode(int key) {
+    return key >= 0 && key < 24 ? CAMELOT.codeOfKey[key] : -1;
+}
+
+std::string HarmonicMixingIndex::camelotName(int code) {
+    if (code < 0 || code >= CAMELOT_CODES) return "";
+    return std::to_string(code / 2 + 1) + (code % 2 ? "B" : "A");
+}
+
+uint32_t HarmonicMixingIndex::compatibleCodes(int code) {
+    return code >= 0 && code < CAMELOT_CODES ? CAMELOT.compatible[code] : 0;
+}
+
+int HarmonicMixingIndex::bpmBucket(float bpm) {
+    return std::max(0, std::min(BPM_BUCKETS - 1, (int)bpm));
+}
+
+int HarmonicMixingIndex::energyBucket(float energy) {
+    if (std::isnan(energy)) return UNKNOWN_ENERGY;
+    return std::max(0, std::min(UNKNOWN_ENERGY - 1, (int)(energy * UNKNOWN_ENERGY)));
+}
+
+uint32_t HarmonicMixingIndex::cellOf(int code, int bpmBucket, int energyBucket) {
+    return (uint32_t)((code * BPM_BUCKETS + bpmBucket) * ENERGY_BUCKETS + energyBucket);
+}
+
+bool HarmonicMixingIndex::upsert(int64_t trackId, int key, float bpm, float energy) {
+    remove(trackId);
+
+    const int code = camelotCode(key);
+    if (code < 0 || !(bpm > 0.0f) || !std::isfinite(bpm)) return false;
+
+    const uint32_t cell = cellOf(code, bpmBucket(bpm), energyBucket(energy));
+    cells[cell].push_back({trackId, bpm, energy});
+    locations[trackId] = {cell, (uint32_t)(cells[cell].size() - 1)};
+    return true;
+}
+
+bool HarmonicMixingIndex::remove(int64_t trackId) {
+    auto existing = locations.find(trackId);
+    if (existing == locations.end()) return false;
+
+    // The cell's last entry fills the gap
+    const Location location = existing->second;
+    std::vector<Entry>& cell = cells[location.cell];
+    if (location.slot + 1 != cell.size()) {
+        cell[location.slot] = cell.back();
+        locations[cell[location.slot].trackId].slot = location.slot;
+    }
+    cell.pop_back();
+    locations.erase(existing);
+    return true;
+}
+
+std::vector<MixingMatch> HarmonicMixingIndex::compatibleTracks(int64_t trackId, size_t limit,
+                                                               const MixingFilters& filters) const {
+    auto existing = locations.find(trackId);
+    if (existing == locations.end()) return {};
+
+    const Location location = existing->second;
+    const Entry& seed = cells[location.cell][location.slot];
+    return search(location.cell / (BPM_BUCKETS * ENERGY_BUCKETS), seed.bpm, seed.energy, limit, filters, trackId);
+}
+
+std::vector<MixingMatch> HarmonicMixingIndex::compatibleTracks(int key, float bpm, float energy, size_t limit,
+                                                               const MixingFilters& filters) const {
+    return search(camelotCode(key), bpm, energy, limit, filters, std::numeric_limits<int64_t>::min());
+}
+
+std::vector<MixingMatch> HarmonicMixingIndex::search(int code, float bpm, float energy, size_t limit,
+                                                     const MixingFilters& filters, int64_t exclude) const {
+    if (code < 0 || !(bpm > 0.0f) || limit == 0) return {};
+
+    // Tempo windows in order of preference; a BPM inside two windows belongs to the first
+    const float ratios[3] = { 1.0f, 0.5f, 2.0f };
+    const int windows = filters.tempoMultiples ? 3 : 1;
+    const float tolerance = std::max(filters.bpmTolerance, 1e-6f);
+    auto windowOf = [&](float candidate) {
+        for (int w = 0; w < windows; w++) {
+            if (std::abs(candidate - ratios[w] * bpm) <= tolerance * ratios[w] * bpm) return w;
+        }
+        return -1;
+    };
+
+    // Rank: tempo deviation plus energy gap, each as a fraction of what the filters allow.
+    // Buckets are read nearest first; a bucket whose smallest possible gap already
+    // exceeds the current `limit`-th best score is skipped.
+    struct Reach {
+        float gap;    // Lower bound over the bucket
+        int bucket;
+        int window;
+    };
+    std::vector<Reach> tempos;
+    for (int w = 0; w < windows; w++) {
+        const float centre = ratios[w] * bpm;
+        const int last = bpmBucket(centre * (1.0f + tolerance));
+        for (int b = bpmBucket(centre * (1.0f - tolerance)); b <= last; b++) {
+            float lower = (float)b, upper = b + 1 == BPM_BUCKETS ? INFINITY : b + 1.0f;
+            tempos.push_back({std::max(0.0f, std::max(lower - centre, centre - upper)) / (centre * tolerance), b, w});
+        }
+    }
+
+    const bool energyKnown = !std::isnan(energy);
+    const float energyScale = std::max(filters.maxEnergyDifference, 1e-6f);
+    std::vector<Reach> energies = {{1.0f, UNKNOWN_ENERGY, 0}};   // Unknown counts as the largest allowed gap
+    for (int e = 0; e < UNKNOWN_ENERGY; e++) {
+        float gap = 1.0f;
+        if (energyKnown) {
+            float lower = e == 0 ? -INFINITY : (float)e / UNKNOWN_ENERGY;
+            float upper = e + 1 == UNKNOWN_ENERGY ? INFINITY : (e + 1.0f) / UNKNOWN_ENERGY;
+            gap = std::max(0.0f, std::max(lower - energy, energy - upper)) / energyScale;
+        }
+        if (gap <= 1.0f) energies.push_back({gap, e, 0});
+    }
+
+    auto nearer = [](const Reach& a, const Reach& b) { return a.gap < b.gap; };
+    std::sort(tempos.begin(), tempos.end(), nearer);
+    std::sort(energies.begin(), energies.end(), nearer);
+
+    BasicNearestSelection<uint64_t> nearest(limit);   // (cell << 32) | slot on any word size
+    const uint32_t compatible = compatibleCodes(code);
+    for (const Reach& tempo : tempos) {
+        if (tempo.gap > nearest.bound()) break;
+        const float centre = ratios[tempo.window] * bpm;
+
+        for (const Reach& energyReach : energies) {
+            if (tempo.gap + energyReach.gap > nearest.bound()) break;
+
+            for (int candidateCode = 0; candidateCode < CAMELOT_CODES; candidateCode++) {
+                if (!(compatible & (1u << candidateCode))) continue;
+
+                const uint32_t cell = cellOf(candidateCode, tempo.bucket, energyReach.bucket);
+                const std::vector<Entry>& entries = cells[cell];
+                for (uint32_t slot = 0; slot < entries.size(); slot++) {
+                    const Entry& entry = entries[slot];
+                    float tempoGap = std::abs(entry.bpm / centre - 1.0f) / tolerance;
+                    if (tempoGap > 1.0f || entry.trackId == exclude || windowOf(entry.bpm) != tempo.window) continue;
+
+                    float energyGap = 1.0f;
+                    if (energyKnown && energyReach.bucket != UNKNOWN_ENERGY) {
+                        energyGap = std::abs(entry.energy - energy) / energyScale;
+                        if (energyGap > 1.0f) continue;
+                    }
+                    nearest.offer(tempoGap + energyGap, (uint64_t)cell << 32 | slot);
+                }
+            }
+        }
+    }
+
+    std::vector<MixingMatch> matches;
+    for (const auto& candidate : nearest.take()) {
+        const uint32_t cell = (uint32_t)(candidate.second >> 32);
+        const Entry& entry = cells[cell][(uint32_t)candidate.second];
+        matches.push_back({entry.trackId, (int)(cell / (BPM_BUCKETS * ENERGY_BUCKETS)), entry.bpm, entry.energy,
+                           ratios[windowOf(entry.bpm)]});
+    }
+    return matches;
+}
+
+} // namespace MusicAnalysis
@@ -10,9 +10,12 @@ namespace MusicAnalysis {
 // ========================================
 
 float DanceabilityAnalyzer::calculateDanceability(const AudioBuffer& audio) {
-    BeatVector beats = detectBeats(audio);
-    BPMDetector bpmDetector;
-    float bpm = bpmDetector.detectBPM(audio);
+    return calculateDanceability(AnalysisContext(audio));
+}
+
+float DanceabilityAnalyzer::calculateDanceability(const AnalysisContext& context) {
+    const BeatVector& beats = context.beats();
+    float bpm = context.bpm();
     
     float beatStrength = analyzeBeatStrength(beats);
     float tempoSuitability = analyzeTempoSuitability(bpm);
@@ -23,25 +26,11 @@ float DanceabilityAnalyzer::calculateDanceability(const AudioBuffer& audio) {
 }
 
 BeatVector DanceabilityAnalyzer::detectBeats(const AudioBuffer& audio) {
-    // Use onset detection as basis for beat detection
-    BPMDetector bpmDetector;
-    OnsetVector onsets = bpmDetector.detectOnsets(audio);
-    
-    BeatVector beats;
-    
-    // Convert strong onsets to beats
-    if (!onsets.onsetTimes.empty()) {
-        float avgStrength = std::accumulate(onsets.onsetStrengths.begin(), onsets.onsetStrengths.end(), 0.0f) / onsets.onsetStrengths.size();
-        
-        for (size_t i = 0; i < onsets.onsetTimes.size(); i++) {
-            if (onsets.onsetStrengths[i] > avgStrength * 1.2f) { // Strong beats only
-                beats.beatTimes.push_back(onsets.onsetTimes[i]);
-                beats.beatStrengths.push_back(onsets.onsetStrengths[i]);
-            }
-        }
-    }
-    
-    return beats;
+    return detectBeats(AnalysisContext(audio));
+}
+
+BeatVector DanceabilityAnalyzer::detectBeats(const AnalysisContext& context) {
+    return context.beats();
 }
 
 float DanceabilityAnalyzer::analyzeBeatStrength(const BeatVector& beats) {
@@ -123,13 +112,16 @@ bool DanceabilityAnalyzer::isOptimalDanceTempo(float bpm) {
 // ========================================
 
 float ValenceAnalyzer::calculateValence(const AudioBuffer& audio) {
-    ChromaVector chroma = AudioProcessor::calculateChroma(audio);
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    BPMDetector bpmDetector;
-    float bpm = bpmDetector.detectBPM(audio);
+    return calculateValence(AnalysisContext(audio));
+}
+
+float ValenceAnalyzer::calculateValence(const AnalysisContext& context) {
+    const ChromaVector& chroma = context.chroma();
+    const SpectralFeatures& features = context.spectrum();
+    float bpm = context.bpm();
     
     float majorHarmony = analyzeMajorHarmony(chroma);
-    float melodicPositivity = analyzeMelodicPositivity(audio);
+    float melodicPositivity = analyzeMelodicPositivity(context);
     float tempoFactor = analyzeTempoFactor(bpm);
     float timbralBrightness = analyzeTimbralBrightness(features);
     
@@ -162,15 +154,15 @@ float ValenceAnalyzer::analyzeMajorHarmony(const ChromaVector& chroma) {
     return (total > 0) ? majorScore / total : 0.5f;
 }
 
-float ValenceAnalyzer::analyzeMelodicPositivity(const AudioBuffer& audio) {
+float ValenceAnalyzer::analyzeMelodicPositivity(const AnalysisContext& context) {
     // Analyze melodic contour for upward vs downward motion
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+    const SpectralFeatures& features = context.spectrum();
     
     // Simplified: higher spectral centroid often correlates with upward motion
     float normalizedCentroid = std::min(1.0f, features.spectralCentroid / 3000.0f);
     
     // Consonance/dissonance analysis
-    float consonance = calculateConsonanceDissonance(AudioProcessor::calculateChroma(audio));
+    float consonance = calculateConsonanceDissonance(context.chroma());
     
     return (normalizedCentroid * 0.4f + consonance * 0.6f);
 }
@@ -215,7 +207,7 @@ float ValenceAnalyzer::analyzeTimbralBrightness(const SpectralFeatures& features
     float totalEnergy = 0.0f, highFreqEnergy = 0.0f;
     for (size_t i = 0; i < features.magnitude.size(); i++) {
         totalEnergy += features.magnitude[i];
-        if (features.frequencies[i] > 2000.0f) {
+        if (features.frequency(i) > 2000.0f) {
             highFreqEnergy += features.magnitude[i];
         }
     }
@@ -264,7 +256,11 @@ float ValenceAnalyzer::analyzeMelodicContour(const AudioBuffer& audio) {
 // ========================================
 
 std::string ModeDetector::detectMode(const AudioBuffer& audio) {
-    ChromaVector chroma = AudioProcessor::calculateChroma(audio);
+    return detectMode(AnalysisContext(audio));
+}
+
+std::string ModeDetector::detectMode(const AnalysisContext& context) {
+    const ChromaVector& chroma = context.chroma();
     
     float majorStrength = analyzeMajorThirdStrength(chroma);
     float minorStrength = analyzeMinorThirdStrength(chroma);
@@ -310,15 +306,22 @@ std::string ModeDetector::classifyMode(float majorStrength, float minorStrength)
 // ========================================
 
 int TimeSignatureDetector::detectTimeSignature(const AudioBuffer& audio) {
-    BeatVector beats = detectBeats(audio);
+    return detectTimeSignature(AnalysisContext(audio));
+}
+
+int TimeSignatureDetector::detectTimeSignature(const AnalysisContext& context) {
+    const BeatVector& beats = context.beats();
     std::vector<float> accentPattern = analyzeAccentPattern(beats);
     return analyzeMeter(accentPattern);
 }
 
 BeatVector TimeSignatureDetector::detectBeats(const AudioBuffer& audio) {
-    // Reuse beat detection from DanceabilityAnalyzer
-    DanceabilityAnalyzer danceAnalyzer;
-    return danceAnalyzer.detectBeats(audio);
+    return detectBeats(AnalysisContext(audio));
+}
+
+BeatVector TimeSignatureDetector::detectBeats(const AnalysisContext& context) {
+    // Same beat grid as DanceabilityAnalyzer, memoized in the context
+    return context.beats();
 }
 
 std::vector<float> TimeSignatureDetector::analyzeAccentPattern(const BeatVector& beats) {
@@ -461,11 +464,13 @@ bool TimeSignatureDetector::isComplexMeter(const std::vector<float>& pattern) {
 // ========================================
 
 std::vector<std::string> CharacteristicsExtractor::extractCharacteristics(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    
-    std::vector<std::string> timbralFeatures = analyzeTimbralFeatures(features);
-    std::vector<std::string> rhythmicPatterns = analyzeRhythmicPatterns(audio);
-    std::vector<std::string> effects = analyzeEffects(audio);
+    return extractCharacteristics(AnalysisContext(audio));
+}
+
+std::vector<std::string> CharacteristicsExtractor::extractCharacteristics(const AnalysisContext& context) {
+    std::vector<std::string> timbralFeatures = analyzeTimbralFeatures(context.spectrum());
+    std::vector<std::string> rhythmicPatterns = analyzeRhythmicPatterns(context);
+    std::vector<std::string> effects = analyzeEffects(context);
     
     // Combine all characteristics
     std::vector<std::string> allCharacteristics;
@@ -515,11 +520,11 @@ std::vector<std::string> CharacteristicsExtractor::analyzeTimbralFeatures(const
     return timbralFeatures;
 }
 
-std::vector<std::string> CharacteristicsExtractor::analyzeRhythmicPatterns(const AudioBuffer& audio) {
+std::vector<std::string> CharacteristicsExtractor::analyzeRhythmicPatterns(const AnalysisContext& context) {
     std::vector<std::string> rhythmicFeatures;
     
-    BPMDetector bpmDetector;
-    float bpm = bpmDetector.detectBPM(audio);
+    const OnsetVector& onsets = context.onsets();
+    float bpm = context.bpm();
     
     if (bpm > 140.0f) {
         rhythmicFeatures.push_back("Driving rhythm");
@@ -530,7 +535,6 @@ std::vector<std::string> CharacteristicsExtractor::analyzeRhythmicPatterns(const
     }
     
     // Analyze rhythm complexity
-    OnsetVector onsets = bpmDetector.detectOnsets(audio);
     if (!onsets.onsetTimes.empty()) {
         float duration = onsets.onsetTimes.back() - onsets.onsetTimes.front();
         float onsetDensity = onsets.onsetTimes.size() / duration;
@@ -545,19 +549,18 @@ std::vector<std::string> CharacteristicsExtractor::analyzeRhythmicPatterns(const
     return rhythmicFeatures;
 }
 
-std::vector<std::string> CharacteristicsExtractor::analyzeEffects(const AudioBuffer& audio) {
+std::vector<std::string> CharacteristicsExtractor::analyzeEffects(const AnalysisContext& context) {
     std::vector<std::string> effects;
     
-    if (hasReverb(audio)) {
+    if (hasReverb(context)) {
         effects.push_back("Reverb");
     }
     
-    if (hasCompression(audio)) {
+    if (hasCompression(context)) {
         effects.push_back("Compressed");
     }
     
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    if (hasDistortion(features)) {
+    if (hasDistortion(context.spectrum())) {
         effects.push_back("Distortion");
     }
     
@@ -571,7 +574,7 @@ bool CharacteristicsExtractor::hasDistortion(const SpectralFeatures& features) {
     
     for (size_t i = 0; i < features.magnitude.size(); i++) {
         totalEnergy += features.magnitude[i];
-        if (features.frequencies[i] > 5000.0f) {
+        if (features.frequency(i) > 5000.0f) {
             highFreqEnergy += features.magnitude[i];
         }
     }
@@ -582,24 +585,24 @@ bool CharacteristicsExtractor::hasDistortion(const SpectralFeatures& features) {
     return (highFreqRatio > 0.3f && features.zeroCrossingRate > 0.08f);
 }
 
-bool CharacteristicsExtractor::hasReverb(const AudioBuffer& audio) {
+bool CharacteristicsExtractor::hasReverb(const AnalysisContext& context) {
     // Simplified reverb detection based on decay characteristics
     LivenessDetector livenessDetector;
-    float liveness = livenessDetector.detectLiveness(audio);
+    float liveness = livenessDetector.detectLiveness(context);
     
     return liveness > 0.3f; // Reverb contributes to liveness score
 }
 
 bool CharacteristicsExtractor::hasCompression(const AudioBuffer& audio) {
+    return hasCompression(AnalysisContext(audio));
+}
+
+bool CharacteristicsExtractor::hasCompression(const AnalysisContext& context) {
     // Analyze dynamic range
-    int windowSize = (int)(0.1f * audio.sampleRate); // 100ms windows
-    std::vector<float> rmsValues;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize) {
-        float rms = AudioProcessor::calculateRMS(
-            std::vector<float>(audio.samples.begin() + i, audio.samples.begin() + i + windowSize)
-        );
-        rmsValues.push_back(rms);
+    int windowSize = (int)(0.1f * context.audio().sampleRate); // 100ms windows
+    std::vector<float> rmsValues = context.energy().windowSums(windowSize, windowSize);
+    for (float& rms : rmsValues) {
+        rms = std::sqrt(rms / windowSize);
     }
     
     if (rmsValues.empty()) return false;
@@ -10,7 +10,11 @@ namespace MusicAnalysis {
 // ========================================
 
 float ConfidenceCalculator::calculateOverallConfidence(const AudioBuffer& audio, const AIAnalysisResult& results) {
-    float audioQuality = assessAudioQuality(audio);
+    return calculateOverallConfidence(AnalysisContext(audio), results);
+}
+
+float ConfidenceCalculator::calculateOverallConfidence(const AnalysisContext& context, const AIAnalysisResult& results) {
+    float audioQuality = assessAudioQuality(context);
     float analysisConsistency = validateConsistency(results);
     float featureCertainty = calculateFeatureCertainty(results);
     
@@ -18,44 +22,39 @@ float ConfidenceCalculator::calculateOverallConfidence(const AudioBuffer& audio,
     return audioQuality * 0.3f + analysisConsistency * 0.4f + featureCertainty * 0.3f;
 }
 
-float ConfidenceCalculator::assessAudioQuality(const AudioBuffer& audio) {
+float ConfidenceCalculator::assessAudioQuality(const AnalysisContext& context) {
     float qualityScore = 0.0f;
     
     // Signal-to-noise ratio
-    float snr = calculateSNR(audio);
+    float snr = calculateSNR(context);
     if (snr > 40.0f) qualityScore += 0.3f;
     else if (snr > 20.0f) qualityScore += 0.2f;
     else if (snr > 10.0f) qualityScore += 0.1f;
     
     // Dynamic range
     EnergyAnalyzer energyAnalyzer;
-    float dynamicRange = energyAnalyzer.analyzeDynamicRange(audio);
+    float dynamicRange = energyAnalyzer.analyzeDynamicRange(context);
     qualityScore += dynamicRange * 0.3f; // Already normalized to 0-1
     
     // Frequency response completeness
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    if (isFrequencyResponseComplete(features)) {
+    if (isFrequencyResponseComplete(context.spectrum())) {
         qualityScore += 0.2f;
     }
     
     // Compression artifacts
-    float compressionArtifacts = detectCompressionArtifacts(audio);
+    float compressionArtifacts = detectCompressionArtifacts(context);
     qualityScore += (1.0f - compressionArtifacts) * 0.2f;
     
     return std::min(1.0f, qualityScore);
 }
 
-float ConfidenceCalculator::calculateSNR(const AudioBuffer& audio) {
+float ConfidenceCalculator::calculateSNR(const AnalysisContext& context) {
     // Simplified SNR calculation
     // Find quiet sections for noise estimation
-    int windowSize = (int)(0.1f * audio.sampleRate); // 100ms
-    std::vector<float> rmsValues;
-    
-    for (int i = 0; i <= (int)audio.samples.size() - windowSize; i += windowSize) {
-        float rms = AudioProcessor::calculateRMS(
-            std::vector<float>(audio.samples.begin() + i, audio.samples.begin() + i + windowSize)
-        );
-        rmsValues.push_back(rms);
+    int windowSize = (int)(0.1f * context.audio().sampleRate); // 100ms
+    std::vector<float> rmsValues = context.energy().windowSums(windowSize, windowSize);
+    for (float& rms : rmsValues) {
+        rms = std::sqrt(rms / windowSize);
     }
     
     if (rmsValues.empty()) return 0.0f;
@@ -70,9 +69,9 @@ float ConfidenceCalculator::calculateSNR(const AudioBuffer& audio) {
     return 20.0f * std::log10(signalLevel / noiseFloor);
 }
 
-float ConfidenceCalculator::detectCompressionArtifacts(const AudioBuffer& audio) {
+float ConfidenceCalculator::detectCompressionArtifacts(const AnalysisContext& context) {
     // Look for typical compression artifacts
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
+    const SpectralFeatures& features = context.spectrum();
     
     float artifactScore = 0.0f;
     
@@ -86,7 +85,7 @@ float ConfidenceCalculator::detectCompressionArtifacts(const AudioBuffer& audio)
     if (totalEnergy > 0) {
         float highFreqEnergy = 0.0f;
         for (size_t i = 0; i < features.magnitude.size(); i++) {
-            if (features.frequencies[i] > 15000.0f) {
+            if (features.frequency(i) > 15000.0f) {
                 highFreqEnergy += features.magnitude[i];
             }
         }
@@ -99,7 +98,7 @@ float ConfidenceCalculator::detectCompressionArtifacts(const AudioBuffer& audio)
     
     // Quantization noise
     CharacteristicsExtractor extractor;
-    if (extractor.hasCompression(audio)) {
+    if (extractor.hasCompression(context)) {
         artifactScore += 0.3f;
     }
     
@@ -107,7 +106,7 @@ float ConfidenceCalculator::detectCompressionArtifacts(const AudioBuffer& audio)
 }
 
 bool ConfidenceCalculator::isFrequencyResponseComplete(const SpectralFeatures& features) {
-    if (features.frequencies.empty()) return false;
+    if (features.magnitude.empty()) return false;
     
     // Check if we have reasonable energy across the spectrum
     float totalEnergy = std::accumulate(features.magnitude.begin(), features.magnitude.end(), 0.0f);
@@ -117,9 +116,9 @@ bool ConfidenceCalculator::isFrequencyResponseComplete(const SpectralFeatures& f
     float lowEnergy = 0.0f, midEnergy = 0.0f, highEnergy = 0.0f;
     
     for (size_t i = 0; i < features.magnitude.size(); i++) {
-        if (features.frequencies[i] < 500.0f) {
+        if (features.frequency(i) < 500.0f) {
             lowEnergy += features.magnitude[i];
-        } else if (features.frequencies[i] < 4000.0f) {
+        } else if (features.frequency(i) < 4000.0f) {
             midEnergy += features.magnitude[i];
         } else {
             highEnergy += features.magnitude[i];
@@ -335,11 +334,15 @@ std::vector<std::string> GenreClassifier::classifySubgenres(const AudioBuffer& a
 }
 
 std::string GenreClassifier::classifyEra(const AudioBuffer& audio, const AIAnalysisResult& features) {
-    std::string productionStyle = analyzeProductionTechniques(AudioProcessor::calculateSpectralFeatures(audio));
-    std::string instrumentation = analyzeInstrumentationPatterns(audio);
+    return classifyEra(AnalysisContext(audio), features);
+}
+
+std::string GenreClassifier::classifyEra(const AnalysisContext& context, const AIAnalysisResult& features) {
+    const SpectralFeatures& spectralFeatures = context.spectrum();
+    std::string productionStyle = analyzeProductionTechniques(spectralFeatures);
+    std::string instrumentation = analyzeInstrumentationPatterns(spectralFeatures);
     
     // Era classification based on production characteristics
-    SpectralFeatures spectralFeatures = AudioProcessor::calculateSpectralFeatures(audio);
     
     // 2010s-2020s: Heavy compression, loud mastering
     if (features.AI_LOUDNESS > -8.0f && hasVintageCharacteristics(spectralFeatures) == false) {
@@ -396,9 +399,7 @@ std::string GenreClassifier::analyzeProductionTechniques(const SpectralFeatures&
     return techniques;
 }
 
-std::string GenreClassifier::analyzeInstrumentationPatterns(const AudioBuffer& audio) {
-    SpectralFeatures features = AudioProcessor::calculateSpectralFeatures(audio);
-    
+std::string GenreClassifier::analyzeInstrumentationPatterns(const SpectralFeatures& features) {
     if (features.spectralCentroid > 3000.0f && features.zeroCrossingRate > 0.08f) {
         return "Electronic instruments";
     } else if (features.spectralCentroid > 1500.0f && features.spectralCentroid < 3000.0f) {
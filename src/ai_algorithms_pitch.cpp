@@ -0,0 +1,102 @@
+// Pitch tracking - one YIN f0 track per song, shared by every melodic analyzer
+
+#include "ai_algorithms.h"
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🎤 YIN PITCH TRACK
+// ========================================
+
+PitchTrack PitchTracker::track(SampleSpan samples, int sampleRate) {
+    PitchTrack track;
+    track.sampleRate = sampleRate;
+    track.frameSize = static_cast<int>(0.05f * sampleRate);  // 50ms frames
+    track.hopSize = std::max(1, track.frameSize / 4);         // 75% overlap
+    
+    const int frameSize = track.frameSize;
+    const int minPeriod = std::max(2, static_cast<int>(sampleRate / MAX_FREQUENCY));
+    const int maxPeriod = std::min(frameSize / 2 - 1, static_cast<int>(sampleRate / MIN_FREQUENCY));
+    if (maxPeriod <= minPeriod || (int)samples.size() < frameSize) return track;
+    
+    const size_t frameCount = (samples.size() - frameSize) / track.hopSize + 1;
+    track.f0.reserve(frameCount);
+    track.confidence.reserve(frameCount);
+    track.voiced.reserve(frameCount);
+    
+    // Window, frame and FFT kernel are shared by all frames
+    std::vector<float> hann(frameSize);
+    for (int j = 0; j < frameSize; ++j) {
+        hann[j] = 0.5f * (1.0f - std::cos(2.0f * M_PI * j / (frameSize - 1)));
+    }
+    std::vector<float> frame(frameSize);
+    std::vector<float> cmndf;
+    YinDifference yin(frameSize);
+    
+    for (size_t start = 0; start + frameSize <= samples.size(); start += track.hopSize) {
+        for (int j = 0; j < frameSize; ++j) {
+            frame[j] = samples[start + j] * hann[j];
+        }
+        
+        const std::vector<float>& diff = yin.compute(frame);
+        calculateCMNDF(diff, cmndf);
+        
+        int tau = findPitchPeriod(cmndf, minPeriod, maxPeriod);
+        if (tau > 0) {
+            track.f0.push_back(sampleRate / parabolicInterpolation(diff, tau));
+            track.confidence.push_back(1.0f - cmndf[tau]);
+            track.voiced.push_back(1);
+        } else {
+            track.f0.push_back(0.0f);
+            track.confidence.push_back(0.0f);
+            track.voiced.push_back(0);
+        }
+    }
+    
+    return track;
+}
+
+void PitchTracker::calculateCMNDF(const std::vector<float>& diff, std::vector<float>& cmndf) {
+    cmndf.resize(diff.size());
+    cmndf[0] = 1.0f;
+    
+    float runningSum = 0.0f;
+    for (size_t tau = 1; tau < diff.size(); ++tau) {
+        runningSum += diff[tau];
+        cmndf[tau] = runningSum > 0 ? diff[tau] * tau / runningSum : 1.0f;
+    }
+}
+
+int PitchTracker::findPitchPeriod(const std::vector<float>& cmndf, int minPeriod, int maxPeriod) {
+    // First local minimum below the threshold
+    for (int tau = minPeriod; tau < maxPeriod; ++tau) {
+        if (cmndf[tau] < YIN_THRESHOLD && cmndf[tau] < cmndf[tau - 1] && cmndf[tau] < cmndf[tau + 1]) {
+            return tau;
+        }
+    }
+    
+    // Otherwise the absolute minimum, if it is periodic enough
+    int minTau = minPeriod;
+    for (int tau = minPeriod + 1; tau < maxPeriod; ++tau) {
+        if (cmndf[tau] < cmndf[minTau]) minTau = tau;
+    }
+    
+    return cmndf[minTau] < VOICING_LIMIT ? minTau : 0;
+}
+
+float PitchTracker::parabolicInterpolation(const std::vector<float>& diff, int tau) {
+    if (tau <= 0 || tau >= static_cast<int>(diff.size()) - 1) return tau;
+    
+    float s0 = diff[tau - 1];
+    float s1 = diff[tau];
+    float s2 = diff[tau + 1];
+    
+    float a = s2 - s1;
+    float b = s0 - s1;
+    
+    if (a + b == 0) return tau;
+    
+    return tau + 0.5f * (b - a) / (a + b);
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,230 @@
+// Parallel scheduling - work-stealing thread pool and analyzer dependency graph
+
+#include "ai_algorithms.h"
+
+namespace MusicAnalysis {
+
+// ========================================
+// ⚡ WORK-STEALING THREAD POOL
+// ========================================
+
+namespace {
+
+// Identifies the pool worker running on this thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    queues.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    // Workers keep their own follow-up tasks local; outside callers spread work round-robin
+    size_t index = currentPool == this
+        ? currentWorker
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    // Count before publishing so a thief can never decrement below zero
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pendingTasks++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wakeCondition.notify_one();
+}
+
+bool ThreadPool::popTask(size_t index, std::function<void()>& task) {
+    // Newest local task first (cache-warm), then steal the oldest task of another worker
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pendingTasks--;
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pendingTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() { return stopping || pendingTasks > 0; });
+
+        if (stopping && pendingTasks == 0) return;
+    }
+}
+
+// ========================================
+// 🕸️ TASK DEPENDENCY GRAPH
+// ========================================
+
+struct TaskGraph::State {
+    struct Node {
+        std::function<void()> work;
+        std::vector<TaskId> dependents;
+        size_t dependencyCount = 0;
+        size_t remaining = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::deque<TaskId> ready;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t completed = 0;
+    std::exception_ptr firstError;
+};
+
+TaskGraph::TaskGraph()
+    : state(std::make_shared<State>()) {}
+
+TaskGraph::TaskId TaskGraph::addTask(std::function<void()> work, const std::vector<TaskId>& dependencies) {
+    TaskId id = state->nodes.size();
+
+    State::Node node;
+    node.work = std::move(work);
+    node.dependencyCount = dependencies.size();
+    state->nodes.push_back(std::move(node));
+
+    for (TaskId dependency : dependencies) {
+        state->nodes[dependency].dependents.push_back(id);
+    }
+
+    return id;
+}
+
+void TaskGraph::run(ThreadPool& pool) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    state->completed = 0;
+    state->firstError = nullptr;
+    for (auto& node : state->nodes) {
+        node.remaining = node.dependencyCount;
+    }
+
+    for (TaskId id = 0; id < state->nodes.size(); id++) {
+        if (state->nodes[id].dependencyCount == 0) {
+            schedule(state, pool, id);
+        }
+    }
+
+    // The calling thread runs this graph's ready tasks too, so nested graphs on
+    // pool workers always make progress without picking up unrelated work
+    while (state->completed < state->nodes.size()) {
+        if (!state->ready.empty()) {
+            lock.unlock();
+            runReadyTask(state, pool);
+            lock.lock();
+        } else {
+            state->changed.wait(lock, [this]() {
+                return state->completed == state->nodes.size() || !state->ready.empty();
+            });
+        }
+    }
+
+    if (state->firstError) {
+        std::rethrow_exception(state->firstError);
+    }
+}
+
+void TaskGraph::schedule(const std::shared_ptr<State>& state, ThreadPool& pool, TaskId id) {
+    // Called with state->mutex held
+    state->ready.push_back(id);
+    pool.enqueue([state, &pool]() { runReadyTask(state, pool); });
+}
+
+bool TaskGraph::runReadyTask(const std::shared_ptr<State>& state, ThreadPool& pool) {
+    TaskId id;
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->ready.empty()) return false;  // Already taken by the waiting thread
+
+        id = state->ready.front();
+        state->ready.pop_front();
+        failed = state->firstError != nullptr;
+    }
+
+    // Once a task failed, remaining tasks are only drained so run() can return
+    if (!failed) {
+        try {
+            state->nodes[id].work();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->firstError) state->firstError = std::current_exception();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (TaskId dependent : state->nodes[id].dependents) {
+            if (--state->nodes[dependent].remaining == 0) {
+                schedule(state, pool, dependent);
+            }
+        }
+        state->completed++;
+    }
+    state->changed.notify_all();
+
+    return true;
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,902 @@
+// SIMD kernels - float reductions with runtime instruction set dispatch
+
+#include "ai_algorithms.h"
+#include <limits>
+#include <cstring>
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AI_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🚀 SIMD KERNELS
+// ========================================
+
+namespace {
+
+struct KernelTable {
+    const char* name;
+    float (*sumOfSquares)(const float*, size_t);
+    float (*dot)(const float*, const float*, size_t);
+    float (*maxValue)(const float*, size_t);
+    float (*minValue)(const float*, size_t);
+    float (*positiveDifferenceSum)(const float*, const float*, size_t);
+    void (*complexMagnitude)(const float*, float*, size_t);  // Interleaved re/im pairs
+    void (*spectralMoments)(const float*, size_t, size_t, SpectralMoments&);  // Adds from bin index first
+    // Rows [first, count)
+    void (*weightedSquaredDistances)(const float* const*, int, const float*, const float*, float*, size_t, size_t);
+    // Rows [first, count) of 1- or 2-byte code columns
+    void (*quantizedSquaredDistances)(const void* const*, int, int, const float*, const float*, float*, size_t, size_t);
+};
+
+// Cephes logf: ln x = e ln 2 + ln m with m in [sqrt(1/2), sqrt(2)), ln m by a
+// degree-9 polynomial in m - 1. ln 2 is split in two for exactness.
+constexpr float LOG_SQRT_HALF = 0.707106781186547524f;
+constexpr float LOG_P[9] = { 7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f,
+                             1.4249322787e-1f, -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f,
+                             3.3333331174e-1f };
+constexpr float LOG_LN2_HIGH = 0.693359375f;
+constexpr float LOG_LN2_LOW = -2.12194440e-4f;
+
+// ---- Scalar (reference and tails) ----
+
+// Four partial sums keep the dependency chain short even without vectors
+float scalarSumOfSquares(const float* data, size_t count) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        s0 += data[i] * data[i];
+        s1 += data[i + 1] * data[i + 1];
+        s2 += data[i + 2] * data[i + 2];
+        s3 += data[i + 3] * data[i + 3];
+    }
+    for (; i < count; i++) s0 += data[i] * data[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+float scalarDot(const float* a, const float* b, size_t count) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < count; i++) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+float scalarMaxValue(const float* data, size_t count) {
+    float result = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; i++) result = std::max(result, data[i]);
+    return result;
+}
+
+float scalarMinValue(const float* data, size_t count) {
+    float result = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; i++) result = std::min(result, data[i]);
+    return result;
+}
+
+float scalarPositiveDifferenceSum(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float diff = a[i] - b[i];
+        if (diff > 0) sum += diff;
+    }
+    return sum;
+}
+
+void scalarComplexMagnitude(const float* input, float* output, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float re = input[2 * i];
+        float im = input[2 * i + 1];
+        output[i] = std::sqrt(re * re + im * im);
+    }
+}
+
+void scalarSpectralMoments(const float* magnitude, size_t count, size_t first, SpectralMoments& sums) {
+    for (size_t i = 0; i < count; i++) {
+        float m = magnitude[i];
+        float k = static_cast<float>(first + i);
+        float logM = std::log(std::max(m, VectorKernels::LOG_FLOOR));
+        sums.magnitude += m;
+        sums.indexWeighted += k * m;
+        sums.indexSquaredWeighted += k * k * m;
+        sums.power += m * m;
+        sums.logMagnitude += logM;
+        sums.powerLogMagnitude += m * m * logM;
+    }
+}
+
+void scalarWeightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                    const float* weights, float* distances, size_t first, size_t count) {
+    for (size_t i = first; i < count; i++) {
+        float sum = 0.0f;
+        for (int d = 0; d < dimensions; d++) {
+            float delta = columns[d][i] - query[d];
+            sum += delta * weights[d] * delta;
+        }
+        distances[i] = sum;
+    }
+}
+
+template <typename Code>
+void scalarCodeDistances(const void* const* columns, int dimensions, const float* query,
+                         const float* weights, float* distances, size_t first, size_t count) {
+    for (size_t i = first; i < count; i++) {
+        float sum = 0.0f;
+        for (int d = 0; d < dimensions; d++) {
+            float delta = static_cast<const Code*>(columns[d])[i] - query[d];
+            sum += delta * weights[d] * delta;
+        }
+        distances[i] = sum;
+    }
+}
+
+void scalarQuantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions, const float* query,
+                                     const float* weights, float* distances, size_t first, size_t count) {
+    if (codeBytes == 1) {
+        scalarCodeDistances<uint8_t>(columns, dimensions, query, weights, distances, first, count);
+    } else {
+        scalarCodeDistances<uint16_t>(columns, dimensions, query, weights, distances, first, count);
+    }
+}
+
+#ifdef AI_KERNELS_X86
+
+// ---- SSE (baseline on x86-64) ----
+
+__attribute__((target("sse2")))
+float horizontalSum(__m128 v) {
+    __m128 high = _mm_movehl_ps(v, v);
+    __m128 pair = _mm_add_ps(v, high);
+    __m128 odd = _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(1, 1, 1, 1));
+    return _mm_cvtss_f32(_mm_add_ss(pair, odd));
+}
+
+__attribute__((target("sse2")))
+float sseSumOfSquares(const float* data, size_t count) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 x0 = _mm_loadu_ps(data + i);
+        __m128 x1 = _mm_loadu_ps(data + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(x0, x0));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(x1, x1));
+    }
+    return horizontalSum(_mm_add_ps(acc0, acc1)) + scalarSumOfSquares(data + i, count - i);
+}
+
+__attribute__((target("sse2")))
+float sseDot(const float* a, const float* b, size_t count) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    return horizontalSum(_mm_add_ps(acc0, acc1)) + scalarDot(a + i, b + i, count - i);
+}
+
+__attribute__((target("sse2")))
+float sseMaxValue(const float* data, size_t count) {
+    if (count < 4) return scalarMaxValue(data, count);
+    __m128 acc = _mm_loadu_ps(data);
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) acc = _mm_max_ps(acc, _mm_loadu_ps(data + i));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return std::max(scalarMaxValue(lanes, 4), scalarMaxValue(data + i, count - i));
+}
+
+__attribute__((target("sse2")))
+float sseMinValue(const float* data, size_t count) {
+    if (count < 4) return scalarMinValue(data, count);
+    __m128 acc = _mm_loadu_ps(data);
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) acc = _mm_min_ps(acc, _mm_loadu_ps(data + i));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return std::min(scalarMinValue(lanes, 4), scalarMinValue(data + i, count - i));
+}
+
+__attribute__((target("sse2")))
+float ssePositiveDifferenceSum(const float* a, const float* b, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 acc = zero;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 diff = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        acc = _mm_add_ps(acc, _mm_max_ps(diff, zero));
+    }
+    return horizontalSum(acc) + scalarPositiveDifferenceSum(a + i, b + i, count - i);
+}
+
+__attribute__((target("sse2")))
+void sseComplexMagnitude(const float* input, float* output, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 p0 = _mm_loadu_ps(input + 2 * i);       // re0 im0 re1 im1
+        __m128 p1 = _mm_loadu_ps(input + 2 * i + 4);   // re2 im2 re3 im3
+        __m128 re = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+        _mm_storeu_ps(output + i, _mm_sqrt_ps(power));
+    }
+    scalarComplexMagnitude(input + 2 * i, output + i, count - i);
+}
+
+__attribute__((target("sse2")))
+__m128 sseLog(__m128 x) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    x = _mm_max_ps(x, _mm_set1_ps(VectorKernels::LOG_FLOOR));
+    
+    // x = m 2^e with m in [0.5, 1)
+    __m128i bits = _mm_castps_si128(x);
+    __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                             _mm_set1_epi32(0x3f000000)));
+    
+    // Below sqrt(1/2): use 2m and e - 1
+    __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(LOG_SQRT_HALF));
+    e = _mm_sub_ps(e, _mm_and_ps(small, one));
+    m = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(small, m)), one);
+    
+    __m128 z = _mm_mul_ps(m, m);
+    __m128 y = _mm_set1_ps(LOG_P[0]);
+    for (int k = 1; k < 9; k++) y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P[k]));
+    y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(LOG_LN2_LOW)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    return _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(e, _mm_set1_ps(LOG_LN2_HIGH)));
+}
+
+__attribute__((target("sse2")))
+void sseSpectralMoments(const float* magnitude, size_t count, size_t first, SpectralMoments& sums) {
+    __m128 sum = _mm_setzero_ps(), indexed = _mm_setzero_ps(), indexedSquared = _mm_setzero_ps();
+    __m128 power = _mm_setzero_ps(), logSum = _mm_setzero_ps(), powerLog = _mm_setzero_ps();
+    __m128 k = _mm_add_ps(_mm_set1_ps(static_cast<float>(first)), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    const __m128 step = _mm_set1_ps(4.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 m = _mm_loadu_ps(magnitude + i);
+        __m128 logM = sseLog(m);
+        __m128 km = _mm_mul_ps(k, m);
+        __m128 m2 = _mm_mul_ps(m, m);
+        sum = _mm_add_ps(sum, m);
+        indexed = _mm_add_ps(indexed, km);
+        indexedSquared = _mm_add_ps(indexedSquared, _mm_mul_ps(k, km));
+        power = _mm_add_ps(power, m2);
+        logSum = _mm_add_ps(logSum, logM);
+        powerLog = _mm_add_ps(powerLog, _mm_mul_ps(m2, logM));
+        k = _mm_add_ps(k, step);
+    }
+    sums.magnitude += horizontalSum(sum);
+    sums.indexWeighted += horizontalSum(indexed);
+    sums.indexSquaredWeighted += horizontalSum(indexedSquared);
+    sums.power += horizontalSum(power);
+    sums.logMagnitude += horizontalSum(logSum);
+    sums.powerLogMagnitude += horizontalSum(powerLog);
+    scalarSpectralMoments(magnitude + i, count - i, first + i, sums);
+}
+
+// Rows across the lanes, dimensions down the loop: each column is read once
+__attribute__((target("sse2")))
+void sseWeightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                 const float* weights, float* distances, size_t first, size_t count) {
+    __m128 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm_set1_ps(query[d]);
+        w[d] = _mm_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 4 <= count; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m128 delta = _mm_sub_ps(_mm_loadu_ps(columns[d] + i), q[d]);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_mul_ps(delta, w[d]), delta));
+        }
+        _mm_storeu_ps(distances + i, sum);
+    }
+    scalarWeightedSquaredDistances(columns, dimensions, query, weights, distances, i, count);
+}
+
+// Codes widen to 32-bit lanes and then to float, so the float kernel's arithmetic applies
+__attribute__((target("sse2")))
+__m128 sseLoadCodes(const uint8_t* codes) {
+    int32_t packed;
+    std::memcpy(&packed, codes, sizeof(packed));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero));
+}
+
+__attribute__((target("sse2")))
+__m128 sseLoadCodes(const uint16_t* codes) {
+    __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+}
+
+template <typename Code>
+__attribute__((target("sse2")))
+void sseCodeDistances(const void* const* columns, int dimensions, const float* query,
+                      const float* weights, float* distances, size_t first, size_t count) {
+    __m128 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm_set1_ps(query[d]);
+        w[d] = _mm_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 4 <= count; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m128 delta = _mm_sub_ps(sseLoadCodes(static_cast<const Code*>(columns[d]) + i), q[d]);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_mul_ps(delta, w[d]), delta));
+        }
+        _mm_storeu_ps(distances + i, sum);
+    }
+    scalarCodeDistances<Code>(columns, dimensions, query, weights, distances, i, count);
+}
+
+void sseQuantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions, const float* query,
+                                  const float* weights, float* distances, size_t first, size_t count) {
+    if (codeBytes == 1) {
+        sseCodeDistances<uint8_t>(columns, dimensions, query, weights, distances, first, count);
+    } else {
+        sseCodeDistances<uint16_t>(columns, dimensions, query, weights, distances, first, count);
+    }
+}
+
+// ---- AVX2 + FMA ----
+// Every AVX function clears the upper register halves before any SSE-encoded
+// code runs (tails, libm, FFTW); a dirty upper state makes each later legacy
+// SSE instruction pay a transition penalty.
+
+__attribute__((target("avx2,fma")))
+float avx2Sum(__m256 v) {
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, v);
+    float sum = 0.0f;
+    for (int k = 0; k < 4; k++) sum += lanes[k] + lanes[k + 4];
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+float avx2SumOfSquares(const float* data, size_t count) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(data + i);
+        __m256 x1 = _mm256_loadu_ps(data + i + 8);
+        acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm256_fmadd_ps(x1, x1, acc1);
+    }
+    float sum = avx2Sum(_mm256_add_ps(acc0, acc1));
+    _mm256_zeroupper();
+    return sum + scalarSumOfSquares(data + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+float avx2Dot(const float* a, const float* b, size_t count) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    float sum = avx2Sum(_mm256_add_ps(acc0, acc1));
+    _mm256_zeroupper();
+    return sum + scalarDot(a + i, b + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+float avx2MaxValue(const float* data, size_t count) {
+    if (count < 8) return scalarMaxValue(data, count);
+    __m256 acc = _mm256_loadu_ps(data);
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) acc = _mm256_max_ps(acc, _mm256_loadu_ps(data + i));
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    _mm256_zeroupper();
+    return std::max(scalarMaxValue(lanes, 8), scalarMaxValue(data + i, count - i));
+}
+
+__attribute__((target("avx2,fma")))
+float avx2MinValue(const float* data, size_t count) {
+    if (count < 8) return scalarMinValue(data, count);
+    __m256 acc = _mm256_loadu_ps(data);
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) acc = _mm256_min_ps(acc, _mm256_loadu_ps(data + i));
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    _mm256_zeroupper();
+    return std::min(scalarMinValue(lanes, 8), scalarMinValue(data + i, count - i));
+}
+
+__attribute__((target("avx2,fma")))
+float avx2PositiveDifferenceSum(const float* a, const float* b, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc = _mm256_add_ps(acc, _mm256_max_ps(diff, zero));
+    }
+    float sum = avx2Sum(acc);
+    _mm256_zeroupper();
+    return sum + scalarPositiveDifferenceSum(a + i, b + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void avx2ComplexMagnitude(const float* input, float* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 p0 = _mm256_loadu_ps(input + 2 * i);       // Complex 0-3
+        __m256 p1 = _mm256_loadu_ps(input + 2 * i + 8);   // Complex 4-7
+        // In-lane shuffles leave the results in order 0 1 4 5 2 3 6 7
+        __m256 re = _mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im = _mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 power = _mm256_fmadd_ps(re, re, _mm256_mul_ps(im, im));
+        __m256 magnitude = _mm256_sqrt_ps(power);
+        magnitude = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(magnitude), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(output + i, magnitude);
+    }
+    _mm256_zeroupper();
+    sseComplexMagnitude(input + 2 * i, output + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+__m256 avx2Log(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    x = _mm256_max_ps(x, _mm256_set1_ps(VectorKernels::LOG_FLOOR));
+    
+    // x = m 2^e with m in [0.5, 1)
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                                   _mm256_set1_epi32(0x3f000000)));
+    
+    // Below sqrt(1/2): use 2m and e - 1
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(LOG_SQRT_HALF), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), one);
+    
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(LOG_P[0]);
+    for (int k = 1; k < 9; k++) y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(LOG_P[k]));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(LOG_LN2_LOW), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(LOG_LN2_HIGH), _mm256_add_ps(m, y));
+}
+
+__attribute__((target("avx2,fma")))
+void avx2SpectralMoments(const float* magnitude, size_t count, size_t first, SpectralMoments& sums) {
+    __m256 sum = _mm256_setzero_ps(), indexed = _mm256_setzero_ps(), indexedSquared = _mm256_setzero_ps();
+    __m256 power = _mm256_setzero_ps(), logSum = _mm256_setzero_ps(), powerLog = _mm256_setzero_ps();
+    __m256 k = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(first)),
+                             _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    const __m256 step = _mm256_set1_ps(8.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 m = _mm256_loadu_ps(magnitude + i);
+        __m256 logM = avx2Log(m);
+        __m256 km = _mm256_mul_ps(k, m);
+        __m256 m2 = _mm256_mul_ps(m, m);
+        sum = _mm256_add_ps(sum, m);
+        indexed = _mm256_add_ps(indexed, km);
+        indexedSquared = _mm256_fmadd_ps(k, km, indexedSquared);
+        power = _mm256_add_ps(power, m2);
+        logSum = _mm256_add_ps(logSum, logM);
+        powerLog = _mm256_fmadd_ps(m2, logM, powerLog);
+        k = _mm256_add_ps(k, step);
+    }
+    sums.magnitude += avx2Sum(sum);
+    sums.indexWeighted += avx2Sum(indexed);
+    sums.indexSquaredWeighted += avx2Sum(indexedSquared);
+    sums.power += avx2Sum(power);
+    sums.logMagnitude += avx2Sum(logSum);
+    sums.powerLogMagnitude += avx2Sum(powerLog);
+    _mm256_zeroupper();
+    scalarSpectralMoments(magnitude + i, count - i, first + i, sums);
+}
+
+__attribute__((target("avx2,fma")))
+void avx2WeightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                  const float* weights, float* distances, size_t first, size_t count) {
+    __m256 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm256_set1_ps(query[d]);
+        w[d] = _mm256_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 8 <= count; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m256 delta = _mm256_sub_ps(_mm256_loadu_ps(columns[d] + i), q[d]);
+            sum = _mm256_fmadd_ps(_mm256_mul_ps(delta, w[d]), delta, sum);
+        }
+        _mm256_storeu_ps(distances + i, sum);
+    }
+    _mm256_zeroupper();
+    scalarWeightedSquaredDistances(columns, dimensions, query, weights, distances, i, count);
+}
+
+__attribute__((target("avx2,fma")))
+__m256 avx2LoadCodes(const uint8_t* codes) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes))));
+}
+
+__attribute__((target("avx2,fma")))
+__m256 avx2LoadCodes(const uint16_t* codes) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(codes))));
+}
+
+template <typename Code>
+__attribute__((target("avx2,fma")))
+void avx2CodeDistances(const void* const* columns, int dimensions, const float* query,
+                       const float* weights, float* distances, size_t first, size_t count) {
+    __m256 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm256_set1_ps(query[d]);
+        w[d] = _mm256_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 8 <= count; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m256 delta = _mm256_sub_ps(avx2LoadCodes(static_cast<const Code*>(columns[d]) + i), q[d]);
+            sum = _mm256_fmadd_ps(_mm256_mul_ps(delta, w[d]), delta, sum);
+        }
+        _mm256_storeu_ps(distances + i, sum);
+    }
+    _mm256_zeroupper();
+    scalarCodeDistances<Code>(columns, dimensions, query, weights, distances, i, count);
+}
+
+void avx2QuantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions, const float* query,
+                                   const float* weights, float* distances, size_t first, size_t count) {
+    if (codeBytes == 1) {
+        avx2CodeDistances<uint8_t>(columns, dimensions, query, weights, distances, first, count);
+    } else {
+        avx2CodeDistances<uint16_t>(columns, dimensions, query, weights, distances, first, count);
+    }
+}
+
+// ---- AVX-512 ----
+
+// GCC 12's AVX-512 headers trip -Wuninitialized on their own undefined
+// pass-through operands
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+float avx512Sum(__m512 v) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, v);
+    float sum = 0.0f;
+    for (int k = 0; k < 8; k++) sum += lanes[k] + lanes[k + 8];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+float avx512SumOfSquares(const float* data, size_t count) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512 x0 = _mm512_loadu_ps(data + i);
+        __m512 x1 = _mm512_loadu_ps(data + i + 16);
+        acc0 = _mm512_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm512_fmadd_ps(x1, x1, acc1);
+    }
+    float sum = avx512Sum(_mm512_add_ps(acc0, acc1));
+    _mm256_zeroupper();
+    return sum + scalarSumOfSquares(data + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+float avx512Dot(const float* a, const float* b, size_t count) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    float sum = avx512Sum(_mm512_add_ps(acc0, acc1));
+    _mm256_zeroupper();
+    return sum + scalarDot(a + i, b + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+float avx512MaxValue(const float* data, size_t count) {
+    if (count < 16) return scalarMaxValue(data, count);
+    __m512 acc = _mm512_loadu_ps(data);
+    size_t i = 16;
+    for (; i + 16 <= count; i += 16) acc = _mm512_max_ps(acc, _mm512_loadu_ps(data + i));
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, acc);
+    _mm256_zeroupper();
+    return std::max(scalarMaxValue(lanes, 16), scalarMaxValue(data + i, count - i));
+}
+
+__attribute__((target("avx512f")))
+float avx512MinValue(const float* data, size_t count) {
+    if (count < 16) return scalarMinValue(data, count);
+    __m512 acc = _mm512_loadu_ps(data);
+    size_t i = 16;
+    for (; i + 16 <= count; i += 16) acc = _mm512_min_ps(acc, _mm512_loadu_ps(data + i));
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, acc);
+    _mm256_zeroupper();
+    return std::min(scalarMinValue(lanes, 16), scalarMinValue(data + i, count - i));
+}
+
+__attribute__((target("avx512f")))
+float avx512PositiveDifferenceSum(const float* a, const float* b, size_t count) {
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 acc = zero;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        acc = _mm512_add_ps(acc, _mm512_max_ps(diff, zero));
+    }
+    float sum = avx512Sum(acc);
+    _mm256_zeroupper();
+    return sum + scalarPositiveDifferenceSum(a + i, b + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void avx512ComplexMagnitude(const float* input, float* output, size_t count) {
+    // Gather even (re) and odd (im) floats of two registers into one each
+    const __m512i evenIndex = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i oddIndex = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 p0 = _mm512_loadu_ps(input + 2 * i);
+        __m512 p1 = _mm512_loadu_ps(input + 2 * i + 16);
+        __m512 re = _mm512_permutex2var_ps(p0, evenIndex, p1);
+        __m512 im = _mm512_permutex2var_ps(p0, oddIndex, p1);
+        __m512 power = _mm512_fmadd_ps(re, re, _mm512_mul_ps(im, im));
+        _mm512_storeu_ps(output + i, _mm512_sqrt_ps(power));
+    }
+    _mm256_zeroupper();
+    sseComplexMagnitude(input + 2 * i, output + i, count - i);
+}
+
+// getexp/getmant split x into 2^e and m in [1, 2); the Cephes range is [0.5, 1)
+__attribute__((target("avx512f")))
+__m512 avx512Log(__m512 x) {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    x = _mm512_max_ps(x, _mm512_set1_ps(VectorKernels::LOG_FLOOR));
+    
+    __m512 e = _mm512_add_ps(_mm512_getexp_ps(x), one);
+    __m512 m = _mm512_mul_ps(_mm512_getmant_ps(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src), _mm512_set1_ps(0.5f));
+    
+    // Below sqrt(1/2): use 2m and e - 1
+    __mmask16 small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(LOG_SQRT_HALF), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, small, e, one);
+    m = _mm512_sub_ps(_mm512_mask_add_ps(m, small, m, m), one);
+    
+    __m512 z = _mm512_mul_ps(m, m);
+    __m512 y = _mm512_set1_ps(LOG_P[0]);
+    for (int k = 1; k < 9; k++) y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(LOG_P[k]));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(LOG_LN2_LOW), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    return _mm512_fmadd_ps(e, _mm512_set1_ps(LOG_LN2_HIGH), _mm512_add_ps(m, y));
+}
+
+__attribute__((target("avx512f")))
+void avx512SpectralMoments(const float* magnitude, size_t count, size_t first, SpectralMoments& sums) {
+    __m512 sum = _mm512_setzero_ps(), indexed = _mm512_setzero_ps(), indexedSquared = _mm512_setzero_ps();
+    __m512 power = _mm512_setzero_ps(), logSum = _mm512_setzero_ps(), powerLog = _mm512_setzero_ps();
+    __m512 k = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(first)),
+                             _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                            8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f));
+    const __m512 step = _mm512_set1_ps(16.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 m = _mm512_loadu_ps(magnitude + i);
+        __m512 logM = avx512Log(m);
+        __m512 km = _mm512_mul_ps(k, m);
+        __m512 m2 = _mm512_mul_ps(m, m);
+        sum = _mm512_add_ps(sum, m);
+        indexed = _mm512_add_ps(indexed, km);
+        indexedSquared = _mm512_fmadd_ps(k, km, indexedSquared);
+        power = _mm512_add_ps(power, m2);
+        logSum = _mm512_add_ps(logSum, logM);
+        powerLog = _mm512_fmadd_ps(m2, logM, powerLog);
+        k = _mm512_add_ps(k, step);
+    }
+    sums.magnitude += avx512Sum(sum);
+    sums.indexWeighted += avx512Sum(indexed);
+    sums.indexSquaredWeighted += avx512Sum(indexedSquared);
+    sums.power += avx512Sum(power);
+    sums.logMagnitude += avx512Sum(logSum);
+    sums.powerLogMagnitude += avx512Sum(powerLog);
+    _mm256_zeroupper();
+    scalarSpectralMoments(magnitude + i, count - i, first + i, sums);
+}
+
+__attribute__((target("avx512f")))
+void avx512WeightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                    const float* weights, float* distances, size_t first, size_t count) {
+    __m512 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm512_set1_ps(query[d]);
+        w[d] = _mm512_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 16 <= count; i += 16) {
+        __m512 sum = _mm512_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m512 delta = _mm512_sub_ps(_mm512_loadu_ps(columns[d] + i), q[d]);
+            sum = _mm512_fmadd_ps(_mm512_mul_ps(delta, w[d]), delta, sum);
+        }
+        _mm512_storeu_ps(distances + i, sum);
+    }
+    _mm256_zeroupper();
+    scalarWeightedSquaredDistances(columns, dimensions, query, weights, distances, i, count);
+}
+
+__attribute__((target("avx512f")))
+__m512 avx512LoadCodes(const uint8_t* codes) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(codes))));
+}
+
+__attribute__((target("avx512f")))
+__m512 avx512LoadCodes(const uint16_t* codes) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes))));
+}
+
+template <typename Code>
+__attribute__((target("avx512f")))
+void avx512CodeDistances(const void* const* columns, int dimensions, const float* query,
+                         const float* weights, float* distances, size_t first, size_t count) {
+    __m512 q[VectorKernels::MAX_DIMENSIONS], w[VectorKernels::MAX_DIMENSIONS];
+    for (int d = 0; d < dimensions; d++) {
+        q[d] = _mm512_set1_ps(query[d]);
+        w[d] = _mm512_set1_ps(weights[d]);
+    }
+    size_t i = first;
+    for (; i + 16 <= count; i += 16) {
+        __m512 sum = _mm512_setzero_ps();
+        for (int d = 0; d < dimensions; d++) {
+            __m512 delta = _mm512_sub_ps(avx512LoadCodes(static_cast<const Code*>(columns[d]) + i), q[d]);
+            sum = _mm512_fmadd_ps(_mm512_mul_ps(delta, w[d]), delta, sum);
+        }
+        _mm512_storeu_ps(distances + i, sum);
+    }
+    _mm256_zeroupper();
+    scalarCodeDistances<Code>(columns, dimensions, query, weights, distances, i, count);
+}
+
+void avx512QuantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions, const float* query,
+                                     const float* weights, float* distances, size_t first, size_t count) {
+    if (codeBytes == 1) {
+        avx512CodeDistances<uint8_t>(columns, dimensions, query, weights, distances, first, count);
+    } else {
+        avx512CodeDistances<uint16_t>(columns, dimensions, query, weights, distances, first, count);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // AI_KERNELS_X86
+
+// Every table this CPU can run, widest first; scalar is always last
+std::vector<KernelTable> supportedKernels() {
+    std::vector<KernelTable> tables;
+#ifdef AI_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        tables.push_back({ "avx512", avx512SumOfSquares, avx512Dot, avx512MaxValue, avx512MinValue,
+                           avx512PositiveDifferenceSum, avx512ComplexMagnitude, avx512SpectralMoments,
+                           avx512WeightedSquaredDistances, avx512QuantizedSquaredDistances });
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        tables.push_back({ "avx2", avx2SumOfSquares, avx2Dot, avx2MaxValue, avx2MinValue,
+                           avx2PositiveDifferenceSum, avx2ComplexMagnitude, avx2SpectralMoments,
+                           avx2WeightedSquaredDistances, avx2QuantizedSquaredDistances });
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        tables.push_back({ "sse", sseSumOfSquares, sseDot, sseMaxValue, sseMinValue,
+                           ssePositiveDifferenceSum, sseComplexMagnitude, sseSpectralMoments,
+                           sseWeightedSquaredDistances, sseQuantizedSquaredDistances });
+    }
+#endif
+    tables.push_back({ "scalar", scalarSumOfSquares, scalarDot, scalarMaxValue, scalarMinValue,
+                       scalarPositiveDifferenceSum, scalarComplexMagnitude, scalarSpectralMoments,
+                       scalarWeightedSquaredDistances, scalarQuantizedSquaredDistances });
+    return tables;
+}
+
+const std::vector<KernelTable>& availableKernels() {
+    static const std::vector<KernelTable> tables = supportedKernels();
+    return tables;
+}
+
+std::atomic<const KernelTable*>& activeKernels() {
+    static std::atomic<const KernelTable*> table(&availableKernels().front());
+    return table;
+}
+
+const KernelTable& kernels() {
+    return *activeKernels().load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+float VectorKernels::sumOfSquares(const float* data, size_t count) {
+    return kernels().sumOfSquares(data, count);
+}
+
+float VectorKernels::dot(const float* a, const float* b, size_t count) {
+    return kernels().dot(a, b, count);
+}
+
+float VectorKernels::maxValue(const float* data, size_t count) {
+    return kernels().maxValue(data, count);
+}
+
+float VectorKernels::minValue(const float* data, size_t count) {
+    return kernels().minValue(data, count);
+}
+
+float VectorKernels::positiveDifferenceSum(const float* a, const float* b, size_t count) {
+    return kernels().positiveDifferenceSum(a, b, count);
+}
+
+void VectorKernels::complexMagnitude(const std::complex<float>* input, float* output, size_t count) {
+    // std::complex<float> is laid out as float[2] {re, im}
+    kernels().complexMagnitude(reinterpret_cast<const float*>(input), output, count);
+}
+
+SpectralMoments VectorKernels::spectralMoments(const float* magnitude, size_t count) {
+    SpectralMoments sums;
+    kernels().spectralMoments(magnitude, count, 0, sums);
+    return sums;
+}
+
+void VectorKernels::weightedSquaredDistances(const float* const* columns, int dimensions, const float* query,
+                                             const float* weights, float* distances, size_t count) {
+    kernels().weightedSquaredDistances(columns, dimensions, query, weights, distances, 0, count);
+}
+
+void VectorKernels::quantizedSquaredDistances(const void* const* columns, int codeBytes, int dimensions,
+                                              const float* query, const float* weights, float* distances,
+                                              size_t count) {
+    kernels().quantizedSquaredDistances(columns, codeBytes, dimensions, query, weights, distances, 0, count);
+}
+
+const char* VectorKernels::instructionSet() {
+    return kernels().name;
+}
+
+std::vector<std::string> VectorKernels::supportedInstructionSets() {
+    std::vector<std::string> names;
+    for (const KernelTable& table : availableKernels()) names.push_back(table.name);
+    return names;
+}
+
+bool VectorKernels::useInstructionSet(const std::string& name) {
+    for (const KernelTable& table : availableKernels()) {
+        if (name == table.name) {
+            activeKernels().store(&table, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace MusicAnalysis
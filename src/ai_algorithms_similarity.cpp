@@ -0,0 +1,338 @@
+// HAMMS similarity - batched scoring and k-nearest-neighbour search over a library
+
+#include "ai_algorithms.h"
+#include <numeric>
+
+namespace MusicAnalysis {
+
+namespace {
+
+const float UNIT_WEIGHTS[HAMMSBatch::DIMENSIONS] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+// Rows scored per kernel call; the distances stay in L1
+constexpr size_t SCORE_BLOCK = 256;
+
+// Squared distance at which calculateSimilarity() reaches the given similarity
+float distanceForSimilarity(float similarity, float weightSum = HAMMSBatch::DIMENSIONS) {
+    if (similarity <= 0.0f) return std::numeric_limits<float>::infinity();
+    float gap = 1.0f - similarity;
+    return weightSum * gap * gap;
+}
+
+float similarityForDistance(float distance, float weightSum = HAMMSBatch::DIMENSIONS) {
+    return 1.0f - std::sqrt(distance / weightSum);
+}
+
+bool inRange(float value, float lower, float upper) {
+    if (std::isnan(value)) return std::isinf(lower) && std::isinf(upper);
+    return value >= lower && value <= upper;
+}
+
+} // namespace
+
+// ========================================
+// 🎯 BATCHED HAMMS SCORING
+// ========================================
+
+void HAMMSBatch::toArray(const HAMMSVector& vector, float* values) {
+    values[0] = vector.harmonicity;
+    values[1] = vector.melodicity;
+    values[2] = vector.rhythmicity;
+    values[3] = vector.timbrality;
+    values[4] = vector.dynamics;
+    values[5] = vector.tonality;
+    values[6] = vector.temporality;
+}
+
+void HAMMSBatch::reserve(size_t count) {
+    for (auto& column : columns) column.reserve(count);
+}
+
+void HAMMSBatch::add(const HAMMSVector& vector) {
+    float values[DIMENSIONS];
+    toArray(vector, values);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        columns[d].push_back(values[d]);
+    }
+}
+
+void HAMMSBatch::clear() {
+    for (auto& column : columns) column.clear();
+}
+
+HAMMSVector HAMMSBatch::at(size_t index) const {
+    HAMMSVector vector;
+    vector.harmonicity = columns[0][index];
+    vector.melodicity = columns[1][index];
+    vector.rhythmicity = columns[2][index];
+    vector.timbrality = columns[3][index];
+    vector.dynamics = columns[4][index];
+    vector.tonality = columns[5][index];
+    vector.temporality = columns[6][index];
+    return vector;
+}
+
+void HAMMSBatch::similarities(const HAMMSVector& query, float* similarities, const float* weights) const {
+    if (!weights) weights = UNIT_WEIGHTS;
+    float values[DIMENSIONS];
+    toArray(query, values);
+    const float* rows[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++) rows[d] = columns[d].data();
+
+    const float weightSum = std::accumulate(weights, weights + DIMENSIONS, 0.0f);
+    VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, values, weights, similarities, size());
+    for (size_t i = 0; i < size(); i++) {
+        similarities[i] = similarityForDistance(similarities[i], weightSum);
+    }
+}
+
+std::vector<BatchMatch> HAMMSBatch::mostSimilar(const HAMMSVector& query, size_t k, const float* weights) const {
+    if (!weights) weights = UNIT_WEIGHTS;
+    float values[DIMENSIONS];
+    toArray(query, values);
+
+    NearestSelection nearest(k);
+    float distances[SCORE_BLOCK];
+    const float* rows[DIMENSIONS];
+    for (size_t first = 0; first < size(); first += SCORE_BLOCK) {
+        const size_t count = std::min(SCORE_BLOCK, size() - first);
+        for (int d = 0; d < DIMENSIONS; d++) rows[d] = columns[d].data() + first;
+        VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, values, weights, distances, count);
+        for (size_t i = 0; i < count; i++) {
+            nearest.offer(distances[i], first + i);
+        }
+    }
+
+    const float weightSum = std::accumulate(weights, weights + DIMENSIONS, 0.0f);
+    std::vector<BatchMatch> matches;
+    for (const auto& candidate : nearest.take()) {
+        matches.push_back({candidate.second, similarityForDistance(candidate.first, weightSum)});
+    }
+    return matches;
+}
+
+// ========================================
+// 🔎 SIMILARITY INDEX
+// ========================================
+
+bool SimilarityFilters::accepts(float bpm, float energy) const {
+    return inRange(bpm, minBPM, maxBPM) && inRange(energy, minEnergy, maxEnergy);
+}
+
+// One query and the best rows it has seen
+class HAMMSIndex::Search {
+public:
+    Search(const HAMMSIndex& index, const float* query, size_t k, const SimilarityFilters& filters, int64_t exclude)
+        : index(index), query(query), filters(filters), exclude(exclude),
+          nearest(k, distanceForSimilarity(filters.minSimilarity)) {}
+
+    void scan(size_t begin, size_t end) {
+        float distances[SCORE_BLOCK];
+        const float* rows[DIMENSIONS];
+        for (size_t first = begin; first < end; first += SCORE_BLOCK) {
+            const size_t count = std::min(SCORE_BLOCK, end - first);
+            for (int d = 0; d < DIMENSIONS; d++) rows[d] = index.columns[d].data() + first;
+            VectorKernels::weightedSquaredDistances(rows, DIMENSIONS, query, UNIT_WEIGHTS, distances, count);
+
+            for (size_t i = 0; i < count; i++) {
+                consider(first + i, distances[i]);
+            }
+        }
+    }
+
+    // Nearer child first; a box farther than the current k-th result is skipped whole
+    void visit(int32_t id, float distance) {
+        if (distance > nearest.bound()) return;
+
+        const Node& node = index.nodes[id];
+        if (node.left < 0) {
+            scan(node.begin, node.end);
+            return;
+        }
+
+        float left = boxDistance(index.nodes[node.left]);
+        float right = boxDistance(index.nodes[node.right]);
+        if (left <= right) {
+            visit(node.left, left);
+            visit(node.right, right);
+        } else {
+            visit(node.right, right);
+            visit(node.left, left);
+        }
+    }
+
+    float boxDistance(const Node& node) const {
+        float distance = 0.0f;
+        for (int d = 0; d < DIMENSIONS; d++) {
+            float outside = std::max(std::max(node.lower[d] - query[d], query[d] - node.upper[d]), 0.0f);
+            distance += outside * outside;
+        }
+        return distance;
+    }
+
+    std::vector<SimilarTrack> results() {
+        std::vector<SimilarTrack> tracks;
+        for (const auto& candidate : nearest.take()) {
+            tracks.push_back({index.trackIds[candidate.second], similarityForDistance(candidate.first)});
+        }
+        return tracks;
+    }
+
+private:
+    void consider(size_t row, float distance) {
+        if (distance > nearest.bound()) return;
+        if (!index.live[row] || index.trackIds[row] == exclude) return;
+        if (!filters.accepts(index.bpms[row], index.energies[row])) return;
+        nearest.offer(distance, row);
+    }
+
+    const HAMMSIndex& index;
+    const float* query;
+    const SimilarityFilters& filters;
+    const int64_t exclude;
+    NearestSelection nearest;
+};
+
+void HAMMSIndex::upsert(int64_t trackId, const HAMMSVector& vector, float bpm, float energy) {
+    // A replaced row may sit inside a tree box, so it is retired rather than edited
+    auto existing = rows.find(trackId);
+    if (existing != rows.end()) {
+        live[existing->second] = 0;
+    }
+
+    float values[DIMENSIONS];
+    HAMMSBatch::toArray(vector, values);
+    append(trackId, values, bpm, energy);
+    rows[trackId] = (uint32_t)(trackIds.size() - 1);
+
+    const size_t dead = trackIds.size() - rows.size();
+    const size_t unindexed = trackIds.size() - treeRows;
+    if (rows.size() >= TREE_MIN_ROWS ? unindexed > treeRows / 4 || dead > rows.size() / 4
+                                     : dead > rows.size()) {
+        rebuild();
+    }
+}
+
+bool HAMMSIndex::remove(int64_t trackId) {
+    auto existing = rows.find(trackId);
+    if (existing == rows.end()) return false;
+
+    live[existing->second] = 0;
+    rows.erase(existing);
+
+    if (trackIds.size() - rows.size() > std::max(rows.size() / 4, TREE_MIN_ROWS)) {
+        rebuild();
+    }
+    return true;
+}
+
+std::vector<SimilarTrack> HAMMSIndex::findSimilar(int64_t trackId, size_t k, const SimilarityFilters& filters) const {
+    auto existing = rows.find(trackId);
+    if (existing == rows.end()) return {};
+
+    float query[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++) {
+        query[d] = columns[d][existing->second];
+    }
+    return search(query, k, filters, trackId);
+}
+
+std::vector<SimilarTrack> HAMMSIndex::findSimilar(const HAMMSVector& query, size_t k,
+                                                  const SimilarityFilters& filters) const {
+    float values[DIMENSIONS];
+    HAMMSBatch::toArray(query, values);
+    return search(values, k, filters, std::numeric_limits<int64_t>::min());
+}
+
+std::vector<SimilarTrack> HAMMSIndex::search(const float* query, size_t k, const SimilarityFilters& filters,
+                                             int64_t exclude) const {
+    if (k == 0) return {};
+
+    Search search(*this, query, k, filters, exclude);
+    if (!nodes.empty()) {
+        search.visit(0, search.boxDistance(nodes[0]));
+    }
+    search.scan(treeRows, trackIds.size());
+    return search.results();
+}
+
+void HAMMSIndex::append(int64_t trackId, const float* values, float bpm, float energy) {
+    for (int d = 0; d < DIMENSIONS; d++) {
+        columns[d].push_back(values[d]);
+    }
+    bpms.push_back(bpm);
+    energies.push_back(energy);
+    trackIds.push_back(trackId);
+    live.push_back(1);
+}
+
+// Drops retired rows and, for a large enough library, rebuilds the tree over every row
+void HAMMSIndex::rebuild() {
+    std::vector<uint32_t> order;
+    order.reserve(rows.size());
+    for (uint32_t row = 0; row < trackIds.size(); row++) {
+        if (live[row]) order.push_back(row);
+    }
+
+    nodes.clear();
+    if (order.size() >= TREE_MIN_ROWS) {
+        nodes.reserve(4 * order.size() / LEAF_SIZE + 1);
+        buildNode(order, 0, (uint32_t)order.size());
+    }
+
+    // Rows move into tree order so every node covers a contiguous range
+    auto gather = [&order](auto& column) {
+        typename std::remove_reference<decltype(column)>::type reordered;
+        reordered.reserve(order.size());
+        for (uint32_t row : order) reordered.push_back(column[row]);
+        column.swap(reordered);
+    };
+    for (auto& column : columns) gather(column);
+    gather(bpms);
+    gather(energies);
+    gather(trackIds);
+    live.assign(order.size(), 1);
+
+    rows.clear();
+    for (uint32_t row = 0; row < trackIds.size(); row++) {
+        rows[trackIds[row]] = row;
+    }
+    treeRows = nodes.empty() ? 0 : trackIds.size();
+}
+
+int32_t HAMMSIndex::buildNode(std::vector<uint32_t>& order, uint32_t begin, uint32_t end) {
+    Node node;
+    node.begin = begin;
+    node.end = end;
+    for (int d = 0; d < DIMENSIONS; d++) {
+        node.lower[d] = std::numeric_limits<float>::infinity();
+        node.upper[d] = -std::numeric_limits<float>::infinity();
+        for (uint32_t i = begin; i < end; i++) {
+            float value = columns[d][order[i]];
+            node.lower[d] = std::min(node.lower[d], value);
+            node.upper[d] = std::max(node.upper[d], value);
+        }
+    }
+
+    const int32_t id = (int32_t)nodes.size();
+    nodes.push_back(node);
+    if (end - begin <= LEAF_SIZE) return id;
+
+    // Median split on the widest dimension
+    int axis = 0;
+    for (int d = 1; d < DIMENSIONS; d++) {
+        if (node.upper[d] - node.lower[d] > node.upper[axis] - node.lower[axis]) axis = d;
+    }
+    const AlignedFloats& column = columns[axis];
+    const uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                     [&column](uint32_t a, uint32_t b) { return column[a] < column[b]; });
+
+    int32_t left = buildNode(order, begin, middle);
+    int32_t right = buildNode(order, middle, end);
+    nodes[id].left = left;
+    nodes[id].right = right;
+    return id;
+}
+
+} // namespace MusicAnalysis
@@ -0,0 +1,267 @@
+// Compact HAMMS storage - quantized records and the memory-mapped index file
+
+#include "ai_algorithms.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🗜️ COMPACT HAMMS STORAGE
+// ========================================
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = { 'H', 'A', 'M', 'M', 'S', 'Q', 'I', 'X' };
+constexpr uint32_t FILE_VERSION = 1;
+constexpr size_t FILE_ALIGNMENT = 64;
+constexpr size_t SCORE_BLOCK = 256;
+
+const float UNIT_WEIGHTS[QuantizedHAMMSStore::DIMENSIONS] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+// The file is this header, then the id column, then one column per dimension, each
+// column starting on a FILE_ALIGNMENT boundary. Values are little-endian, as on
+// every host the kernels are built for.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t codeBytes;
+    uint64_t count;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(FileHeader) == FILE_ALIGNMENT, "The header fills the first aligned block");
+
+size_t padded(size_t bytes) {
+    return (bytes + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT;
+}
+
+size_t columnOffset(size_t count, int codeBytes, int dimension) {
+    return sizeof(FileHeader) + padded(count * sizeof(uint32_t)) + dimension * padded(count * codeBytes);
+}
+
+void writePadded(std::ofstream& file, const void* data, size_t bytes) {
+    static const char zeros[FILE_ALIGNMENT] = {};
+    file.write(static_cast<const char*>(data), bytes);
+    file.write(zeros, padded(bytes) - bytes);
+}
+
+} // namespace
+
+// The file's bytes: mapped read-only, or read into memory where mmap is unavailable
+struct QuantizedHAMMSStore::Mapping {
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#else
+    ~Mapping() {
+        if (data) munmap(const_cast<uint8_t*>(data), length);
+    }
+#endif
+};
+
+QuantizedHAMMSStore::QuantizedHAMMSStore(int bits) : codeBytes(bits / 8) {
+    if (bits != 8 && bits != 16) {
+        throw std::invalid_argument("QuantizedHAMMSStore: bits must be 8 or 16");
+    }
+}
+
+uint32_t QuantizedHAMMSStore::quantize(float value) const {
+    if (!(value > 0.0f)) return 0;   // Also NaN
+    if (value >= 1.0f) return maxCode();
+    return (uint32_t)std::lround(value * maxCode());
+}
+
+const uint32_t* QuantizedHAMMSStore::ids() const {
+    if (!mapping) return ownedIds.data();
+    return reinterpret_cast<const uint32_t*>(mapping->data + sizeof(FileHeader));
+}
+
+const void* QuantizedHAMMSStore::column(int dimension) const {
+    if (!mapping) return ownedColumns[dimension].data();
+    return mapping->data + columnOffset(count, codeBytes, dimension);
+}
+
+void QuantizedHAMMSStore::add(uint32_t trackId, const HAMMSVector& vector) {
+    if (mapping) {
+        throw std::logic_error("QuantizedHAMMSStore: an opened index file is read-only");
+    }
+
+    uint8_t record[DIMENSIONS * 2];
+    encode(vector, record);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        const uint8_t* code = record + d * codeBytes;
+        ownedColumns[d].insert(ownedColumns[d].end(), code, code + codeBytes);
+    }
+    ownedIds.push_back(trackId);
+    count++;
+}
+
+HAMMSVector QuantizedHAMMSStore::at(size_t index) const {
+    uint8_t record[DIMENSIONS * 2];
+    for (int d = 0; d < DIMENSIONS; d++) {
+        std::memcpy(record + d * codeBytes, static_cast<const uint8_t*>(column(d)) + index * codeBytes, codeBytes);
+    }
+    return decode(record);
+}
+
+void QuantizedHAMMSStore::encode(const HAMMSVector& vector, uint8_t* record) const {
+    float values[DIMENSIONS];
+    HAMMSBatch::toArray(vector, values);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        uint32_t code = quantize(values[d]);
+        record[d * codeBytes] = (uint8_t)(code & 0xFF);
+        if (codeBytes == 2) record[d * codeBytes + 1] = (uint8_t)(code >> 8);
+    }
+}
+
+HAMMSVector QuantizedHAMMSStore::decode(const uint8_t* record) const {
+    float values[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++) {
+        uint32_t code = record[d * codeBytes];
+        if (codeBytes == 2) code |= (uint32_t)record[d * codeBytes + 1] << 8;
+        values[d] = (float)code / maxCode();
+    }
+
+    HAMMSVector vector;
+    vector.harmonicity = values[0];
+    vector.melodicity = values[1];
+    vector.rhythmicity = values[2];
+    vector.timbrality = values[3];
+    vector.dynamics = values[4];
+    vector.tonality = values[5];
+    vector.temporality = values[6];
+    return vector;
+}
+
+std::vector<SimilarTrack> QuantizedHAMMSStore::mostSimilar(const HAMMSVector& query, size_t k,
+                                                           const float* weights) const {
+    return search(query, k, weights, count);
+}
+
+std::vector<SimilarTrack> QuantizedHAMMSStore::findSimilar(uint32_t trackId, size_t k, const float* weights) const {
+    const uint32_t* first = ids();
+    const uint32_t* found = std::find(first, first + count, trackId);
+    if (found == first + count) return {};
+
+    size_t index = found - first;
+    return search(at(index), k, weights, index);
+}
+
+std::vector<SimilarTrack> QuantizedHAMMSStore::search(const HAMMSVector& query, size_t k, const float* weights,
+                                                      size_t exclude) const {
+    if (!weights) weights = UNIT_WEIGHTS;
+
+    // The query stays unquantized, in code units
+    float codes[DIMENSIONS];
+    HAMMSBatch::toArray(query, codes);
+    for (float& code : codes) code *= maxCode();
+
+    NearestSelection nearest(k);
+    float distances[SCORE_BLOCK];
+    const void* rows[DIMENSIONS];
+    for (size_t first = 0; first < count; first += SCORE_BLOCK) {
+        const size_t block = std::min(SCORE_BLOCK, count - first);
+        for (int d = 0; d < DIMENSIONS; d++) {
+            rows[d] = static_cast<const uint8_t*>(column(d)) + first * codeBytes;
+        }
+        VectorKernels::quantizedSquaredDistances(rows, codeBytes, DIMENSIONS, codes, weights, distances, block);
+        for (size_t i = 0; i < block; i++) {
+            if (first + i != exclude) nearest.offer(distances[i], first + i);
+        }
+    }
+
+    const float scale = (float)maxCode() * maxCode() * std::accumulate(weights, weights + DIMENSIONS, 0.0f);
+    std::vector<SimilarTrack> tracks;
+    for (const auto& candidate : nearest.take()) {
+        tracks.push_back({ids()[candidate.second], 1.0f - std::sqrt(candidate.first / scale)});
+    }
+    return tracks;
+}
+
+void QuantizedHAMMSStore::save(const std::string& path) const {
+    // Written beside the target and renamed over it, so a mapping of the old file stays valid
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("Could not create HAMMS index: " + temporary);
+
+        FileHeader header = {};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.codeBytes = codeBytes;
+        header.count = count;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        writePadded(file, ids(), count * sizeof(uint32_t));
+        for (int d = 0; d < DIMENSIONS; d++) {
+            writePadded(file, column(d), count * codeBytes);
+        }
+        if (!file) throw std::runtime_error("Could not write HAMMS index: " + temporary);
+    }
+
+#ifdef _WIN32
+    // rename() does not replace an existing file here; opened indexes hold a copy, not the file
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Could not replace HAMMS index: " + path);
+    }
+}
+
+QuantizedHAMMSStore QuantizedHAMMSStore::open(const std::string& path) {
+    auto mapping = std::make_shared<Mapping>();
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Could not open HAMMS index: " + path);
+    mapping->buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    mapping->data = mapping->buffer.data();
+    mapping->length = mapping->buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Could not open HAMMS index: " + path);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a HAMMS index: " + path);
+    }
+    void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // The mapping keeps the file
+    if (address == MAP_FAILED) throw std::runtime_error("Could not map HAMMS index: " + path);
+    mapping->data = static_cast<const uint8_t*>(address);
+    mapping->length = (size_t)info.st_size;
+#endif
+
+    FileHeader header;
+    if (mapping->length < sizeof(header)) throw std::runtime_error("Not a HAMMS index: " + path);
+    std::memcpy(&header, mapping->data, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+        (header.codeBytes != 1 && header.codeBytes != 2)) {
+        throw std::runtime_error("Not a HAMMS index: " + path);
+    }
+    // Bound count by the file first, so a corrupt header cannot overflow the offset
+    if (header.count > mapping->length / header.codeBytes ||
+        columnOffset(header.count, header.codeBytes, DIMENSIONS) > mapping->length) {
+        throw std::runtime_error("Truncated HAMMS index: " + path);
+    }
+
+    QuantizedHAMMSStore store(header.codeBytes * 8);
+    store.count = header.count;
+    store.mapping = std::move(mapping);
+    return store;
+}
+
+} // namespace MusicAnalysis
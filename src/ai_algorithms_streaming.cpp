@@ -0,0 +1,335 @@
+// Streaming analysis - bounded-memory accumulators fed chunk by chunk
+
+#include "ai_algorithms.h"
+#include <iostream>
+
+namespace MusicAnalysis {
+
+// ========================================
+// 🌊 STREAMING ANALYSIS
+// ========================================
+
+namespace {
+
+// Spectral flux over FRAME_SIZE / HOP_SIZE frames fed to the tempogram estimator.
+// Holds one frame of samples, one magnitude frame and one tempogram window.
+class TempoAccumulator {
+public:
+    explicit TempoAccumulator(int sampleRate) : estimator(sampleRate) {}
+
+    void process(const float* samples, size_t count) {
+        const int frameSize = AnalysisContext::FRAME_SIZE;
+        const int hopSize = AnalysisContext::HOP_SIZE;
+
+        pending.insert(pending.end(), samples, samples + count);
+        if ((int)pending.size() < frameSize) return;
+
+        STFTFrames frames = AudioProcessor::calculateSTFT(pending, frameSize, hopSize);
+        std::vector<float> flux;
+        flux.reserve(frames.numFrames);
+        for (int f = 0; f < frames.numFrames; f++) {
+            const float* magnitude = frames.frame(f);
+            if (!previous.empty()) {
+                // Same kernel as BPMDetector::calculateSpectralFlux, so the tempo matches offline
+                flux.push_back(VectorKernels::positiveDifferenceSum(magnitude, previous.data(), frames.numBins));
+            }
+            previous.assign(magnitude, magnitude + frames.numBins);
+        }
+        estimator.add(flux.data(), flux.size());
+
+        pending.erase(pending.begin(), pending.begin() + static_cast<size_t>(frames.numFrames) * hopSize);
+    }
+
+    float bpm() { return estimator.bpm(); }
+
+private:
+    BeatTracker::TempoEstimator estimator;
+    std::vector<float> pending;
+    std::vector<float> previous;
+};
+
+// Whole-track magnitude spectrum at a fixed resolution: power summed over
+// SPECTRUM_SIZE frames, so noise keeps the scale of one full-length FFT
+class SpectrumAccumulator {
+public:
+    explicit SpectrumAccumulator(int sampleRate)
+        : sampleRate(sampleRate),
+          power(StreamingAnalyzer::SPECTRUM_SIZE / 2 + 1, 0.0) {
+        frame.reserve(StreamingAnalyzer::SPECTRUM_SIZE);
+    }
+
+    void process(const float* samples, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (haveLast && (samples[i] >= 0) != (lastSample >= 0)) {
+                zeroCrossings++;
+            }
+            lastSample = samples[i];
+            haveLast = true;
+        }
+        total += count;
+
+        while (count > 0) {
+            size_t take = std::min(count, (size_t)StreamingAnalyzer::SPECTRUM_SIZE - frame.size());
+            frame.insert(frame.end(), samples, samples + take);
+            samples += take;
+            count -= take;
+
+            if ((int)frame.size() == StreamingAnalyzer::SPECTRUM_SIZE) {
+                addFrame();
+            }
+        }
+    }
+
+    SpectralFeatures finish() {
+        // Zero-pad the tail so it still contributes
+        if (!frame.empty()) {
+            frame.resize(StreamingAnalyzer::SPECTRUM_SIZE, 0.0f);
+            addFrame();
+        }
+
+        SpectralFeatures features;
+        features.sampleRate = sampleRate;
+        features.magnitude.resize(power.size());
+        for (size_t i = 0; i < power.size(); i++) {
+            features.magnitude[i] = (float)std::sqrt(power[i]);
+        }
+
+        AudioProcessor::calculateSpectralShape(features);
+        features.zeroCrossingRate = total > 0 ? (float)zeroCrossings / total : 0.0f;
+        return features;
+    }
+
+private:
+    void addFrame() {
+        const int size = StreamingAnalyzer::SPECTRUM_SIZE;
+        STFTFrames stft = AudioProcessor::calculateSTFT(frame, size, size);
+        const float* magnitude = stft.frame(0);
+        for (int k = 0; k < stft.numBins; k++) {
+            power[k] += (double)magnitude[k] * magnitude[k];
+        }
+        frame.clear();
+    }
+
+    int sampleRate;
+    std::vector<float> frame;
+    std::vector<double> power;
+
+    size_t total = 0;
+    size_t zeroCrossings = 0;
+    float lastSample = 0.0f;
+    bool haveLast = false;
+};
+
+// Whole-track chromagram on the same frame grid as AnalysisContext::chromagram()
+class ChromagramAccumulator {
+public:
+    explicit ChromagramAccumulator(int sampleRate)
+        : sampleRate(sampleRate) {
+        chromagram.frameSize = AnalysisContext::CHROMA_FRAME_SIZE;
+        chromagram.hopSize = AnalysisContext::CHROMA_HOP_SIZE;
+        chromagram.sampleRate = sampleRate;
+    }
+
+    void process(const float* samples, size_t count) {
+        pending.insert(pending.end(), samples, samples + count);
+
+        // Transform in batches of frames rather than one frame per hop
+        if (pending.size() >= (size_t)chromagram.frameSize + BATCH_HOPS * (size_t)chromagram.hopSize) {
+            flush();
+        }
+    }
+
+    Chromagram finish() {
+        flush();
+        return std::move(chromagram);
+    }
+
+private:
+    static constexpr size_t BATCH_HOPS = 64;
+
+    void flush() {
+        Chromagram block = AudioProcessor::calculateChromagram(pending, sampleRate,
+                                                               chromagram.frameSize, chromagram.hopSize);
+        if (block.numFrames == 0) return;
+
+        chromagram.values.insert(chromagram.values.end(), block.values.begin(), block.values.end());
+        chromagram.numFrames += block.numFrames;
+
+        // Keep the overlap the next frame still needs
+        pending.erase(pending.begin(), pending.begin() + (size_t)block.numFrames * chromagram.hopSize);
+    }
+
+    int sampleRate;
+    std::vector<float> pending;
+    Chromagram chromagram;
+};
+
+} // namespace
+
+struct StreamingAnalyzer::State {
+    int sampleRate;
+    StreamingOptions options;
+    FieldMask fields;          // Resolved with dependencies
+    size_t totalSamples = 0;
+
+    // Excerpt: segment k covers samples [k * segmentLength, (k + 1) * segmentLength)
+    // and is kept while k is a multiple of stride. Until the first decimation the
+    // segments are the whole track.
+    struct Segment {
+        size_t index;
+        std::vector<float> samples;
+    };
+    size_t segmentLength;
+    size_t stride = 1;
+    std::vector<Segment> segments;
+
+    // Whole-track accumulators, started when the track outgrows the excerpt
+    bool accumulating = false;
+    std::unique_ptr<LoudnessMeter> loudness;
+    std::unique_ptr<TempoAccumulator> tempo;
+    std::unique_ptr<SpectrumAccumulator> spectrum;
+    std::unique_ptr<ChromagramAccumulator> chromagram;
+
+    void accumulate(const float* samples, size_t count) {
+        if (loudness) loudness->process(samples, count);
+        if (tempo) tempo->process(samples, count);
+        if (spectrum) spectrum->process(samples, count);
+        if (chromagram) chromagram->process(samples, count);
+    }
+
+    void startAccumulating() {
+        if (fields & FIELD_LOUDNESS) loudness = std::make_unique<LoudnessMeter>(sampleRate);
+        if (fields & FIELD_BPM) tempo = std::make_unique<TempoAccumulator>(sampleRate);
+        spectrum = std::make_unique<SpectrumAccumulator>(sampleRate);
+        if (FieldSelection::requiredFeatures(fields) & FEATURE_CHROMAGRAM) {
+            chromagram = std::make_unique<ChromagramAccumulator>(sampleRate);
+        }
+
+        // Everything so far is still held, in order
+        for (const auto& segment : segments) {
+            accumulate(segment.samples.data(), segment.samples.size());
+        }
+        accumulating = true;
+    }
+
+    void decimate() {
+        // Drop every other kept segment so the excerpt keeps spanning the track
+        stride *= 2;
+        segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                      [this](const Segment& s) { return s.index % stride != 0; }),
+                       segments.end());
+    }
+
+    // Concatenates the kept segments, releasing each one as it is copied
+    std::vector<float> takeExcerpt() {
+        size_t length = 0;
+        for (const auto& segment : segments) length += segment.samples.size();
+
+        std::vector<float> excerpt;
+        excerpt.reserve(length);
+        for (auto& segment : segments) {
+            excerpt.insert(excerpt.end(), segment.samples.begin(), segment.samples.end());
+            std::vector<float>().swap(segment.samples);
+        }
+        segments.clear();
+        return excerpt;
+    }
+};
+
+StreamingAnalyzer::StreamingAnalyzer(int sampleRate, const StreamingOptions& options)
+    : state(std::make_unique<State>()) {
+    state->sampleRate = sampleRate;
+    state->options = options;
+    state->fields = FieldSelection::withDependencies(options.fields);
+
+    size_t excerptSamples = static_cast<size_t>(std::max(1.0f, options.excerptSeconds * sampleRate));
+    state->segmentLength = std::max<size_t>(1, excerptSamples / EXCERPT_SEGMENTS);
+}
+
+StreamingAnalyzer::~StreamingAnalyzer() = default;
+
+size_t StreamingAnalyzer::samplesPushed() const {
+    return state->totalSamples;
+}
+
+void StreamingAnalyzer::push(const float* samples, size_t count) {
+    State& s = *state;
+
+    while (count > 0) {
+        // Split the chunk at segment boundaries
+        size_t index = s.totalSamples / s.segmentLength;
+        size_t offset = s.totalSamples % s.segmentLength;
+        size_t take = std::min(count, s.segmentLength - offset);
+
+        if (s.accumulating) s.accumulate(samples, take);
+
+        if (index % s.stride == 0) {
+            if (offset == 0) {
+                s.segments.push_back({index, {}});
+                s.segments.back().samples.reserve(s.segmentLength);
+            }
+            auto& segment = s.segments.back().samples;
+            segment.insert(segment.end(), samples, samples + take);
+
+            if ((int)s.segments.size() > EXCERPT_SEGMENTS) {
+                if (!s.accumulating) s.startAccumulating();
+                s.decimate();
+            }
+        }
+
+        s.totalSamples += take;
+        samples += take;
+        count -= take;
+    }
+}
+
+AIAnalysisResult StreamingAnalyzer::finish() {
+    State& s = *state;
+
+    std::unique_ptr<AIMetadataAnalyzer> analyzer = s.options.pool
+        ? std::make_unique<AIMetadataAnalyzer>(*s.options.pool)
+        : std::make_unique<AIMetadataAnalyzer>();
+    analyzer->setVerbose(s.options.verbose);
+
+    AudioBuffer excerpt(s.takeExcerpt(), s.sampleRate, 1);
+
+    // The whole track was held: identical to offline analysis
+    if (!s.accumulating) {
+        return analyzer->analyzeAudio(excerpt, s.options.fields);
+    }
+
+    if (s.options.verbose) {
+        std::cout << "🌊 Streaming analysis: " << s.totalSamples / s.sampleRate << "s track, "
+                  << excerpt.length / s.sampleRate << "s excerpt" << std::endl;
+    }
+
+    AIAnalysisResult known;
+    if (s.loudness) {
+        known.AI_LOUDNESS = s.loudness->integratedLoudness();
+        known.LOUDNESS_RANGE = s.loudness->loudnessRange();
+        known.TRUE_PEAK = s.loudness->truePeak();
+        known.LOUDNESS_TIMELINE = s.loudness->timeline();
+        known.analyzedFields |= FIELD_LOUDNESS;
+    }
+    if (s.tempo) {
+        known.AI_BPM = s.tempo->bpm();
+        known.analyzedFields |= FIELD_BPM;
+    }
+
+    AnalysisContext context(excerpt, s.spectrum->finish(),
+                            s.chromagram ? s.chromagram->finish() : Chromagram(),
+                            FieldSelection::requiredFeatures(s.fields));
+    return analyzer->analyzeContext(context, s.options.fields, known);
+}
+
+AIAnalysisResult StreamingAnalyzer::analyzeFile(const std::string& filePath, const StreamingOptions& options) {
+    std::unique_ptr<StreamingAnalyzer> analyzer;
+
+    AudioDecoder::decodeStream(filePath,
+        [&](const float* samples, size_t count) { analyzer->push(samples, count); },
+        [&](const AudioStreamInfo& info) { analyzer = std::make_unique<StreamingAnalyzer>(info.sampleRate, options); });
+
+    return analyzer->finish();
+}
+
+} // namespace MusicAnalysis
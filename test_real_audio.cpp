@@ -8,7 +8,6 @@
 #include <vector>
 #include <filesystem>
 #include <fstream>
-#include <sndfile.h>
 #include <chrono>
 
 using namespace MusicAnalysis;
@@ -20,34 +19,9 @@ namespace fs = std::filesystem;
 
 class AudioFileLoader {
 public:
+    // Chunked decode with in-place downmix (see AudioDecoder)
     static AudioBuffer loadAudioFile(const std::string& filepath) {
-        SF_INFO sfinfo;
-        SNDFILE* file = sf_open(filepath.c_str(), SFM_READ, &sfinfo);
-        
-        if (!file) {
-            throw std::runtime_error("Could not open audio file: " + filepath);
-        }
-        
-        // Read audio data
-        std::vector<float> samples(sfinfo.frames * sfinfo.channels);
-        sf_count_t samplesRead = sf_readf_float(file, samples.data(), sfinfo.frames);
-        
-        sf_close(file);
-        
-        if (samplesRead != sfinfo.frames) {
-            throw std::runtime_error("Could not read all samples from: " + filepath);
-        }
-        
-        // Convert to mono if stereo
-        if (sfinfo.channels == 2) {
-            std::vector<float> mono(sfinfo.frames);
-            for (sf_count_t i = 0; i < sfinfo.frames; i++) {
-                mono[i] = (samples[i * 2] + samples[i * 2 + 1]) / 2.0f;
-            }
-            return AudioBuffer(mono, sfinfo.samplerate, 1);
-        }
-        
-        return AudioBuffer(samples, sfinfo.samplerate, 1);
+        return AudioDecoder::decodeFile(filepath);
     }
     
     static std::vector<std::string> findAudioFiles(const std::string& directory) {
@@ -156,7 +130,7 @@ private:
             
             // Truncate to 30 seconds max for faster testing
             if (audio.samples.size() > 30 * audio.sampleRate) {
-                audio.samples.resize(30 * audio.sampleRate);
+                audio.samples = audio.samples.subspan(0, 30 * audio.sampleRate);
                 audio.length = audio.samples.size();
                 std::cout << "🔪 Truncated to 30 seconds for faster analysis\n\n";
             }
@@ -11,6 +11,7 @@
 #include <random>
 #include <cstring>
 #include <filesystem>
+#include <set>
 
 using namespace MusicAnalysis;
 namespace fs = std::filesystem;
@@ -153,7 +154,7 @@ public:
     
     // Generate live recording simulation (with reverb)
     static AudioBuffer generateLiveRecording(const AudioBuffer& source) {
-        std::vector<float> processed = source.samples;
+        std::vector<float> processed(source.samples.begin(), source.samples.end());
         
         // Add simple reverb (delayed copies)
         float delays[] = {0.03f, 0.07f, 0.13f}; // 30ms, 70ms, 130ms
@@ -192,6 +193,14 @@ public:
         std::cout << "\n🎵 COMPREHENSIVE AI ALGORITHMS TEST SUITE\n";
         std::cout << "=========================================\n\n";
         
+        testVectorKernels();
+        testYinDifference();
+        testSimilarityIndex();
+        testHAMMSBatch();
+        testQuantizedStore();
+        testLibraryClustering();
+        testHarmonicMixing();
+        
         // Test individual algorithms
         testKeyDetection();
         testBPMDetection();
@@ -212,6 +221,8 @@ public:
         
         // Integration tests
         testFullAnalysisPipeline();
+        testSelectiveAnalysis();
+        testStreamingAnalysis();
         
         // Performance tests
         runPerformanceBenchmarks();
@@ -220,6 +231,434 @@ public:
         printTestResults();
     }
     
+    void testVectorKernels() {
+        std::cout << "🚀 Testing Vector Kernels (" << VectorKernels::instructionSet() << ")...\n";
+        
+        // Every dispatch level the CPU supports runs the same checks, widest last so it stays active
+        std::vector<std::string> instructionSets = VectorKernels::supportedInstructionSets();
+        for (auto level = instructionSets.rbegin(); level != instructionSets.rend(); ++level) {
+            VectorKernels::useInstructionSet(*level);
+            checkVectorKernels(" (" + *level + ")");
+        }
+    }
+    
+    void checkVectorKernels(const std::string& level) {
+        // Odd length so every kernel also runs its scalar tail
+        const size_t n = 1003;
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> a(n), b(n);
+        std::vector<std::complex<float>> z(n);
+        for (size_t i = 0; i < n; i++) {
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+            z[i] = std::complex<float>(a[i], b[i]);
+        }
+        
+        double squares = 0.0, products = 0.0, rectified = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            squares += a[i] * a[i];
+            products += a[i] * b[i];
+            rectified += std::max(a[i] - b[i], 0.0f);
+        }
+        
+        std::vector<float> magnitude(n);
+        VectorKernels::complexMagnitude(z.data(), magnitude.data(), n);
+        bool magnitudesMatch = true;
+        for (size_t i = 0; i < n; i++) {
+            magnitudesMatch &= std::abs(magnitude[i] - std::abs(z[i])) < 1e-5f;
+        }
+        
+        bool reductionsMatch =
+            std::abs(VectorKernels::sumOfSquares(a.data(), n) - squares) < 1e-3 &&
+            std::abs(VectorKernels::dot(a.data(), b.data(), n) - products) < 1e-3 &&
+            std::abs(VectorKernels::positiveDifferenceSum(a.data(), b.data(), n) - rectified) < 1e-3 &&
+            VectorKernels::maxValue(a.data(), n) == *std::max_element(a.begin(), a.end()) &&
+            VectorKernels::minValue(a.data(), n) == *std::min_element(a.begin(), a.end());
+        
+        reportTest("Vector Kernels - Match Scalar" + level, reductionsMatch && magnitudesMatch);
+        
+        // Fused spectral moments against a double-precision reference
+        double moments[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        for (size_t i = 0; i < n; i++) {
+            double m = std::abs(a[i]);
+            double logM = std::log(std::max(m, (double)VectorKernels::LOG_FLOOR));
+            moments[0] += m;
+            moments[1] += i * m;
+            moments[2] += (double)i * i * m;
+            moments[3] += m * m;
+            moments[4] += logM;
+            moments[5] += m * m * logM;
+        }
+        std::vector<float> positive(n);
+        for (size_t i = 0; i < n; i++) positive[i] = std::abs(a[i]);
+        SpectralMoments sums = VectorKernels::spectralMoments(positive.data(), n);
+        const float computed[6] = {sums.magnitude, sums.indexWeighted, sums.indexSquaredWeighted,
+                                   sums.power, sums.logMagnitude, sums.powerLogMagnitude};
+        bool momentsMatch = true;
+        for (int k = 0; k < 6; k++) {
+            momentsMatch &= std::abs(computed[k] - moments[k]) <= 1e-4 * std::abs(moments[k]) + 1e-3;
+        }
+        reportTest("Vector Kernels - Spectral Moments" + level, momentsMatch);
+        
+        // Weighted distances over 7 columns of n rows
+        const float* columns[7];
+        std::vector<float> query(7), weights(7);
+        for (int d = 0; d < 7; d++) {
+            columns[d] = d % 2 ? b.data() + d : a.data() + d;
+            query[d] = dist(rng);
+            weights[d] = 0.5f + 0.1f * d;
+        }
+        const size_t rowCount = n - 7;
+        std::vector<float> distances(rowCount);
+        VectorKernels::weightedSquaredDistances(columns, 7, query.data(), weights.data(), distances.data(), rowCount);
+        bool distancesMatch = true;
+        for (size_t i = 0; i < rowCount; i++) {
+            double expected = 0.0;
+            for (int d = 0; d < 7; d++) {
+                double delta = columns[d][i] - query[d];
+                expected += weights[d] * delta * delta;
+            }
+            distancesMatch &= std::abs(distances[i] - expected) < 1e-4;
+        }
+        reportTest("Vector Kernels - Weighted Distances" + level, distancesMatch);
+    }
+    
+    void testYinDifference() {
+        std::cout << "🎤 Testing YIN Difference...\n";
+        
+        // FFT difference and CMNDF against the direct O(W²) loop: tone, noise, short window
+        const int windowSize = 2205;   // 50 ms at 44.1 kHz, not a power of two
+        std::mt19937 rng(5);
+        std::normal_distribution<float> noise(0.0f, 0.3f);
+        std::vector<std::vector<float>> windows(3);
+        for (int j = 0; j < windowSize; j++) {
+            windows[0].push_back(0.5f * std::sin(2.0f * M_PI * 220.0f * j / 44100.0f));
+            windows[1].push_back(noise(rng));
+        }
+        windows[2].assign(windows[0].begin(), windows[0].begin() + 1500);
+        
+        YinDifference yin(windowSize);
+        float worstDiff = 0.0f, worstCMNDF = 0.0f;
+        for (const auto& window : windows) {
+            std::vector<float> fast = yin.compute(window);
+            
+            const int half = windowSize / 2;
+            std::vector<float> direct(half, 0.0f);
+            double energy = 0.0;
+            for (int j = 0; j < half; j++) {
+                float x = j < (int)window.size() ? window[j] : 0.0f;
+                energy += (double)x * x;
+            }
+            for (int tau = 1; tau < half; tau++) {
+                double sum = 0.0;
+                for (int j = 0; j < half; j++) {
+                    float a = j < (int)window.size() ? window[j] : 0.0f;
+                    float b = j + tau < (int)window.size() ? window[j + tau] : 0.0f;
+                    sum += (double)(a - b) * (a - b);
+                }
+                direct[tau] = (float)sum;
+            }
+            
+            std::vector<float> fastCMNDF, directCMNDF;
+            PitchTracker::calculateCMNDF(fast, fastCMNDF);
+            PitchTracker::calculateCMNDF(direct, directCMNDF);
+            for (int tau = 0; tau < half; tau++) {
+                worstDiff = std::max(worstDiff, (float)(std::abs(fast[tau] - direct[tau]) / energy));
+                worstCMNDF = std::max(worstCMNDF, std::abs(fastCMNDF[tau] - directCMNDF[tau]));
+            }
+        }
+        std::cout << "   Largest error: difference " << worstDiff << " (relative), CMNDF " << worstCMNDF << "\n";
+        reportTest("YIN Difference - Matches Direct Loop", worstDiff < 1e-5f && worstCMNDF < 1e-4f);
+    }
+    
+    void testSimilarityIndex() {
+        std::cout << "🔎 Testing Similarity Index...\n";
+        
+        // Past TREE_MIN_ROWS, with replaced and removed tracks, so tree and tail are both searched
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        HAMMSIndex index;
+        std::map<int64_t, std::pair<HAMMSVector, float>> library;   // trackId -> vector, BPM
+        for (int64_t id = 1; id <= 20000; id++) {
+            HAMMSVector vector;
+            vector.harmonicity = unit(rng);
+            vector.melodicity = unit(rng);
+            vector.rhythmicity = unit(rng);
+            vector.timbrality = unit(rng);
+            vector.dynamics = unit(rng);
+            vector.tonality = unit(rng);
+            vector.temporality = unit(rng);
+            float bpm = id % 20 == 0 ? NAN : 80.0f + 80.0f * unit(rng);
+            index.upsert(id, vector, bpm);
+            library[id] = {vector, bpm};
+        }
+        for (int64_t id = 1; id <= 20000; id += 7) {
+            index.remove(id);
+            library.erase(id);
+        }
+        for (int64_t id = 2; id <= 20000; id += 13) {
+            if (!library.count(id)) continue;
+            library[id].first.tonality = unit(rng);
+            index.upsert(id, library[id].first, library[id].second);
+        }
+        
+        SimilarityFilters filters;
+        filters.minBPM = 100.0f;
+        filters.maxBPM = 130.0f;
+        filters.minSimilarity = 0.7f;
+        
+        bool matchesScan = index.size() == library.size();
+        for (int64_t queryId = 3; queryId <= 20000; queryId += 997) {
+            if (!library.count(queryId)) continue;
+            const HAMMSVector& query = library[queryId].first;
+            for (const SimilarityFilters& applied : {SimilarityFilters(), filters}) {
+                std::vector<float> expected;
+                for (const auto& entry : library) {
+                    if (entry.first == queryId || !applied.accepts(entry.second.second, NAN)) continue;
+                    float similarity = query.calculateSimilarity(entry.second.first);
+                    if (similarity >= applied.minSimilarity) expected.push_back(similarity);
+                }
+                std::sort(expected.rbegin(), expected.rend());
+                expected.resize(std::min<size_t>(expected.size(), 10));
+                
+                std::vector<SimilarTrack> found = index.findSimilar(queryId, 10, applied);
+                matchesScan &= found.size() == expected.size();
+                for (size_t i = 0; i < found.size() && i < expected.size(); i++) {
+                    matchesScan &= std::abs(found[i].similarity - expected[i]) < 1e-4f &&
+                                   found[i].trackId != queryId && library.count(found[i].trackId);
+                }
+            }
+        }
+        reportTest("Similarity Index - Matches Exhaustive Scan", matchesScan);
+    }
+    
+    void testHAMMSBatch() {
+        std::cout << "🎯 Testing HAMMS Batch Scoring...\n";
+        
+        // Weighted top-k and unweighted scores against pairwise scoring
+        std::vector<HAMMSVector> vectors = randomHAMMSVectors(5000, 22);
+        HAMMSBatch batch;
+        for (const HAMMSVector& vector : vectors) batch.add(vector);
+        const float weights[7] = { 2.0f, 1.0f, 1.0f, 0.5f, 0.5f, 1.0f, 1.0f };
+        const HAMMSVector& query = vectors[42];
+        std::vector<float> expected;
+        for (const HAMMSVector& vector : vectors) {
+            const float* a = &query.harmonicity;
+            const float* b = &vector.harmonicity;
+            float distance = 0.0f;
+            for (int d = 0; d < 7; d++) distance += weights[d] * (a[d] - b[d]) * (a[d] - b[d]);
+            expected.push_back(1.0f - std::sqrt(distance / 7.0f));
+        }
+        std::sort(expected.rbegin(), expected.rend());
+        
+        std::vector<BatchMatch> top = batch.mostSimilar(query, 25, weights);
+        std::vector<float> unweighted(batch.size());
+        batch.similarities(query, unweighted.data());
+        bool batchMatches = top.size() == 25 && top[0].index == 42 &&
+                            std::abs(unweighted[7] - query.calculateSimilarity(vectors[7])) < 1e-5f;
+        for (size_t i = 0; i < top.size(); i++) {
+            batchMatches &= std::abs(top[i].similarity - expected[i]) < 1e-4f;
+        }
+        reportTest("HAMMS Batch - Weighted Top-K", batchMatches);
+    }
+    
+    // Uniform random HAMMS vectors, reproducible from the seed
+    static std::vector<HAMMSVector> randomHAMMSVectors(size_t count, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<HAMMSVector> vectors(count);
+        for (HAMMSVector& vector : vectors) {
+            vector.harmonicity = unit(rng);
+            vector.melodicity = unit(rng);
+            vector.rhythmicity = unit(rng);
+            vector.timbrality = unit(rng);
+            vector.dynamics = unit(rng);
+            vector.tonality = unit(rng);
+            vector.temporality = unit(rng);
+        }
+        return vectors;
+    }
+    
+    void testQuantizedStore() {
+        std::cout << "🗜️ Testing Quantized HAMMS Store...\n";
+        
+        // 8 and 16 bits: bounded rounding error, and the same answers once saved and mapped
+        std::vector<HAMMSVector> vectors = randomHAMMSVectors(20000, 23);
+        HAMMSBatch batch;
+        for (const HAMMSVector& vector : vectors) batch.add(vector);
+        std::vector<float> exact;   // Ten nearest to vectors[0], unquantized
+        for (const BatchMatch& match : batch.mostSimilar(vectors[0], 11)) {
+            if (match.index != 0) exact.push_back(match.similarity);
+        }
+        exact.resize(std::min<size_t>(exact.size(), 10));
+        
+        bool quantizedMatches = true;
+        for (int bits : {8, 16}) {
+            QuantizedHAMMSStore store(bits);
+            for (size_t i = 0; i < vectors.size(); i++) {
+                store.add((uint32_t)(1000 + i), vectors[i]);
+            }
+            const float tolerance = bits == 8 ? 0.01f : 1e-4f;
+            
+            std::vector<SimilarTrack> found = store.findSimilar(1000, 10);
+            quantizedMatches &= store.recordSize() == (size_t)bits * 7 / 8 && found.size() == exact.size();
+            for (size_t i = 0; i < found.size() && i < exact.size(); i++) {
+                quantizedMatches &= std::abs(found[i].similarity - exact[i]) < tolerance && found[i].trackId != 1000;
+            }
+            const HAMMSVector restored = store.at(5);
+            quantizedMatches &= std::abs(restored.tonality - vectors[5].tonality) <= 0.5f / ((1 << bits) - 1) + 1e-6f;
+            
+            const std::string path = (fs::temp_directory_path() / "hamms_index_test.bin").string();
+            store.save(path);
+            QuantizedHAMMSStore opened = QuantizedHAMMSStore::open(path);
+            std::vector<SimilarTrack> reopened = opened.findSimilar(1000, 10);
+            quantizedMatches &= opened.mapped() && opened.size() == store.size() && opened.bits() == bits &&
+                                reopened.size() == found.size();
+            for (size_t i = 0; i < reopened.size() && i < found.size(); i++) {
+                quantizedMatches &= reopened[i].trackId == found[i].trackId &&
+                                    reopened[i].similarity == found[i].similarity;
+            }
+            fs::remove(path);
+        }
+        
+        // A header claiming more records than the file holds is rejected before any read
+        const std::string corruptPath = (fs::temp_directory_path() / "hamms_index_corrupt.bin").string();
+        {
+            unsigned char file[128] = { 'H', 'A', 'M', 'M', 'S', 'Q', 'I', 'X', 1, 0, 0, 0, 1, 0, 0, 0 };
+            const uint64_t count = 0xA2E8BA2E8BA2E8C0ull;   // Column offsets wrap to exactly 128 bytes
+            std::memcpy(file + 16, &count, sizeof(count));
+            std::ofstream corrupt(corruptPath, std::ios::binary);
+            corrupt.write(reinterpret_cast<const char*>(file), sizeof(file));
+        }
+        bool corruptRejected = false;
+        try {
+            QuantizedHAMMSStore::open(corruptPath);
+        } catch (const std::runtime_error&) {
+            corruptRejected = true;
+        }
+        fs::remove(corruptPath);
+        reportTest("Quantized Store - Matches Unquantized Search", quantizedMatches && corruptRejected);
+    }
+    
+    void testLibraryClustering() {
+        std::cout << "🗂️ Testing Library Clustering...\n";
+        
+        std::mt19937 rng(19);
+        
+        // Five well-separated groups of tracks; k-means must find them and the graph must match brute force
+        std::vector<TrackFeatures> tracks;
+        std::normal_distribution<float> jitter(0.0f, 0.03f);
+        const int groupKeys[5] = { 0, 15, 8, 21, 4 };
+        for (int i = 0; i < 3000; i++) {
+            int group = i % 5;
+            TrackFeatures track;
+            track.trackId = 1000 + i;
+            float* values = &track.hamms.harmonicity;
+            for (int d = 0; d < 7; d++) values[d] = 0.1f + 0.2f * ((group + d) % 5) + jitter(rng);
+            track.energy = 0.2f * group + 0.1f + jitter(rng);
+            track.bpm = (i % 2 ? 90.0f : 180.0f) + 4.0f * group;   // Half / double time coincide
+            track.key = groupKeys[group];
+            tracks.push_back(track);
+        }
+        tracks[7].key = KeyDetector::keyIndex("Ebm");
+        LibraryClustering clustering(tracks);
+        
+        TrackClusters clusters = clustering.kMeans(5);
+        bool clusteringMatches = clusters.count == 5 && clusters.assignments.size() == tracks.size() &&
+                                 KeyDetector::keyIndex("D# minor") == 7 && KeyDetector::keyIndex("F#") == 12 &&
+                                 KeyDetector::keyIndex("bb min") == 21 && KeyDetector::keyIndex("H") == -1;
+        for (size_t i = 5; i < tracks.size(); i++) {
+            clusteringMatches &= clusters.assignments[i] == clusters.assignments[i % 5];
+        }
+        for (size_t size : clusters.sizes) clusteringMatches &= size == 600;
+        
+        NeighborGraph graph = clustering.nearestNeighbors(8);
+        clusteringMatches &= graph.k == 8 && graph.neighbors.size() == tracks.size() * 8;
+        float a[LibraryClustering::DIMENSIONS], b[LibraryClustering::DIMENSIONS];
+        for (size_t q = 0; q < tracks.size(); q += 149) {
+            clustering.embed(tracks[q], a);
+            std::vector<float> distances;
+            for (size_t i = 0; i < tracks.size(); i++) {
+                if (i == q) continue;
+                clustering.embed(tracks[i], b);
+                float distance = 0.0f;
+                for (int d = 0; d < LibraryClustering::DIMENSIONS; d++) distance += (a[d] - b[d]) * (a[d] - b[d]);
+                distances.push_back(distance);
+            }
+            std::sort(distances.begin(), distances.end());
+            for (size_t j = 0; j < graph.k; j++) {
+                float similarity = 1.0f - std::sqrt(distances[j] / 12.0f);
+                clusteringMatches &= graph.neighbors[q * 8 + j] != q &&
+                                     std::abs(graph.similarities[q * 8 + j] - similarity) < 1e-4f;
+            }
+        }
+        reportTest("Library Clustering - Recovers Groups", clusteringMatches);
+    }
+    
+    void testHarmonicMixing() {
+        std::cout << "🎛️ Testing Harmonic Mixing...\n";
+        
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        
+        // Against a scan of every track, after replacements and removals
+        HarmonicMixingIndex mixing;
+        struct MixTrack { int key; float bpm; float energy; };
+        std::map<int64_t, MixTrack> mixLibrary;
+        for (int64_t id = 1; id <= 5000; id++) {
+            MixTrack track = { (int)(rng() % 24), 60.0f + 140.0f * unit(rng), id % 9 == 0 ? NAN : unit(rng) };
+            mixing.upsert(id, track.key, track.bpm, track.energy);
+            mixLibrary[id] = track;
+        }
+        for (int64_t id = 1; id <= 5000; id += 11) {
+            mixing.remove(id);
+            mixLibrary.erase(id);
+        }
+        for (int64_t id = 2; id <= 5000; id += 17) {
+            if (!mixLibrary.count(id)) continue;
+            mixLibrary[id].bpm = 60.0f + 140.0f * unit(rng);
+            mixing.upsert(id, mixLibrary[id].key, mixLibrary[id].bpm, mixLibrary[id].energy);
+        }
+        
+        bool mixingMatches = mixing.size() == mixLibrary.size() &&
+                             !mixing.upsert(99999, -1, 120.0f) && !mixing.upsert(99999, 0, NAN) &&
+                             HarmonicMixingIndex::camelotName(HarmonicMixingIndex::camelotCode(KeyDetector::keyIndex("A minor"))) == "8A" &&
+                             HarmonicMixingIndex::camelotName(HarmonicMixingIndex::camelotCode(KeyDetector::keyIndex("C major"))) == "8B" &&
+                             HarmonicMixingIndex::camelotName(HarmonicMixingIndex::camelotCode(KeyDetector::keyIndex("F# major"))) == "2B" &&
+                             HarmonicMixingIndex::camelotName(HarmonicMixingIndex::camelotCode(KeyDetector::keyIndex("Db minor"))) == "12A";
+        MixingFilters mixFilters;
+        for (int64_t seedId = 3; seedId <= 5000; seedId += 251) {
+            if (!mixLibrary.count(seedId)) continue;
+            const MixTrack& seed = mixLibrary[seedId];
+            int seedCode = HarmonicMixingIndex::camelotCode(seed.key);
+            
+            std::set<int64_t> expected;
+            for (const auto& entry : mixLibrary) {
+                int code = HarmonicMixingIndex::camelotCode(entry.second.key);
+                int step = std::abs(code / 2 - seedCode / 2);
+                bool keyFits = (code % 2 == seedCode % 2 && (step <= 1 || step == 11)) || step == 0;
+                bool tempoFits = false;
+                for (float ratio : {1.0f, 0.5f, 2.0f}) {
+                    tempoFits |= std::abs(entry.second.bpm - ratio * seed.bpm) <= 0.06f * ratio * seed.bpm;
+                }
+                bool energyFits = std::isnan(seed.energy) || std::isnan(entry.second.energy) ||
+                                  std::abs(seed.energy - entry.second.energy) <= 0.2f;
+                if (entry.first != seedId && keyFits && tempoFits && energyFits) expected.insert(entry.first);
+            }
+            
+            std::vector<MixingMatch> all = mixing.compatibleTracks(seedId, 100000, mixFilters);
+            std::set<int64_t> found;
+            for (const MixingMatch& match : all) found.insert(match.trackId);
+            mixingMatches &= found == expected && found.size() == all.size();
+            
+            std::vector<MixingMatch> top = mixing.compatibleTracks(seedId, 5, mixFilters);
+            mixingMatches &= top.size() == std::min<size_t>(5, all.size());
+            for (size_t i = 0; i < top.size(); i++) mixingMatches &= top[i].trackId == all[i].trackId;
+        }
+        reportTest("Harmonic Mixing - Matches Exhaustive Scan", mixingMatches);
+    }
+    
     void testKeyDetection() {
         std::cout << "🎹 Testing Key Detection...\n";
         
@@ -233,6 +672,29 @@ public:
         if (keyTest) {
             std::cout << "   Detected key: " << result.AI_KEY << "\n";
         }
+        
+        // 30 s of C major followed by 30 s of F# major
+        const int sampleRate = 22050;
+        std::vector<float> samples(60 * sampleRate);
+        for (size_t i = 0; i < samples.size(); i++) {
+            float t = (float)i / sampleRate;
+            float root = i < samples.size() / 2 ? 261.63f : 369.99f;
+            samples[i] = 0.2f * (std::sin(2.0f * M_PI * root * t) +
+                                 std::sin(2.0f * M_PI * root * 1.2599f * t) +   // Major third
+                                 std::sin(2.0f * M_PI * root * 1.4983f * t));   // Fifth
+        }
+        AudioBuffer modulating(std::move(samples), sampleRate, 1);
+        AIAnalysisResult timeline = analyzer.analyzeAudio(modulating, FIELD_KEY);
+        
+        bool timelineTest = timeline.KEY_TIMELINE.size() == 2 &&
+                            timeline.KEY_TIMELINE[0].key != timeline.KEY_TIMELINE[1].key &&
+                            std::abs(timeline.KEY_TIMELINE[1].startTime - 30.0f) < 5.0f &&
+                            timeline.KEY_TIMELINE[1].key == "F# major";
+        reportTest("Key Detection - Timeline", timelineTest);
+        
+        for (const KeySegment& segment : timeline.KEY_TIMELINE) {
+            std::cout << "   " << segment.startTime << "s-" << segment.endTime << "s: " << segment.key << "\n";
+        }
     }
     
     void testBPMDetection() {
@@ -255,6 +717,27 @@ public:
         reportTest("BPM Detection - 80 BPM", bpm80InRange);
         
         std::cout << "   Detected BPM: " << result.AI_BPM << "\n";
+        
+        // Fractional tempo and a beat on every quarter note, kick or snare
+        AudioBuffer drums128 = TestAudioGenerator::generateDrumPattern(128.0f, 20.0f);
+        AnalysisContext context(drums128);
+        const BeatTrack& grid = context.beatTrack();
+        
+        // The onset at 0 s is already under way in the first envelope frame, so skip it
+        bool evenGrid = grid.beats.beatTimes.size() > 8;
+        for (size_t i = 2; i < grid.beats.beatTimes.size(); i++) {
+            float interval = grid.beats.beatTimes[i] - grid.beats.beatTimes[i - 1];
+            evenGrid &= std::abs(interval * 128.0f / 60.0f - 1.0f) < 0.05f;
+        }
+        bool curveFollows = !grid.tempoCurve.empty();
+        for (float local : grid.tempoCurve) {
+            curveFollows &= std::abs(local - 128.0f) < 3.0f;
+        }
+        reportTest("Beat Tracking - 128 BPM Grid",
+                   std::abs(grid.bpm - 128.0f) < 1.0f && evenGrid && curveFollows);
+        
+        std::cout << "   Tracked BPM: " << grid.bpm << ", " << grid.beats.beatTimes.size() << " beats, "
+                  << grid.tempoCurve.size() << " tempo curve points\n";
     }
     
     void testLoudnessAnalysis() {
@@ -268,6 +751,37 @@ public:
         reportTest("Loudness Analysis - Range Check", loudnessInRange);
         
         std::cout << "   Detected loudness: " << result.AI_LOUDNESS << " LUFS\n";
+        
+        // BS.1770 reference: a full-scale 997 Hz sine reads -3.01 LUFS. 20 s
+        // there then 20 s 10 dB lower gives a 10 LU range (EBU Tech 3342).
+        const int rate = 48000;
+        std::vector<float> steps(40 * rate);
+        for (size_t i = 0; i < steps.size(); i++) {
+            float gain = i < steps.size() / 2 ? 1.0f : std::pow(10.0f, -10.0f / 20.0f);
+            steps[i] = gain * std::sin(2.0f * M_PI * 997.0f * i / rate);
+        }
+        LoudnessMeter reference(rate);
+        for (size_t i = 0; i < steps.size(); i += 1000) {
+            reference.process(steps.data() + i, std::min<size_t>(1000, steps.size() - i));
+        }
+        float fullScale = reference.timeline().shortTerm[100];   // 3.4 s in
+        
+        // A sine at a quarter of the rate sampled 45° off its peaks: samples
+        // stay at -3 dBFS while the waveform reaches 0 dBTP
+        std::vector<float> quarter(rate);
+        for (size_t i = 0; i < quarter.size(); i++) {
+            quarter[i] = std::sin(M_PI / 2.0 * i + M_PI / 4.0);
+        }
+        LoudnessMeter peakMeter(rate, false);
+        peakMeter.process(quarter.data(), quarter.size());
+        
+        reportTest("Loudness Meter - Reference Levels",
+                   std::abs(fullScale + 3.01f) < 0.1f &&
+                   std::abs(reference.loudnessRange() - 10.0f) < 1.0f &&
+                   std::abs(peakMeter.truePeak()) < 0.3f);
+        
+        std::cout << "   Full scale: " << fullScale << " LUFS, range: " << reference.loudnessRange()
+                  << " LU, true peak: " << peakMeter.truePeak() << " dBTP\n";
     }
     
     void testAcousticnessAnalysis() {
@@ -407,6 +921,21 @@ public:
                                  result.AI_CHARACTERISTICS.size() <= 5;
         reportTest("Characteristics Extraction", hasCharacteristics);
         
+        // A pure tone: its power rolls off at the tone and is concentrated, not spread.
+        // Frames are unwindowed, so leakage keeps the magnitude centroid above the tone.
+        AudioBuffer tone = TestAudioGenerator::generateSineWave(1000.0f, 2.0f);
+        AnalysisContext context(tone);
+        const SpectralDescriptors& descriptors = context.descriptors();
+        bool toneDescriptors = descriptors.size() > 0 &&
+                               std::abs(descriptors.rolloffSummary.mean - 1000.0f) < 100.0f &&
+                               descriptors.centroidSummary.mean > 1000.0f &&
+                               descriptors.flatnessSummary.mean < 0.5f &&
+                               descriptors.entropySummary.mean < 0.5f;
+        reportTest("Spectral Descriptors - Pure Tone", toneDescriptors);
+        
+        std::cout << "   Rolloff: " << descriptors.rolloffSummary.mean << " Hz, centroid: "
+                  << descriptors.centroidSummary.mean << " Hz, entropy: " << descriptors.entropySummary.mean << "\n";
+        
         std::cout << "   Characteristics: ";
         for (const auto& char_str : result.AI_CHARACTERISTICS) {
             std::cout << char_str << " ";
@@ -511,6 +1040,63 @@ public:
         std::cout << "   All 19 AI_* fields populated: " << (allFieldsValid ? "Yes" : "No") << "\n";
     }
     
+    void testSelectiveAnalysis() {
+        std::cout << "\n🎛️ Testing Selective Analysis...\n";
+        
+        AudioBuffer audio = TestAudioGenerator::generateDrumPattern(120.0f, 4.0f);
+        AIAnalysisResult full = analyzer.analyzeAudio(audio);
+        
+        // Mood reads energy and valence; nothing else should run
+        FieldMask requested = FieldSelection::parse({"AI_BPM", "AI_MOOD"});
+        AIAnalysisResult partial = analyzer.analyzeAudio(audio, requested);
+        
+        FieldMask expected = FIELD_BPM | FIELD_MOOD | FIELD_ENERGY | FIELD_VALENCE;
+        bool maskResolved = partial.analyzedFields == expected;
+        bool valuesMatch = partial.AI_BPM == full.AI_BPM && partial.AI_MOOD == full.AI_MOOD;
+        bool skippedOthers = partial.AI_KEY.empty() && partial.AI_SUBGENRES.empty();
+        
+        reportTest("Selective Analysis - Dependencies", maskResolved);
+        reportTest("Selective Analysis - Same Values", valuesMatch && skippedOthers);
+    }
+    
+    void testStreamingAnalysis() {
+        std::cout << "\n🌊 Testing Streaming Analysis...\n";
+        
+        AudioBuffer audio = TestAudioGenerator::generateDrumPattern(128.0f, 8.0f);
+        FieldMask fields = FIELD_BPM | FIELD_LOUDNESS | FIELD_KEY | FIELD_ENERGY;
+        AIAnalysisResult offline = analyzer.analyzeAudio(audio, fields);
+        
+        auto stream = [&](float excerptSeconds) {
+            StreamingOptions options;
+            options.fields = fields;
+            options.excerptSeconds = excerptSeconds;
+            options.verbose = false;
+            
+            StreamingAnalyzer streaming(audio.sampleRate, options);
+            for (size_t i = 0; i < audio.samples.size(); i += 3000) {
+                streaming.push(audio.samples.data() + i, std::min<size_t>(3000, audio.samples.size() - i));
+            }
+            return streaming.finish();
+        };
+        
+        // Fits in the excerpt: same as offline
+        AIAnalysisResult whole = stream(10.0f);
+        bool identical = whole.AI_BPM == offline.AI_BPM && whole.AI_LOUDNESS == offline.AI_LOUDNESS &&
+                         whole.AI_KEY == offline.AI_KEY && whole.AI_ENERGY == offline.AI_ENERGY;
+        
+        // Longer than the excerpt: BPM and loudness still cover the whole track
+        AIAnalysisResult bounded = stream(2.0f);
+        bool wholeTrack = bounded.AI_BPM == offline.AI_BPM &&
+                          std::abs(bounded.AI_LOUDNESS - offline.AI_LOUDNESS) < 0.05f &&
+                          bounded.analyzedFields == offline.analyzedFields;
+        
+        reportTest("Streaming - Matches Offline", identical);
+        reportTest("Streaming - Bounded Excerpt", wholeTrack);
+        
+        std::cout << "   BPM: " << offline.AI_BPM << " / " << bounded.AI_BPM << "\n";
+        std::cout << "   Loudness: " << offline.AI_LOUDNESS << " / " << bounded.AI_LOUDNESS << "\n";
+    }
+    
     void runPerformanceBenchmarks() {
         std::cout << "\n⚡ Performance Benchmarks...\n";
         